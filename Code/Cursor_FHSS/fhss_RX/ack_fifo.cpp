@@ -0,0 +1,79 @@
+#include "ack_fifo.h"
+
+static RadioDriver* s_radio = nullptr;
+static bool     s_loaded = false;      // одна полезная нагрузка в TX FIFO
+static uint32_t s_loadUs = 0;
+static uint32_t s_dataUs = 0;
+static bool     s_rxSinceLoad = false; // был пакет — мог забрать нагрузку
+static uint32_t s_rxUs = 0;
+static AckFifoStats s_stats;
+static uint64_t s_ageSumUs = 0;
+
+void ackFifoInit(RadioDriver& radio) {
+  s_radio = &radio;
+  memset(&s_stats, 0, sizeof(s_stats));
+  s_ageSumUs = 0;
+  ackFifoFlush();
+}
+
+void ackFifoFlush() {
+  s_radio->flush_tx();
+  s_loaded = false;
+  s_rxSinceLoad = false;
+}
+
+void ackFifoOnPacket(uint32_t nowUs) {
+  if (s_loaded && !s_rxSinceLoad) {
+    s_rxSinceLoad = true;
+    s_rxUs = nowUs;     // first packet after the load carried it out
+  }
+}
+
+static void recordDelivery() {
+  uint32_t age = s_rxUs - s_dataUs;
+  s_stats.delivered++;
+  s_ageSumUs += age;
+  s_stats.ageMeanUs = (uint32_t)(s_ageSumUs / s_stats.delivered);
+  if (age > s_stats.ageMaxUs) s_stats.ageMaxUs = age;
+}
+
+bool ackFifoWantsPayload(uint32_t nowUs) {
+  if (!s_loaded) return true;
+  if (s_rxSinceLoad) {
+    // TX FIFO empty = the payload went out with that packet's ACK
+    if (s_radio->isFifo(true, true)) {
+      recordDelivery();
+      s_loaded = false;
+      return true;
+    }
+    s_rxSinceLoad = false;   // ACK was sent without it (loaded too late)
+  }
+  if (nowUs - s_loadUs >= ACK_STALE_US) {
+    s_radio->flush_tx();
+    s_loaded = false;
+    s_stats.flushed++;
+    return true;
+  }
+  return false;
+}
+
+void ackFifoLoad(const void* buf, uint8_t len, uint32_t dataUs, uint32_t nowUs) {
+  if (!s_radio->writeAckPayload(1, buf, len)) return;
+  s_loaded = true;
+  s_rxSinceLoad = false;
+  s_loadUs = nowUs;
+  s_dataUs = dataUs;
+  s_stats.loads++;
+}
+
+AckFifoStats ackFifoStats() {
+  return s_stats;
+}
+
+void ackFifoDump(Print& out) {
+  out.print("ACK: loads="); out.print(s_stats.loads);
+  out.print(" delivered="); out.print(s_stats.delivered);
+  out.print(" flushed="); out.print(s_stats.flushed);
+  out.print(" age_mean_us="); out.print(s_stats.ageMeanUs);
+  out.print(" age_max_us="); out.println(s_stats.ageMaxUs);
+}
@@ -0,0 +1,46 @@
+#ifndef ACK_FIFO_H
+#define ACK_FIFO_H
+
+#include <Arduino.h>
+#include "nrf_dma.h"     // RadioDriver
+
+// ====== ACK payload manager ======
+// The nRF24 sends one ACK payload per received packet from its 3-entry TX
+// FIFO. Writing a payload on every loop() pass (much faster than the 2 ms
+// packet rate) kept that FIFO full of old telemetry, so the TX always got
+// data several loops stale. Here exactly one payload is kept loaded; the
+// next one is written only after the hardware reports the slot delivered,
+// or replaced (flush_tx) when it has waited longer than ACK_STALE_US.
+// FIFO_STATUS is read only after a packet was received, so an idle link
+// costs no SPI traffic at all.
+
+#ifndef ACK_STALE_US
+#define ACK_STALE_US 10000   // 5 слотов TX без доставки — заменить на свежий
+#endif
+
+struct AckFifoStats {
+  uint32_t loads;        // writeAckPayload() calls
+  uint32_t delivered;    // payloads that went out with an ACK
+  uint32_t flushed;      // replaced as stale (no packet in ACK_STALE_US)
+  uint32_t ageMaxUs;     // data age at delivery (sample time -> packet)
+  uint32_t ageMeanUs;
+};
+
+void ackFifoInit(RadioDriver& radio);
+
+// A packet on pipe 1 was read: its ACK took the loaded payload, if any
+void ackFifoOnPacket(uint32_t nowUs);
+
+// True if a fresh payload should be built and loaded now
+bool ackFifoWantsPayload(uint32_t nowUs);
+
+// dataUs = when the data inside was sampled (age is measured from it)
+void ackFifoLoad(const void* buf, uint8_t len, uint32_t dataUs, uint32_t nowUs);
+
+// Drop whatever is loaded (sync state change)
+void ackFifoFlush();
+
+AckFifoStats ackFifoStats();
+void ackFifoDump(Print& out);   // one "ACK:" line, printed by the 'd' command
+
+#endif // ACK_FIFO_H
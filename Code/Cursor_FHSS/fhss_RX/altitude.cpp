@@ -0,0 +1,79 @@
+#include <Arduino.h>
+#include <math.h>
+#include "altitude.h"
+
+static const float GRAVITY = 9.80665f;
+static const float DEG2RAD = 0.0174532925f;
+static const float ACC_BIAS_LIMIT = 2.0f;   // m/s^2
+
+static float s_h = 0.0f;
+static float s_v = 0.0f;
+static float s_bias = 0.0f;
+static float s_p0 = 0.0f;          // hPa, опорное давление (0 = ещё нет)
+static float s_lastP = 0.0f;
+static float s_baroH = 0.0f;
+static float s_baroOffset = 0.0f;  // baro - ToF, м
+static bool  s_zeroPending = true;
+
+void altitudeInit() {
+  s_h = s_v = s_bias = 0.0f;
+  s_p0 = s_lastP = s_baroH = s_baroOffset = 0.0f;
+  s_zeroPending = true;
+}
+
+void altitudeReset() {
+  s_zeroPending = true;
+}
+
+// powf() on the no-FPU C6 is slow: recompute only when the BMP280 reports a new value
+static void updateBaro(float p) {
+  if (p == s_lastP) return;
+  s_lastP = p;
+  s_baroH = 44330.0f * (1.0f - powf(p / s_p0, 0.190295f));
+}
+
+void altitudeUpdate(const TelemetryData& sens, const Attitude& att, float dt, VerticalState* out) {
+  const bool baroOk = sens.pressure > 0.0f;
+  if (s_zeroPending && baroOk) {
+    s_p0 = s_lastP = sens.pressure;
+    s_baroH = s_baroOffset = 0.0f;
+    s_h = s_v = 0.0f;
+    s_zeroPending = false;
+  }
+  if (baroOk && s_p0 > 0.0f) updateBaro(sens.pressure);
+
+  // Projection onto gravity, same angle convention as attitudeUpdate()
+  float sr = sinf(att.roll * DEG2RAD),  cr = cosf(att.roll * DEG2RAD);
+  float sp = sinf(att.pitch * DEG2RAD), cp = cosf(att.pitch * DEG2RAD);
+  float accUp = -sens.accel_x * sp + sens.accel_y * sr * cp + sens.accel_z * cr * cp - GRAVITY;
+
+  // Reference height
+  bool tofOk = sens.range_mm >= 0 && sens.range_mm <= ALT_TOF_MAX_MM
+            && fabsf(att.roll) < ALT_TOF_MAX_TILT && fabsf(att.pitch) < ALT_TOF_MAX_TILT;
+  float ref, tc;
+  if (tofOk) {
+    ref = sens.range_mm * 0.001f * cr * cp;
+    tc = ALT_TOF_TC;
+    s_baroOffset += ((s_baroH - ref) - s_baroOffset) * min(dt / ALT_BARO_OFFSET_TC, 1.0f);
+  } else if (baroOk && !s_zeroPending) {
+    ref = s_baroH - s_baroOffset;
+    tc = ALT_BARO_TC;
+  } else {
+    ref = s_h;   // нет опоры: чистая инерциальная навигация
+    tc = ALT_BARO_TC;
+  }
+
+  // k1 = 3w, k2 = 3w^2, k3 = w^3: triple pole at -1/tc
+  float w = 1.0f / tc;
+  float e = ref - s_h;
+  s_bias = constrain(s_bias - w * w * w * e * dt, -ACC_BIAS_LIMIT, ACC_BIAS_LIMIT);
+  s_v += (accUp - s_bias + 3.0f * w * w * e) * dt;
+  s_h += (s_v + 3.0f * w * e) * dt;
+
+  out->height = s_h;
+  out->climb = s_v;
+  out->accBias = s_bias;
+  out->baroHeight = s_baroH - s_baroOffset;
+  out->tiltCos = cr * cp;
+  out->tofActive = tofOk;
+}
@@ -0,0 +1,44 @@
+#ifndef ALTITUDE_H
+#define ALTITUDE_H
+
+#include <Arduino.h>
+#include "telemetry.h"
+#include "attitude.h"
+
+// ====== Vertical state estimator ======
+// Third-order complementary filter: IMU vertical acceleration is integrated
+// every loop (low latency), height error against a slow reference pulls
+// height, climb rate and accelerometer bias. Reference = VL53L0X range
+// (tilt-corrected) when it is valid, barometric altitude otherwise. While
+// the ToF is valid the baro offset is learned, so switching is seamless.
+
+#ifndef ALT_TOF_TC
+#define ALT_TOF_TC 0.3f         // с, постоянная времени коррекции по ToF
+#endif
+#ifndef ALT_BARO_TC
+#define ALT_BARO_TC 1.5f        // с, по барометру (шумнее, 25 Гц)
+#endif
+#ifndef ALT_BARO_OFFSET_TC
+#define ALT_BARO_OFFSET_TC 2.0f // с, подстройка baro - ToF
+#endif
+#ifndef ALT_TOF_MAX_MM
+#define ALT_TOF_MAX_MM 1200     // дальше VL53L0X на солнце ненадёжен
+#endif
+#ifndef ALT_TOF_MAX_TILT
+#define ALT_TOF_MAX_TILT 30.0f  // deg
+#endif
+
+struct VerticalState {
+  float height;     // m above the takeoff point
+  float climb;      // m/s, + up
+  float accBias;    // m/s^2, estimated accelerometer bias along vertical
+  float baroHeight; // m, raw baro reference (debug)
+  float tiltCos;    // cos(roll)*cos(pitch), for thrust tilt compensation
+  bool  tofActive;  // last correction came from the ToF
+};
+
+void altitudeInit();
+void altitudeReset();   // zero height at the current position (on arm)
+void altitudeUpdate(const TelemetryData& sens, const Attitude& att, float dt, VerticalState* out);
+
+#endif // ALTITUDE_H
@@ -3,17 +3,75 @@
 
 #include <Arduino.h>
 #include "telemetry.h"
+#include "ctrl_scalar.h"
 
-struct Attitude {
-  float roll;   // deg
-  float pitch;  // deg
-  float yaw;    // deg
-  float gx;     // deg/s
-  float gy;     // deg/s
-  float gz;     // deg/s
+template <typename T>
+struct AttitudeT {
+  T roll;   // deg
+  T pitch;  // deg
+  T yaw;    // deg
+  T gx;     // deg/s
+  T gy;     // deg/s
+  T gz;     // deg/s
 };
 
+typedef AttitudeT<float>  Attitude;      // debug / blackbox / altitude
+typedef AttitudeT<ctrl_t> CtrlAttitude;  // control loop
+
+// ====== Complementary filter core (scalar-generic) ======
+
+template <typename T>
+struct AttitudeFilter {
+  T alpha;
+  bool first;
+  T roll, pitch, yaw;
+};
+
+template <typename T>
+inline void attitudeFilterInit(AttitudeFilter<T>& f, float alpha) {
+  f.alpha = T(constrain(alpha, 0.0f, 1.0f));
+  f.first = true;
+  f.roll = f.pitch = f.yaw = T(0);
+}
+
+// accel in m/s^2, gyro in rad/s (Adafruit_MPU6050 units), dt in s
+template <typename T>
+inline void attitudeFilterStep(AttitudeFilter<T>& f, T ax, T ay, T az,
+                               T gx_rad, T gy_rad, T gz_rad, T dt, AttitudeT<T>* out) {
+  // фильтр и PID работают в deg/s
+  const T RAD2DEG = T(57.2957795f);
+  T gx = gx_rad * RAD2DEG;
+  T gy = gy_rad * RAD2DEG;
+  T gz = gz_rad * RAD2DEG;
+
+  T roll_acc  = ctrlAtan2Deg(ay, az);
+  T pitch_acc = ctrlAtan2Deg(-ax, ctrlSqrt(ay*ay + az*az));
+
+  if (f.first) {
+    f.roll = roll_acc;
+    f.pitch = pitch_acc;
+    f.yaw = T(0);
+    f.first = false;
+  } else {
+    T beta = T(1) - f.alpha;
+    f.roll  = f.alpha * (f.roll  + gx * dt) + beta * roll_acc;
+    f.pitch = f.alpha * (f.pitch + gy * dt) + beta * pitch_acc;
+    f.yaw   = f.yaw + gz * dt;
+    // ±180: Q15.16 переполнился бы через ~90 оборотов
+    if (f.yaw > T(180)) f.yaw -= T(360);
+    else if (f.yaw < T(-180)) f.yaw += T(360);
+  }
+
+  out->roll  = f.roll;
+  out->pitch = f.pitch;
+  out->yaw   = f.yaw;
+  out->gx = gx; out->gy = gy; out->gz = gz;
+}
+
+// ====== RX instance (ctrl_t) ======
+
 void attitudeInit(float alpha = 0.98f);
-void attitudeUpdate(const TelemetryData& sens, float dt, Attitude* out);
+void attitudeUpdate(const TelemetryData& sens, ctrl_t dt, CtrlAttitude* out);
+Attitude attitudeToFloat(const CtrlAttitude& a);
 
 #endif // ATTITUDE_H
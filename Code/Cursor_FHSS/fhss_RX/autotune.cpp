@@ -0,0 +1,240 @@
+#include "autotune.h"
+#include "stabilizer.h"
+
+static const char* const AXIS_NAMES[AT_AXIS_COUNT] = { "roll", "pitch", "yaw" };
+static const char* const STATE_NAMES[] = { "idle", "waiting", "settle", "relay", "done", "aborted" };
+static const float U0_TAU_S = 0.3f;      // сглаживание выхода PID перед реле
+static const float MIN_DELAY_S = 0.002f; // не меньше периода цикла
+
+static AutotuneState s_state = AT_IDLE;
+static uint8_t s_axis = AT_ROLL;
+static float s_t = 0.0f;                 // время в текущей фазе, с
+static const char* s_abortReason = "";
+static AutotuneAxisResult s_results[AT_AXIS_COUNT];
+
+// Relay / limit cycle measurement for the current axis
+static float s_u0 = 0.0f;
+static bool  s_high = false;
+static bool  s_haveCycleStart = false;
+static float s_cycleStart = 0.0f;
+static float s_yMax = 0.0f, s_yMin = 0.0f;
+static uint8_t s_cycles = 0;             // completed cycles, including skipped
+static float s_sumPeriod = 0.0f, s_sumAmp = 0.0f;
+static float s_minPeriod = 0.0f, s_maxPeriod = 0.0f;
+
+static float relayAmplitude(uint8_t axis) {
+  return axis == AT_YAW ? AUTOTUNE_RELAY_YAW : AUTOTUNE_RELAY_RP;
+}
+
+void autotuneInit() {
+  s_state = AT_IDLE;
+  s_axis = AT_ROLL;
+  s_t = 0.0f;
+  s_abortReason = "";
+  memset(s_results, 0, sizeof(s_results));
+}
+
+void autotuneRequest() {
+  autotuneInit();
+  s_state = AT_WAITING;
+}
+
+static void abortRun(const char* reason) {
+  s_state = AT_ABORTED;
+  s_abortReason = reason;
+}
+
+void autotuneCancel() {
+  if (s_state == AT_WAITING || s_state == AT_SETTLE || s_state == AT_RELAY) abortRun("cancelled");
+}
+
+void autotuneMotorsOff() {
+  if (s_state == AT_SETTLE || s_state == AT_RELAY) abortRun("motors stopped");
+}
+
+AutotuneState autotuneState() { return s_state; }
+uint8_t autotuneAxis() { return s_axis; }
+const AutotuneAxisResult& autotuneResult(uint8_t axis) { return s_results[axis]; }
+
+static void startSettle(uint8_t axis, float u) {
+  s_state = AT_SETTLE;
+  s_axis = axis;
+  s_t = 0.0f;
+  s_u0 = u;
+  AutotuneGains& g = s_results[axis].current;
+  stabilizerGetGains(axis, &g.kp, &g.ki, &g.kd);
+}
+
+static void startRelay(float y) {
+  s_state = AT_RELAY;
+  s_t = 0.0f;
+  s_high = (y < 0.0f);   // толкаем скорость к нулю с первого шага
+  s_haveCycleStart = false;
+  s_yMax = s_yMin = y;
+  s_cycles = 0;
+  s_sumPeriod = s_sumAmp = 0.0f;
+  s_minPeriod = 1e9f;
+  s_maxPeriod = 0.0f;
+}
+
+// rate' = b*u(t - delay) под реле: пила с наклоном b*d, пик a = h + b*d*delay,
+// полупериод 2a/(b*d)
+static bool identifyAndPlace(uint8_t axis) {
+  const float n = (float)AUTOTUNE_CYCLES;
+  const float Tu = s_sumPeriod / n;
+  const float a = s_sumAmp / n;
+  const float d = relayAmplitude(axis);
+  const float h = AUTOTUNE_HYST_DPS;
+
+  if ((s_maxPeriod - s_minPeriod) > 0.3f * Tu) return false;   // нет устойчивого цикла
+  if (a <= h) return false;
+
+  AutotuneAxisResult& r = s_results[axis];
+  r.period = Tu;
+  r.amplitude = a;
+  r.gain = 4.0f * a / (d * Tu);
+  r.delay = max(Tu * (a - h) / (4.0f * a), MIN_DELAY_S);
+
+  const float wc = AUTOTUNE_BW / r.delay;
+  r.proposed = r.current;
+  if (axis == AT_YAW) {
+    // P on rate: loop gain kp*b/s crosses over at wc
+    r.proposed.kp = wc / r.gain;
+  } else {
+    // P on angle + D on gyro: inner rate loop at wc, outer damped by ZETA
+    r.proposed.kd = wc / r.gain;
+    r.proposed.kp = wc * wc / (4.0f * AUTOTUNE_ZETA * AUTOTUNE_ZETA * r.gain);
+  }
+  r.valid = true;
+  return true;
+}
+
+static void relayStep(float y, float dt, float* u) {
+  const float h = AUTOTUNE_HYST_DPS;
+  s_yMax = max(s_yMax, y);
+  s_yMin = min(s_yMin, y);
+
+  if (s_high && y > h) {
+    s_high = false;
+  } else if (!s_high && y < -h) {
+    // Переключение вверх = граница цикла
+    s_high = true;
+    if (s_haveCycleStart) {
+      float period = s_t - s_cycleStart;
+      s_cycles++;
+      if (s_cycles > AUTOTUNE_SKIP_CYCLES) {
+        s_sumPeriod += period;
+        s_sumAmp += 0.5f * (s_yMax - s_yMin);
+        s_minPeriod = min(s_minPeriod, period);
+        s_maxPeriod = max(s_maxPeriod, period);
+      }
+    }
+    s_haveCycleStart = true;
+    s_cycleStart = s_t;
+    s_yMax = s_yMin = y;
+  }
+
+  const float d = relayAmplitude(s_axis);
+  *u = s_u0 + (s_high ? d : -d);
+  s_t += dt;
+}
+
+void autotuneUpdate(bool engaged, const float angle[AT_AXIS_COUNT],
+                    const float rate[AT_AXIS_COUNT], float dt, float u[AT_AXIS_COUNT]) {
+  if (s_state == AT_IDLE || s_state == AT_DONE || s_state == AT_ABORTED) return;
+
+  if (s_state == AT_WAITING) {
+    if (engaged) startSettle(AT_ROLL, u[AT_ROLL]);
+    return;
+  }
+
+  // До первого реле просто ждём дальше; потом любое движение стиков — отмена,
+  // ось сразу отдаём PID
+  if (!engaged) {
+    if (s_state == AT_SETTLE && s_axis == AT_ROLL) s_state = AT_WAITING;
+    else abortRun("sticks moved or throttle low");
+    return;
+  }
+  if (fabsf(angle[AT_ROLL]) > AUTOTUNE_MAX_ANGLE || fabsf(angle[AT_PITCH]) > AUTOTUNE_MAX_ANGLE) {
+    abortRun("angle limit");
+    return;
+  }
+
+  if (s_state == AT_SETTLE) {
+    s_u0 += (u[s_axis] - s_u0) * min(dt / U0_TAU_S, 1.0f);
+    s_t += dt;
+    if (s_t >= AUTOTUNE_SETTLE_S) startRelay(rate[s_axis]);
+    return;
+  }
+
+  // AT_RELAY
+  if (s_t > AUTOTUNE_AXIS_TIMEOUT_S) { abortRun("no limit cycle (timeout)"); return; }
+  relayStep(rate[s_axis], dt, &u[s_axis]);
+  if (s_cycles < AUTOTUNE_SKIP_CYCLES + AUTOTUNE_CYCLES) return;
+
+  if (!identifyAndPlace(s_axis)) { abortRun("irregular limit cycle"); return; }
+  if (s_axis + 1 < AT_AXIS_COUNT) startSettle(s_axis + 1, u[s_axis + 1]);
+  else s_state = AT_DONE;
+}
+
+bool autotuneApply() {
+  bool any = false;
+  for (uint8_t k = 0; k < AT_AXIS_COUNT; ++k) {
+    const AutotuneAxisResult& r = s_results[k];
+    if (!r.valid) continue;
+    stabilizerSetGains(k, r.proposed.kp, r.proposed.ki, r.proposed.kd);
+    any = true;
+  }
+  return any;
+}
+
+static void printGain(Print& out, const char* name, float from, float to) {
+  out.print(' '); out.print(name); out.print(' ');
+  out.print(from, 3); out.print("->"); out.print(to, 3);
+}
+
+void autotuneReport(Print& out) {
+  out.print("AT: state="); out.print(STATE_NAMES[s_state]);
+  if (s_state == AT_SETTLE || s_state == AT_RELAY) { out.print(" axis="); out.print(AXIS_NAMES[s_axis]); }
+  if (s_state == AT_ABORTED) { out.print(" reason="); out.print(s_abortReason); }
+  out.println();
+
+  bool any = false;
+  for (uint8_t k = 0; k < AT_AXIS_COUNT; ++k) {
+    const AutotuneAxisResult& r = s_results[k];
+    if (!r.valid) continue;
+    any = true;
+    out.print("AT: "); out.print(AXIS_NAMES[k]);
+    out.print(" Tu="); out.print(r.period, 3);
+    out.print("s a="); out.print(r.amplitude, 1);
+    out.print("dps b="); out.print(r.gain, 1);
+    out.print(" delay="); out.print(r.delay, 4); out.print('s');
+    printGain(out, "kp", r.current.kp, r.proposed.kp);
+    printGain(out, "ki", r.current.ki, r.proposed.ki);
+    printGain(out, "kd", r.current.kd, r.proposed.kd);
+    out.println();
+  }
+  if (any) out.println("AT: proposed only; send 'g' while disarmed to apply (RAM, until reboot)");
+}
+
+bool autotuneCommand(char c, Print& out) {
+  switch (c) {
+    case 't':
+      autotuneRequest();
+      out.println("AT: armed for next centred-stick hover");
+      return true;
+    case 'c':
+      autotuneCancel();
+      autotuneReport(out);
+      return true;
+    case 's':
+      autotuneReport(out);
+      return true;
+    case 'g':
+      if (stabilizerDebug().armed) out.println("AT: disarm first");
+      else out.println(autotuneApply() ? "AT: gains applied" : "AT: nothing to apply");
+      return true;
+    default:
+      return false;
+  }
+}
@@ -0,0 +1,108 @@
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+#include <Arduino.h>
+
+// ====== Relay autotune for roll, pitch and yaw rate ======
+// In a stable angle-mode hover (sticks centred) each axis in turn gets its
+// PID output replaced by a relay on the body rate: u = u0 +/- d, switching
+// when the rate crosses +/-h. The rate settles into a limit cycle whose
+// period Tu and amplitude a identify the plant
+//
+//     rate' = b * u(t - delay)       b = 4a / (d*Tu),  delay = Tu*(a-h) / (4a)
+//
+// (delay lumps motor lag and loop latency). Gains are placed from that
+// model: rate-loop crossover wc = AUTOTUNE_BW / delay, angle loop damped
+// with AUTOTUNE_ZETA. Results are only proposed; they are applied by an
+// explicit command while disarmed and live in RAM until reboot.
+//
+// Moving any stick, exceeding AUTOTUNE_MAX_ANGLE, cutting throttle or
+// disarming aborts the run and hands the axis straight back to the PID.
+
+#ifndef AUTOTUNE_RELAY_RP
+#define AUTOTUNE_RELAY_RP 30.0f     // d для крена/тангажа, в единицах выхода PID
+#endif
+#ifndef AUTOTUNE_RELAY_YAW
+#define AUTOTUNE_RELAY_YAW 60.0f
+#endif
+#ifndef AUTOTUNE_HYST_DPS
+#define AUTOTUNE_HYST_DPS 10.0f     // гистерезис реле > шум + вибрация гироскопа
+#endif
+#ifndef AUTOTUNE_SETTLE_S
+#define AUTOTUNE_SETTLE_S 1.0f      // обычный полёт перед каждой осью
+#endif
+#ifndef AUTOTUNE_SKIP_CYCLES
+#define AUTOTUNE_SKIP_CYCLES 2      // переходные циклы реле, не измеряются
+#endif
+#ifndef AUTOTUNE_CYCLES
+#define AUTOTUNE_CYCLES 6           // измеряемые циклы на ось
+#endif
+#ifndef AUTOTUNE_AXIS_TIMEOUT_S
+#define AUTOTUNE_AXIS_TIMEOUT_S 4.0f
+#endif
+#ifndef AUTOTUNE_MIN_THROTTLE
+#define AUTOTUNE_MIN_THROTTLE 100   // PWM газа, ниже — считаем, что не висим
+#endif
+#ifndef AUTOTUNE_MAX_ANGLE
+#define AUTOTUNE_MAX_ANGLE 25.0f    // deg
+#endif
+#ifndef AUTOTUNE_BW
+#define AUTOTUNE_BW 0.4f            // wc * delay; 0.4 rad => ~67 deg phase margin
+#endif
+#ifndef AUTOTUNE_ZETA
+#define AUTOTUNE_ZETA 0.8f
+#endif
+
+enum AutotuneAxis : uint8_t {
+  AT_ROLL = 0,
+  AT_PITCH,
+  AT_YAW,
+  AT_AXIS_COUNT
+};
+
+enum AutotuneState : uint8_t {
+  AT_IDLE = 0,   // nothing requested
+  AT_WAITING,    // requested, waiting for a centred-stick hover
+  AT_SETTLE,     // normal PID flight before the next axis
+  AT_RELAY,      // relay excitation on the current axis
+  AT_DONE,       // proposal ready
+  AT_ABORTED
+};
+
+struct AutotuneGains {
+  float kp, ki, kd;
+};
+
+struct AutotuneAxisResult {
+  bool valid;
+  float period;      // s, Tu
+  float amplitude;   // deg/s, a
+  float gain;        // b, (deg/s^2) per PID output unit
+  float delay;       // s
+  AutotuneGains current;
+  AutotuneGains proposed;
+};
+
+void autotuneInit();
+void autotuneRequest();               // start at the next steady hover
+void autotuneCancel();
+void autotuneMotorsOff();             // disarm / throttle cut: abort a run, keep a pending request
+AutotuneState autotuneState();
+uint8_t autotuneAxis();               // axis under excitation (AT_RELAY/AT_SETTLE)
+const AutotuneAxisResult& autotuneResult(uint8_t axis);
+bool autotuneApply();                 // write valid proposals into the stabilizer
+
+// Called by stabilizeMix() every loop while motors run. engaged = sticks
+// centred and throttle >= AUTOTUNE_MIN_THROTTLE. angle/rate are in the controller sign convention
+// (deg, deg/s; angle[AT_YAW] is ignored). u[] holds the PID outputs and is
+// overridden in place for the axis under excitation.
+void autotuneUpdate(bool engaged, const float angle[AT_AXIS_COUNT],
+                    const float rate[AT_AXIS_COUNT], float dt, float u[AT_AXIS_COUNT]);
+
+void autotuneReport(Print& out);
+
+// Serial command: 't' = request, 'c' = cancel, 's' = report,
+// 'g' = apply proposal (refused while armed). Returns true if handled.
+bool autotuneCommand(char c, Print& out);
+
+#endif // AUTOTUNE_H
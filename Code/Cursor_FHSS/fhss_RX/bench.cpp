@@ -0,0 +1,151 @@
+#include "bench.h"
+#include "link_format.h"
+#include "attitude.h"
+#include "mixer.h"
+#include "pid.h"
+
+#define BENCH_INPUTS 16   // степень двойки: вход = i & (BENCH_INPUTS - 1)
+
+volatile uint32_t benchSink = 0;
+
+struct JoyText {
+  char text[24];
+  uint8_t len;
+};
+
+static JoyText s_joy[BENCH_INPUTS];
+static TelemetryData s_sens[BENCH_INPUTS];
+static VerticalState s_vert[BENCH_INPUTS];
+static ctrl_t s_cmd[BENCH_INPUTS][4];   // setpoint/measurement/rate for PID, throttle/roll/pitch/yaw for the mixer
+static PIDT<ctrl_t> s_pid;
+static const ctrl_t BENCH_DT = ctrl_t(0.002f);
+static uint32_t s_samples[BENCH_SAMPLES];
+
+// Fixed LCG: the same inputs on every run and every target
+static uint32_t s_seed;
+static int32_t rnd(int32_t lo, int32_t hi) {
+  s_seed = s_seed * 1664525u + 1013904223u;
+  return lo + (int32_t)((s_seed >> 8) % (uint32_t)(hi - lo + 1));
+}
+
+void benchInit() {
+  s_seed = 12345;
+  for (uint8_t k = 0; k < BENCH_INPUTS; k++) {
+    int len = snprintf(s_joy[k].text, sizeof(s_joy[k].text), "J:%d:%d:%d:%d", (int)rnd(-1000, 1000),
+                       (int)rnd(-1000, 1000), (int)rnd(-1000, 1000), (int)rnd(-1000, 1000));
+    s_joy[k].len = (uint8_t)len;
+
+    // Hover-ish IMU: about 1 g on Z, a few deg/s, sea-level baro
+    TelemetryData& d = s_sens[k];
+    d.accel_x = rnd(-300, 300) / 100.0f;
+    d.accel_y = rnd(-300, 300) / 100.0f;
+    d.accel_z = 9.81f + rnd(-100, 100) / 100.0f;
+    d.gyro_x = rnd(-2000, 2000) / 100.0f;
+    d.gyro_y = rnd(-2000, 2000) / 100.0f;
+    d.gyro_z = rnd(-2000, 2000) / 100.0f;
+    d.pressure = 1013.25f + rnd(-500, 500) / 100.0f;
+    d.range_mm = (int16_t)rnd(-1, 2000);
+
+    VerticalState& v = s_vert[k];
+    memset(&v, 0, sizeof(v));
+    v.height = rnd(0, 5000) / 100.0f;
+    v.climb = rnd(-300, 300) / 100.0f;
+
+    s_cmd[k][0] = ctrl_t((float)rnd(0, 255));
+    s_cmd[k][1] = ctrl_t((float)rnd(-200, 200));
+    s_cmd[k][2] = ctrl_t((float)rnd(-200, 200));
+    s_cmd[k][3] = ctrl_t((float)rnd(-100, 100));
+  }
+  // Roll gains of stabilizer.cpp
+  pidInit(s_pid, 3.0f, 0.0f, 0.08f, -50.0f, 50.0f, -200.0f, 200.0f);
+}
+
+// ====== Kernels ======
+
+static void opEmpty(uint32_t i) {
+  benchSink += i;
+}
+
+static void opParseJoystick(uint32_t i) {
+  const JoyText& j = s_joy[i & (BENCH_INPUTS - 1)];
+  JoystickData js;
+  benchSink += parseJoystickData(j.text, j.len, &js) ? (uint16_t)js.y_right : 0;
+}
+
+static void opFormatString(uint32_t i) {
+  char buf[24];
+  formatTelemetryString(&s_sens[i & (BENCH_INPUTS - 1)], buf, sizeof(buf));
+  benchSink += (uint8_t)buf[2];
+}
+
+// Parts in the order prepareAckTelemetry() sends them
+static void opFormatAckPart(uint32_t i) {
+  const uint8_t k = i & (BENCH_INPUTS - 1);
+  char buf[32];
+  benchSink += formatTelemetryPart(i % TEL_PART_COUNT, s_sens[k], s_vert[k], k & 1, buf, sizeof(buf));
+}
+
+static void opPidStep(uint32_t i) {
+  const ctrl_t* c = s_cmd[i & (BENCH_INPUTS - 1)];
+  const ctrl_t u = pidStep(s_pid, c[1], c[2], BENCH_DT, c[3]);
+  benchSink += ctrlToFloat(u) > 0.0f;
+}
+
+static void opAttitudeUpdate(uint32_t i) {
+  CtrlAttitude att;
+  attitudeUpdate(s_sens[i & (BENCH_INPUTS - 1)], BENCH_DT, &att);
+  benchSink += ctrlToFloat(att.roll) > 0.0f;
+}
+
+static void opMixer(uint32_t i) {
+  const ctrl_t* c = s_cmd[i & (BENCH_INPUTS - 1)];
+  uint8_t out[MIXER_MAX_MOTORS];
+  benchSink += mixerComputeActive(c[0], c[1], c[2], c[3], true, out) + out[0];
+}
+
+// ====== Measurement ======
+
+BenchStats benchMeasure(const char* name, BenchOp op, BenchClock clock) {
+  uint32_t call = 0;
+  for (uint32_t n = 0; n < BENCH_BATCH; n++) op(call++);   // caches, branch predictors
+
+  for (uint32_t s = 0; s < BENCH_SAMPLES; s++) {
+    const uint32_t t0 = clock();
+    for (uint32_t n = 0; n < BENCH_BATCH; n++) op(call++);
+    s_samples[s] = clock() - t0;
+  }
+
+  // Insertion sort: 101 values, no allocation on the target
+  for (uint32_t a = 1; a < BENCH_SAMPLES; a++) {
+    const uint32_t v = s_samples[a];
+    uint32_t b = a;
+    for (; b > 0 && s_samples[b - 1] > v; b--) s_samples[b] = s_samples[b - 1];
+    s_samples[b] = v;
+  }
+
+  const float perCall = 1.0f / BENCH_BATCH;
+  BenchStats st;
+  st.name = name;
+  st.minT = s_samples[0] * perCall;
+  st.medianT = s_samples[BENCH_SAMPLES / 2] * perCall;
+  st.p90T = s_samples[BENCH_SAMPLES * 9 / 10] * perCall;
+  st.maxT = s_samples[BENCH_SAMPLES - 1] * perCall;
+  return st;
+}
+
+void benchRunKernels(BenchClock clock, BenchReport report) {
+  attitudeInit(0.98f);
+  pidReset(s_pid);
+  report(benchMeasure("empty", opEmpty, clock));
+  report(benchMeasure("parse_joystick", opParseJoystick, clock));
+  report(benchMeasure("format_string", opFormatString, clock));
+  report(benchMeasure("format_ack_part", opFormatAckPart, clock));
+  report(benchMeasure("pid_step", opPidStep, clock));
+  report(benchMeasure("attitude_update", opAttitudeUpdate, clock));
+  report(benchMeasure("mixer", opMixer, clock));
+}
+
+void benchPrint(Print& out, const BenchStats& s, const char* unit) {
+  out.printf("BENCH: %-16s median %8.1f  min %8.1f  p90 %8.1f  max %8.1f  %s/call\r\n",
+             s.name, s.medianT, s.minT, s.p90T, s.maxT, unit);
+}
@@ -0,0 +1,51 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <Arduino.h>
+
+// ====== Microbenchmarks of the RX hot paths ======
+// The same kernels build into host/bench (nanoseconds) and into the RX
+// sketch with -DBENCH_KERNELS=1 (CPU cycles, printed once at boot, then
+// the RX starts as usual). A sample is BENCH_BATCH calls over a fixed table
+// of inputs (same seed every run) after one warm-up batch; a kernel reports
+// min / median / p90 / max per call over BENCH_SAMPLES samples. Compare
+// medians: interrupts and task switches only land in the upper tail.
+
+#ifndef BENCH_KERNELS
+#define BENCH_KERNELS 0        // 1 = прогнать ядра при старте RX (такты)
+#endif
+#ifndef BENCH_BATCH
+#define BENCH_BATCH 64         // вызовов в одном замере
+#endif
+#ifndef BENCH_SAMPLES
+#define BENCH_SAMPLES 101      // замеров на ядро, нечётное — медиана без усреднения
+#endif
+
+typedef uint32_t (*BenchClock)();      // host: ns, ESP32: cycles; only differences are used
+typedef void (*BenchOp)(uint32_t i);   // i = call number, picks the input
+
+struct BenchStats {
+  const char* name;
+  float minT, medianT, p90T, maxT;     // clock units per call
+};
+
+typedef void (*BenchReport)(const BenchStats& s);
+
+// Input tables; mixer set up first (mixerInit())
+void benchInit();
+
+// Any op, e.g. host-only kernels
+BenchStats benchMeasure(const char* name, BenchOp op, BenchClock clock);
+
+// parse_joystick, format_string, format_ack_part, pid_step, attitude_update,
+// mixer, and "empty" (call and loop overhead, not subtracted). Leaves the
+// attitude filter dirty: stabilizerInit() afterwards.
+void benchRunKernels(BenchClock clock, BenchReport report);
+
+// "BENCH: name median ... (unit/call)"
+void benchPrint(Print& out, const BenchStats& s, const char* unit);
+
+// Kernel results are folded in here so the calls are not optimised away
+extern volatile uint32_t benchSink;
+
+#endif // BENCH_H
@@ -0,0 +1,254 @@
+#include "blackbox.h"
+#include "serial_log.h"
+
+#if BLACKBOX_ENABLED
+
+#include <LittleFS.h>
+
+#define RING_MASK (BLACKBOX_RING_SIZE - 1)
+static const uint32_t FLUSH_CHUNK = 512;      // write to flash in pieces of this size
+static const uint32_t FLUSH_PERIOD_MS = 10;
+
+// ====== Ring buffer (single producer: loop, single consumer: flush task) ======
+static uint8_t s_ring[BLACKBOX_RING_SIZE];
+static volatile uint32_t s_head = 0;   // free-running, advanced by the control loop
+static volatile uint32_t s_tail = 0;   // free-running, advanced by the flush task
+
+// ====== Session state (control loop only) ======
+static bool s_fsOk = false;
+static volatile bool s_active = false;
+static uint32_t s_sessionStartUs = 0;
+static uint32_t s_lastFrameUs = 0;
+static int32_t s_prev[BBX_MAX_FIELDS];
+static uint8_t s_fieldCount = 0;
+static uint8_t s_motorCount = 0;
+static uint8_t s_framesSinceIntra = 0;
+static uint8_t s_rateCounter = 0;
+static bool s_forceIntra = true;
+static uint32_t s_dropped = 0;
+static uint32_t s_droppedReported = 0;
+static uint32_t s_ringPeak = 0;        // most bytes waiting at once
+
+// ====== Flush task state ======
+static volatile bool s_fileOpen = false;
+static volatile bool s_fileFull = false;
+static volatile uint32_t s_writes = 0;
+static volatile uint32_t s_writeMaxUs = 0;
+
+static bool ringPush(const uint8_t* data, uint32_t len)
+{
+  uint32_t head = s_head;
+  const uint32_t used = head - s_tail;
+  if (BLACKBOX_RING_SIZE - used < len) {
+    s_dropped++;
+    s_forceIntra = true;
+    return false;
+  }
+  if (used + len > s_ringPeak) s_ringPeak = used + len;
+  uint32_t idx = head & RING_MASK;
+  uint32_t first = min<uint32_t>(len, BLACKBOX_RING_SIZE - idx);
+  memcpy(&s_ring[idx], data, first);
+  memcpy(s_ring, data + first, len - first);
+  __sync_synchronize();   // data must be visible before the new head
+  s_head = head + len;
+  return true;
+}
+
+static void flushTask(void*)
+{
+  File f;
+  for (;;) {
+    uint32_t tail = s_tail;
+    uint32_t avail = s_head - tail;
+
+    // Armed: flash stays untouched (BLACKBOX_FLUSH_ARMED=1: a full chunk at
+    // a time); drain everything once stopped
+    const bool hold = s_active && (!BLACKBOX_FLUSH_ARMED || avail < FLUSH_CHUNK);
+    if (avail == 0 || hold) {
+      if (!s_active && avail == 0 && f) {
+        f.close();
+        s_fileOpen = false;
+      }
+      vTaskDelay(pdMS_TO_TICKS(FLUSH_PERIOD_MS));
+      continue;
+    }
+
+    if (!f) {
+      f = LittleFS.open(BLACKBOX_FILE, FILE_APPEND);
+      s_fileOpen = (bool)f;
+    }
+
+    uint32_t idx = tail & RING_MASK;
+    uint32_t n = min<uint32_t>(min<uint32_t>(avail, FLUSH_CHUNK), BLACKBOX_RING_SIZE - idx);
+    if (f && f.size() + n <= BLACKBOX_MAX_FILE) {
+      const uint32_t t0 = micros();
+      f.write(&s_ring[idx], n);
+      const uint32_t us = micros() - t0;
+      if (us > s_writeMaxUs) s_writeMaxUs = us;
+      s_writes++;
+    } else {
+      s_fileFull = true;   // discard, the loop must never wait for flash
+    }
+    __sync_synchronize();
+    s_tail = tail + n;
+  }
+}
+
+bool blackboxInit()
+{
+  s_fsOk = LittleFS.begin(true);   // format on first use
+  if (!s_fsOk) {
+    logText(LOG_ERROR, "BLACKBOX: LittleFS mount failed, recorder disabled");
+    return false;
+  }
+  // loopTask priority: a lower one never runs, the loop does not block.
+  // It shares the CPU only while disarmed unless BLACKBOX_FLUSH_ARMED.
+  xTaskCreate(flushTask, "bbx_flush", 4096, nullptr, tskIDLE_PRIORITY + 1, nullptr);
+  return true;
+}
+
+void blackboxStart()
+{
+  if (!s_fsOk || s_active) return;
+
+  // Start over when the previous flights filled the file
+  if (!s_fileOpen && LittleFS.exists(BLACKBOX_FILE)) {
+    File f = LittleFS.open(BLACKBOX_FILE, FILE_READ);
+    bool full = f && f.size() > BLACKBOX_MAX_FILE - FLUSH_CHUNK;
+    f.close();
+    if (full) {
+      LittleFS.remove(BLACKBOX_FILE);
+      s_fileFull = false;
+    }
+  }
+
+  s_motorCount = min<uint8_t>(mixerMotorCount(), BBX_MAX_MOTORS);
+  s_fieldCount = BBX_F_FIXED_COUNT + s_motorCount + 1;
+  s_sessionStartUs = s_lastFrameUs = micros();
+  s_framesSinceIntra = 0;
+  s_forceIntra = true;
+  s_dropped = s_droppedReported = 0;
+  s_ringPeak = 0;
+
+  uint8_t hdr[6] = { BBX_MAGIC[0], BBX_MAGIC[1], BBX_MAGIC[2], BBX_MAGIC[3], BBX_VERSION, s_motorCount };
+  s_active = ringPush(hdr, sizeof(hdr));
+}
+
+void blackboxStop()
+{
+  s_active = false;
+}
+
+bool blackboxActive() { return s_active; }
+
+uint32_t blackboxDropped() { return s_dropped; }
+
+void blackboxLogEvent(uint8_t code, int32_t arg)
+{
+  if (!s_active) return;
+  uint8_t buf[12];
+  uint8_t len = 0;
+  buf[len++] = BBX_TAG_EVENT;
+  len += bbxPutVarint(&buf[len], micros() - s_sessionStartUs);
+  buf[len++] = code;
+  len += bbxPutVarint(&buf[len], bbxZigzag(arg));
+  ringPush(buf, len);
+}
+
+static inline int32_t q(float v, float scale) { return (int32_t)(v * scale); }
+
+void blackboxLogFrame(uint32_t timeUs, const TelemetryData& sens, const StabilizerDebug& st)
+{
+  if (!s_active) return;
+  if (BLACKBOX_RATE_DIV > 1 && ++s_rateCounter < BLACKBOX_RATE_DIV) return;
+  s_rateCounter = 0;
+
+  if (s_dropped != s_droppedReported) {
+    uint32_t lost = s_dropped - s_droppedReported;
+    s_droppedReported = s_dropped;
+    blackboxLogEvent(BBX_EV_DROPPED, (int32_t)lost);
+  }
+
+  int32_t v[BBX_MAX_FIELDS];
+  v[BBX_F_GYRO_X]   = q(sens.gyro_x,  BBX_SCALE_GYRO);
+  v[BBX_F_GYRO_Y]   = q(sens.gyro_y,  BBX_SCALE_GYRO);
+  v[BBX_F_GYRO_Z]   = q(sens.gyro_z,  BBX_SCALE_GYRO);
+  v[BBX_F_ACC_X]    = q(sens.accel_x, BBX_SCALE_ACCEL);
+  v[BBX_F_ACC_Y]    = q(sens.accel_y, BBX_SCALE_ACCEL);
+  v[BBX_F_ACC_Z]    = q(sens.accel_z, BBX_SCALE_ACCEL);
+  v[BBX_F_ROLL]     = q(st.att.roll,  BBX_SCALE_ANGLE);
+  v[BBX_F_PITCH]    = q(st.att.pitch, BBX_SCALE_ANGLE);
+  v[BBX_F_SP_ROLL]  = q(st.sp_roll,     BBX_SCALE_SETPOINT);
+  v[BBX_F_SP_PITCH] = q(st.sp_pitch,    BBX_SCALE_SETPOINT);
+  v[BBX_F_SP_YAW]   = q(st.sp_yaw_rate, BBX_SCALE_SETPOINT);
+  for (uint8_t k = 0; k < 3; ++k) {
+    v[BBX_F_P_ROLL + 3 * k] = q(st.p[k], BBX_SCALE_PID);
+    v[BBX_F_I_ROLL + 3 * k] = q(st.i[k], BBX_SCALE_PID);
+    v[BBX_F_D_ROLL + 3 * k] = q(st.d[k], BBX_SCALE_PID);
+  }
+  for (uint8_t m = 0; m < s_motorCount; ++m) {
+    v[BBX_F_FIXED_COUNT + m] = st.motors[m];
+  }
+  v[BBX_F_FIXED_COUNT + s_motorCount] = st.mixFlags;
+
+  bool intra = s_forceIntra || s_framesSinceIntra >= BBX_INTRA_INTERVAL;
+  uint8_t buf[1 + 5 + 5 * BBX_MAX_FIELDS];
+  uint8_t len = 0;
+  buf[len++] = intra ? BBX_TAG_INTRA : BBX_TAG_INTER;
+  len += bbxPutVarint(&buf[len], intra ? timeUs - s_sessionStartUs : timeUs - s_lastFrameUs);
+  for (uint8_t i = 0; i < s_fieldCount; ++i) {
+    len += bbxPutVarint(&buf[len], bbxZigzag(intra ? v[i] : v[i] - s_prev[i]));
+  }
+
+  if (ringPush(buf, len)) {
+    memcpy(s_prev, v, s_fieldCount * sizeof(int32_t));
+    s_lastFrameUs = timeUs;
+    s_framesSinceIntra = intra ? 1 : s_framesSinceIntra + 1;
+    s_forceIntra = false;
+  }
+}
+
+void blackboxDump(Print& out)
+{
+  char line[112];
+  snprintf(line, sizeof(line), "BBX: ring_peak=%lu/%u dropped=%lu writes=%lu write_max_us=%lu%s",
+           (unsigned long)s_ringPeak, (unsigned)BLACKBOX_RING_SIZE, (unsigned long)s_dropped,
+           (unsigned long)s_writes, (unsigned long)s_writeMaxUs, BLACKBOX_FLUSH_ARMED ? " flush_armed" : "");
+  out.println(line);
+}
+
+bool blackboxCommand(char c, Print& s)
+{
+  if (c != 'b' && c != 'x') return false;
+
+  // Flash is touched from the loop only on the bench, never in flight
+  if (s_active || s_fileOpen || s_head != s_tail) {
+    s.println("BBX_BUSY");
+    return true;
+  }
+
+  if (c == 'x') {
+    LittleFS.remove(BLACKBOX_FILE);
+    s_fileFull = false;
+    s.println("BBX_ERASED");
+    return true;
+  }
+
+  File f = LittleFS.open(BLACKBOX_FILE, FILE_READ);
+  if (!f) {
+    s.println("BBX_EMPTY");
+    return true;
+  }
+  s.print("BBX_BEGIN "); s.println((uint32_t)f.size());
+  uint8_t buf[256];
+  size_t n;
+  while ((n = f.read(buf, sizeof(buf))) > 0) {
+    s.write(buf, n);
+  }
+  f.close();
+  s.println();
+  s.print("BBX_END "); s.println(s_fileFull ? "TRUNCATED" : "OK");
+  return true;
+}
+
+#endif // BLACKBOX_ENABLED
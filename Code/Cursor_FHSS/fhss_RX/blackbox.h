@@ -0,0 +1,72 @@
+#ifndef BLACKBOX_H
+#define BLACKBOX_H
+
+#include <Arduino.h>
+#include "blackbox_format.h"
+#include "telemetry.h"
+#include "stabilizer.h"
+
+// ====== Blackbox flight recorder ======
+// Control loop encodes one frame per iteration into a RAM ring (no flash
+// access, no allocation); a background FreeRTOS task drains the ring to
+// LittleFS. Logging runs only while armed. Decode with host/blackbox_decode.
+//
+// A LittleFS write programs (and now and then erases) the internal flash,
+// which turns the cache off: on the single-core C6 the control loop stalls
+// for the whole operation whatever the task priority. So by default the
+// flight stays in the ring and goes to flash after disarm; a flight longer
+// than the ring loses its tail (BBX_EV_DROPPED, `BBX:` line of the `d` command).
+// Longer flights: BLACKBOX_RATE_DIV. BLACKBOX_FLUSH_ARMED=1 writes during
+// the flight as well (bench: the stalls show in the profiler histogram
+// and as write_max_us).
+
+#ifndef BLACKBOX_ENABLED
+#define BLACKBOX_ENABLED 1
+#endif
+#ifndef BLACKBOX_RING_SIZE
+#define BLACKBOX_RING_SIZE 65536             // байт, степень двойки: весь полёт до дизарма
+#endif
+#ifndef BLACKBOX_MAX_FILE
+#define BLACKBOX_MAX_FILE (1024UL * 1024UL)  // при переполнении лог начинается заново при арме
+#endif
+#ifndef BLACKBOX_FLUSH_ARMED
+#define BLACKBOX_FLUSH_ARMED 0               // 1 = писать во флеш и в арме (цикл стоит на записи)
+#endif
+#ifndef BLACKBOX_RATE_DIV
+#define BLACKBOX_RATE_DIV 1                  // писать каждый N-й кадр цикла
+#endif
+#define BLACKBOX_FILE "/blackbox.bbx"
+
+#if BLACKBOX_ENABLED
+
+bool blackboxInit();                 // mount LittleFS, start flush task
+void blackboxStart();                // new session (call on arm)
+void blackboxStop();                 // end session (call on disarm)
+bool blackboxActive();
+uint32_t blackboxDropped();          // records lost to a full ring
+
+void blackboxLogFrame(uint32_t timeUs, const TelemetryData& sens, const StabilizerDebug& st);
+void blackboxLogEvent(uint8_t code, int32_t arg = 0);
+
+// Serial commands while disarmed: 'b' = dump log, 'x' = erase log.
+// Returns true if the command was handled.
+bool blackboxCommand(char c, Print& out);
+
+// "BBX: ring_peak=... dropped=... writes=... write_max_us=..."
+void blackboxDump(Print& out);
+
+#else
+
+inline bool blackboxInit() { return false; }
+inline void blackboxStart() {}
+inline void blackboxStop() {}
+inline bool blackboxActive() { return false; }
+inline uint32_t blackboxDropped() { return 0; }
+inline void blackboxLogFrame(uint32_t, const TelemetryData&, const StabilizerDebug&) {}
+inline void blackboxLogEvent(uint8_t, int32_t = 0) {}
+inline bool blackboxCommand(char, Print&) { return false; }
+inline void blackboxDump(Print&) {}
+
+#endif // BLACKBOX_ENABLED
+
+#endif // BLACKBOX_H
@@ -0,0 +1,79 @@
+#ifndef BLACKBOX_FORMAT_H
+#define BLACKBOX_FORMAT_H
+
+// Blackbox log layout. Shared by the firmware (blackbox.cpp) and the host
+// decoder (host/blackbox_decode.cpp), so no Arduino dependencies here.
+//
+// Session:  "BBX1" version:u8 motorCount:u8
+// 'I' frame: uvarint timeUs (since session start), fields as zigzag absolute
+// 'P' frame: uvarint dtUs (since previous frame), fields as zigzag delta
+// 'E' event: uvarint timeUs (since session start), code:u8, zigzag arg
+//
+// An 'I' frame is written every BBX_INTRA_INTERVAL frames and after any
+// dropped record, so a decoder can always resynchronise.
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define BBX_MAGIC            "BBX1"
+#define BBX_VERSION          1
+#define BBX_INTRA_INTERVAL   32
+#define BBX_MAX_MOTORS       6
+
+#define BBX_TAG_INTRA  'I'
+#define BBX_TAG_INTER  'P'
+#define BBX_TAG_EVENT  'E'
+
+// Fixed-point scales applied before encoding (value * scale -> int32)
+#define BBX_SCALE_GYRO      100.0f  // 0.01 sensor units
+#define BBX_SCALE_ACCEL     100.0f  // 0.01 m/s^2
+#define BBX_SCALE_ANGLE      10.0f  // 0.1 deg
+#define BBX_SCALE_SETPOINT   10.0f  // 0.1 deg or deg/s
+#define BBX_SCALE_PID        10.0f  // 0.1 PWM counts
+
+// Field order of every frame; motors follow, then mixer flags
+enum BbxField {
+  BBX_F_GYRO_X = 0, BBX_F_GYRO_Y, BBX_F_GYRO_Z,
+  BBX_F_ACC_X, BBX_F_ACC_Y, BBX_F_ACC_Z,
+  BBX_F_ROLL, BBX_F_PITCH,
+  BBX_F_SP_ROLL, BBX_F_SP_PITCH, BBX_F_SP_YAW,
+  BBX_F_P_ROLL, BBX_F_I_ROLL, BBX_F_D_ROLL,
+  BBX_F_P_PITCH, BBX_F_I_PITCH, BBX_F_D_PITCH,
+  BBX_F_P_YAW, BBX_F_I_YAW, BBX_F_D_YAW,
+  BBX_F_FIXED_COUNT
+};
+
+#define BBX_MAX_FIELDS (BBX_F_FIXED_COUNT + BBX_MAX_MOTORS + 1)
+
+// Event codes
+enum BbxEvent : uint8_t {
+  BBX_EV_SYNC_OK   = 1,  // arg: 0
+  BBX_EV_LINK_LOST = 2,  // arg: ms since last packet
+  BBX_EV_ARMED     = 3,
+  BBX_EV_DISARMED  = 4,
+  BBX_EV_DROPPED   = 5,  // arg: records dropped since last report
+  BBX_EV_FAILSAFE  = 6,  // arg: FailsafeStage (0 = ok .. 4 = disarm)
+};
+
+static inline uint32_t bbxZigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+static inline int32_t bbxUnzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+// Returns bytes written (1..5)
+static inline uint8_t bbxPutVarint(uint8_t* p, uint32_t v) {
+  uint8_t n = 0;
+  while (v >= 0x80) { p[n++] = (uint8_t)(v | 0x80); v >>= 7; }
+  p[n++] = (uint8_t)v;
+  return n;
+}
+
+// Returns bytes consumed, 0 on truncated/overlong input
+static inline size_t bbxGetVarint(const uint8_t* p, size_t avail, uint32_t* v) {
+  uint32_t r = 0;
+  for (size_t n = 0; n < avail && n < 5; ++n) {
+    r |= (uint32_t)(p[n] & 0x7F) << (7 * n);
+    if (!(p[n] & 0x80)) { *v = r; return n + 1; }
+  }
+  return 0;
+}
+
+#endif // BLACKBOX_FORMAT_H
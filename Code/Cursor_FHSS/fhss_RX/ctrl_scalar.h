@@ -0,0 +1,132 @@
+#ifndef CTRL_SCALAR_H
+#define CTRL_SCALAR_H
+
+#include <stdint.h>
+#include <math.h>
+
+// ====== Scalar type of the control pipeline ======
+// attitude / PID / mixer cores are templates on the scalar type. The RX
+// instantiates them with ctrl_t: float by default, Q15.16 fixed point with
+// -DCTRL_FIXED_POINT=1 (ESP32-C6 has no FPU, every float op is a libcall).
+// Sensor input and debug/blackbox output stay float; conversion happens
+// once at the edges of stabilizeMix().
+
+#ifndef CTRL_FIXED_POINT
+#define CTRL_FIXED_POINT 0
+#endif
+
+// Signed fixed point on int32_t with FRAC fractional bits. Products and
+// quotients go through int64_t. Only division saturates (x/dt can be
+// large); the control ranges (deg, deg/s, m/s^2, PWM) otherwise stay far
+// below 2^(31-FRAC).
+template <int FRAC>
+struct Fixed {
+  static constexpr int32_t ONE = (int32_t)1 << FRAC;
+  int32_t raw;
+
+  Fixed() = default;
+  // Implicit from float/int so constants read naturally; costs a float op
+  // on the C6, so keep these out of the per-loop path except for inputs.
+  constexpr Fixed(float f) : raw((int32_t)(f * ONE + (f >= 0.0f ? 0.5f : -0.5f))) {}
+  constexpr Fixed(int v) : raw((int32_t)v * ONE) {}
+
+  static constexpr Fixed fromRaw(int32_t r) { Fixed x; x.raw = r; return x; }
+  explicit operator float() const { return (float)raw * (1.0f / ONE); }
+
+  Fixed operator-() const { return fromRaw(-raw); }
+  Fixed operator+(Fixed o) const { return fromRaw(raw + o.raw); }
+  Fixed operator-(Fixed o) const { return fromRaw(raw - o.raw); }
+  Fixed operator*(Fixed o) const { return fromRaw((int32_t)(((int64_t)raw * o.raw) >> FRAC)); }
+  Fixed operator/(Fixed o) const {
+    if (o.raw == 0) return fromRaw(raw >= 0 ? INT32_MAX : -INT32_MAX);
+    int64_t q = ((int64_t)raw << FRAC) / o.raw;
+    if (q > INT32_MAX) q = INT32_MAX;
+    if (q < -INT32_MAX) q = -INT32_MAX;
+    return fromRaw((int32_t)q);
+  }
+  Fixed& operator+=(Fixed o) { raw += o.raw; return *this; }
+  Fixed& operator-=(Fixed o) { raw -= o.raw; return *this; }
+  Fixed& operator*=(Fixed o) { *this = *this * o; return *this; }
+
+  bool operator<(Fixed o) const  { return raw < o.raw; }
+  bool operator>(Fixed o) const  { return raw > o.raw; }
+  bool operator<=(Fixed o) const { return raw <= o.raw; }
+  bool operator>=(Fixed o) const { return raw >= o.raw; }
+  bool operator==(Fixed o) const { return raw == o.raw; }
+  bool operator!=(Fixed o) const { return raw != o.raw; }
+};
+
+typedef Fixed<16> q16_t;
+
+#if CTRL_FIXED_POINT
+typedef q16_t ctrl_t;
+#else
+typedef float ctrl_t;
+#endif
+
+// ====== Helpers, overloaded for float and Fixed ======
+
+inline float ctrlToFloat(float v) { return v; }
+template <int F> inline float ctrlToFloat(Fixed<F> v) { return (float)v; }
+
+template <typename T> inline T ctrlAbs(T v) { return v < T(0) ? -v : v; }
+template <typename T> inline T ctrlMin(T a, T b) { return b < a ? b : a; }
+template <typename T> inline T ctrlMax(T a, T b) { return a < b ? b : a; }
+template <typename T> inline T ctrlClamp(T v, T lo, T hi) { return v < lo ? lo : (v > hi ? hi : v); }
+
+// Smallest positive step (guards divisions by dt)
+inline float ctrlEpsilon(float) { return 1e-6f; }
+template <int F> inline Fixed<F> ctrlEpsilon(Fixed<F>) { return Fixed<F>::fromRaw(1); }
+
+// v already clamped to 0..255
+inline uint8_t ctrlRoundU8(float v) { return (uint8_t)(v + 0.5f); }
+template <int F> inline uint8_t ctrlRoundU8(Fixed<F> v) {
+  return (uint8_t)((v.raw + (Fixed<F>::ONE >> 1)) >> F);
+}
+
+inline float ctrlSqrt(float v) { return sqrtf(v); }
+inline float ctrlAtan2Deg(float y, float x) { return atan2f(y, x) * 57.2957795f; }
+
+// Integer square root: raw result = sqrt(raw << F)
+template <int F>
+inline Fixed<F> ctrlSqrt(Fixed<F> v) {
+  if (v.raw <= 0) return Fixed<F>::fromRaw(0);
+  uint64_t n = (uint64_t)v.raw << F;
+  uint64_t res = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+  while (bit > n) bit >>= 2;
+  while (bit) {
+    if (n >= res + bit) {
+      n -= res + bit;
+      res = (res >> 1) + bit;
+    } else {
+      res >>= 1;
+    }
+    bit >>= 2;
+  }
+  return Fixed<F>::fromRaw((int32_t)res);
+}
+
+// atan2 in degrees: octant reduction, one division, odd polynomial for
+// atan on [0, 1] (Abramowitz & Stegun 4.4.49, |err| < 1e-5 rad)
+template <int F>
+inline Fixed<F> ctrlAtan2Deg(Fixed<F> y, Fixed<F> x) {
+  typedef Fixed<F> T;
+  int32_t ay = y.raw < 0 ? -y.raw : y.raw;
+  int32_t ax = x.raw < 0 ? -x.raw : x.raw;
+  if (ax == 0 && ay == 0) return T(0);
+  bool swap = ay > ax;
+  T z = T::fromRaw(swap ? ax : ay) / T::fromRaw(swap ? ay : ax);   // 0..1
+  T z2 = z * z;
+  T r = T(1.1937714f);                  // coefficients * 180/pi
+  r = T(-4.8777637f) + r * z2;
+  r = T(10.3213139f) + r * z2;
+  r = T(-18.9247128f) + r * z2;
+  r = T(57.2881023f) + r * z2;
+  T a = r * z;
+  if (swap) a = T(90) - a;
+  if (x.raw < 0) a = T(180) - a;
+  return y.raw < 0 ? -a : a;
+}
+
+#endif // CTRL_SCALAR_H
@@ -0,0 +1,76 @@
+#include "failsafe.h"
+#include "stabilizer.h"
+
+static const char* const STAGE_NAMES[] = { "ok", "hold", "level", "descend", "disarm" };
+
+static FailsafeStage s_stage = FS_DISARM;
+static bool     s_linked = false;      // хотя бы один пакет после старта
+static uint32_t s_lastPacketUs = 0;
+static uint32_t s_slotUs = FAILSAFE_SLOT_US;
+static uint32_t s_missed = 0;
+static bool     s_landedTiming = false;
+static uint32_t s_landedSinceUs = 0;
+
+void failsafeInit() {
+  s_stage = FS_DISARM;
+  s_linked = false;
+  s_lastPacketUs = 0;
+  s_missed = 0;
+  s_landedTiming = false;
+  stabilizerSetDescent(0.0f);
+}
+
+void failsafeOnPacket(uint32_t nowUs) {
+  s_linked = true;
+  s_lastPacketUs = nowUs;
+  s_missed = 0;
+  s_stage = FS_OK;
+}
+
+void failsafeSetSlotUs(uint32_t us) {
+  s_slotUs = us > 0 ? us : FAILSAFE_SLOT_US;
+}
+
+FailsafeStage failsafeStage() { return s_stage; }
+uint32_t failsafeMissedSlots() { return s_missed; }
+
+const char* failsafeStageName(FailsafeStage s) {
+  return s <= FS_DISARM ? STAGE_NAMES[s] : "?";
+}
+
+static bool landed(uint32_t nowUs) {
+  const VerticalState& vs = stabilizerDebug().vert;
+  if (vs.height > FAILSAFE_LANDED_HEIGHT || fabsf(vs.climb) > FAILSAFE_LANDED_CLIMB) {
+    s_landedTiming = false;
+    return false;
+  }
+  if (!s_landedTiming) {
+    s_landedTiming = true;
+    s_landedSinceUs = nowUs;
+  }
+  return nowUs - s_landedSinceUs >= (uint32_t)FAILSAFE_LANDED_MS * 1000UL;
+}
+
+FailsafeStage failsafeUpdate(uint32_t nowUs, JoystickData* js) {
+  if (s_linked) {
+    const uint32_t sinceMs = (nowUs - s_lastPacketUs) / 1000UL;
+    s_missed = (nowUs - s_lastPacketUs) / s_slotUs;
+    FailsafeStage next = FS_OK;
+    if (sinceMs >= FAILSAFE_DISARM_MS)          next = FS_DISARM;
+    else if (sinceMs >= FAILSAFE_DESCEND_MS)    next = FS_DESCEND;
+    else if (sinceMs >= FAILSAFE_LEVEL_MS)      next = FS_LEVEL;
+    else if (s_missed >= FAILSAFE_HOLD_SLOTS)   next = FS_HOLD;
+
+    if (next < s_stage) next = s_stage;   // вниз только через новый пакет
+    if (next == FS_DESCEND && landed(nowUs)) next = FS_DISARM;
+    if (next != FS_DESCEND) s_landedTiming = false;
+    s_stage = next;
+  }
+
+  if (s_stage >= FS_LEVEL) {
+    js->x_left = js->x_right = js->y_right = 0;
+  }
+  stabilizerSetDescent(s_stage == FS_DESCEND ? FAILSAFE_DESCENT_RATE : 0.0f);
+  if (s_stage == FS_DISARM && stabilizerDebug().armed) stabilizerDisarm();
+  return s_stage;
+}
@@ -0,0 +1,71 @@
+#ifndef FAILSAFE_H
+#define FAILSAFE_H
+
+#include <Arduino.h>
+#include "joystick.h"
+
+// ====== Link failsafe ======
+// The TX sends one control packet per hop slot, so HOLD is counted in
+// missed slots since the last valid joystick packet and loss is seen within
+// a few milliseconds instead of at the 100 ms resync. The later stages are
+// plain time since that packet: they must not stretch with the TDMA slot
+// (group size) or the TX idle rate. Stages escalate:
+//
+//   HOLD     last sticks as received (short dropouts are normal in FHSS)
+//   LEVEL    roll / pitch / yaw centred, throttle held
+//   DESCEND  centred, throttle replaced by a climb-rate descent
+//            (altitude estimator, same loop as altitude hold)
+//   DISARM   after touchdown (low and not moving) or FAILSAFE_DISARM_MS
+//
+// Any valid packet returns to FS_OK at once. A disarm is not undone: the
+// pilot re-arms with the stick combo.
+
+#ifndef FAILSAFE_SLOT_US
+#define FAILSAFE_SLOT_US 2000          // период слота TX (PACKET_INTERVAL_MS), до sync
+#endif
+#ifndef FAILSAFE_HOLD_SLOTS
+#define FAILSAFE_HOLD_SLOTS 3          // 6 ms при 2 мс слоте
+#endif
+#ifndef FAILSAFE_LEVEL_MS
+#define FAILSAFE_LEVEL_MS 100
+#endif
+#ifndef FAILSAFE_DESCEND_MS
+#define FAILSAFE_DESCEND_MS 1000
+#endif
+#ifndef FAILSAFE_DISARM_MS
+#define FAILSAFE_DISARM_MS 30000       // посадка не распознана
+#endif
+#ifndef FAILSAFE_DESCENT_RATE
+#define FAILSAFE_DESCENT_RATE 0.5f     // m/s
+#endif
+#ifndef FAILSAFE_LANDED_HEIGHT
+#define FAILSAFE_LANDED_HEIGHT 0.15f   // m above the arming point
+#endif
+#ifndef FAILSAFE_LANDED_CLIMB
+#define FAILSAFE_LANDED_CLIMB 0.2f     // m/s
+#endif
+#ifndef FAILSAFE_LANDED_MS
+#define FAILSAFE_LANDED_MS 500
+#endif
+
+enum FailsafeStage : uint8_t {
+  FS_OK = 0,
+  FS_HOLD,
+  FS_LEVEL,
+  FS_DESCEND,
+  FS_DISARM
+};
+
+void failsafeInit();                      // starts in FS_DISARM until the first packet
+void failsafeOnPacket(uint32_t nowUs);    // valid control packet received
+void failsafeSetSlotUs(uint32_t us);      // TX slot from the sync frame (TDMA: > 2 ms)
+
+// Every loop before stabilizeMix(): escalates, rewrites js for LEVEL and
+// DESCEND and drives the stabilizer (descent, disarm).
+FailsafeStage failsafeUpdate(uint32_t nowUs, JoystickData* js);
+
+FailsafeStage failsafeStage();
+uint32_t failsafeMissedSlots();
+const char* failsafeStageName(FailsafeStage s);
+
+#endif // FAILSAFE_H
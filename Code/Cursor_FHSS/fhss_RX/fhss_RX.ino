@@ -10,6 +10,22 @@
 #include "joystick.h"    // <-- общий тип JoystickData
 #include "stabilizer.h"
 #include "mixer.h"
+#include "blackbox.h"
+#include "profiler.h"
+#include "autotune.h"
+#include "failsafe.h"
+#include "serial_log.h"
+#include "sensor_hub.h"
+#include "ack_fifo.h"
+#include "rf24_shadow.h"
+#include "nrf_dma.h"
+#include "power_idle.h"
+#include "link_format.h"
+#include "rc_smooth.h"
+#include "bench.h"
+#if BENCH_KERNELS
+#include <esp_cpu.h>
+#endif
 
 // ====== Pin configuration for ESP32-C6 Supermini ======
 #ifndef NRF24_CE_PIN
@@ -24,11 +40,18 @@
 #define SCK_PIN    7
 
 
-static RF24 radio(NRF24_CE_PIN, NRF24_CSN_PIN);
+static RadioDriver radio(NRF24_CE_PIN, NRF24_CSN_PIN);   // RF24Shadow, or NrfDma with NRF_DMA 1
+static LogPrint logOut;   // после logInit() весь текст в Serial идёт через кольцо лога
+
+// Position in the TX's TDMA group (fhss_TX TDMA_AIRCRAFT); 0 = single aircraft
+#ifndef AIRCRAFT_ID
+#define AIRCRAFT_ID 0
+#endif
+static_assert(AIRCRAFT_ID >= 0 && AIRCRAFT_ID <= 7, "AIRCRAFT_ID: 0..7");
 
-// Addressing must mirror TX
-static const uint8_t txAddress[5] = {'T','X','A','A','A'}; // writing pipe for TX
-static const uint8_t rxAddress[5] = {'R','X','A','A','A'}; // this device reading pipe
+// Addressing must mirror TX; aircraft k ends in 'A'+k
+static const uint8_t txAddress[5] = {'T','X','A','A','A' + AIRCRAFT_ID}; // writing pipe for TX
+static const uint8_t rxAddress[5] = {'R','X','A','A','A' + AIRCRAFT_ID}; // this device reading pipe
 
 // ====== FHSS configuration ======
 static const uint8_t SYNC_CHANNEL = 70;
@@ -38,18 +61,52 @@ static const uint8_t NUM_CHANNELS = sizeof(FHSS_CHANNELS) / sizeof(FHSS_CHANNELS
 // Timing
 static const uint32_t MAX_NO_PACKET_MS = 100; // resync if we stop receiving - faster timeout
 
+// ====== Power-aware idle (power_idle.h) ======
+// Disarmed and the TX in its idle rate (slotUs in the packet at least
+// POWER_SLEEP_SLOT_US): after each packet the nRF24 is powered down and the
+// C6 light-sleeps until RX_WAKE_EARLY_US before the next one is due, then
+// listens until it comes. A full-rate packet or arming ends it; the TX
+// leaves idle as soon as the arm combo starts, so the RX is at full rate
+// within one idle interval, long before the combo's hold time is over.
+#ifndef POWER_SLEEP_SLOT_US
+#define POWER_SLEEP_SLOT_US 5000     // короче — не спать между пакетами
+#endif
+#ifndef RADIO_WAKE_US
+#define RADIO_WAKE_US 1500           // nRF24 Tpd2stby (кварц)
+#endif
+#ifndef RX_WAKE_EARLY_US
+#define RX_WAKE_EARLY_US (RADIO_WAKE_US + 1000)   // + дрожание пробуждения TX
+#endif
+
 // ====== Packets ======
 struct ControlPacket {
     uint16_t sequence;
     uint8_t channelIndex;
     uint8_t payloadLength;
     char payload[24];
+    uint16_t slotUs;             // TX slot period (idle: longer), 0 = older TX
 };
 
 struct TelemetryPacket {
     uint16_t sequence;
     uint8_t payloadLength;
     char payload[24];
+    uint8_t flags;               // TEL_FLAG_*, was padding: same packet size
+};
+
+static const uint8_t TEL_FLAG_STATE = 0x01;   // flags valid (0 from an older RX)
+static const uint8_t TEL_FLAG_ARMED = 0x02;   // stabilizer armed: TX stays at full rate
+
+// Sync beacon, mirrors TX (version 1 ended after seed)
+struct __attribute__((packed)) SyncFrame {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t channelCount;
+    uint8_t seed;
+    uint8_t aircraftId;
+    uint8_t aircraftCount;
+    uint8_t channelIndex;        // FHSS index of the TX's next slot
+    uint16_t slotUs;             // hop period
 };
 
 
@@ -59,45 +116,21 @@ static bool isSynchronized = false;
 static uint8_t currentChannelIndex = 0;
 static uint16_t telemetrySequence = 0;
 static uint32_t lastPacketMillis = 0;
-static uint32_t lastControlOutput = 0;
-static TelemetryData telemetryData;
-static uint32_t lastTelemetryRead = 0;
-static uint8_t telemetryPacketIndex = 0; // 0=accel, 1=gyro, 2=pressure
-static JoystickData lastJoystickData = {0};
-
-// ====== Motor control (PWM on GPIO 1,2,3,4) ======
-static const int MOTOR_PINS[4] = {1, 2, 3, 4};
-
-static inline uint8_t mapThrottleToPwm(int16_t raw)
-{
-    // Инвертируем: внизу (y_left = -1000) = 0, вверху (y_left = +1000) = 1000
-    if (raw < -1000) raw = -1000;
-    if (raw >  1000) raw =  1000;
-
-    // Инверсия оси: чем выше стик, тем больше газ
-    int16_t inverted = -raw; // теперь верх = -1000 → ниж = +1000
-
-    long shifted = (long)inverted + 1000;   // диапазон 0..2000
-    long pwm = (shifted * 255L) / 2000L;    // 0..255 для analogWrite
-
-    if (pwm < 0)   pwm = 0;
-    if (pwm > 255) pwm = 255;
-
-    return (uint8_t)pwm;
-}
-
-
-static inline void motorControl()
-{
-    uint8_t pwm = mapThrottleToPwm(lastJoystickData.y_left);
-    for (int i = 0; i < 4; ++i) {
-        analogWrite(MOTOR_PINS[i], pwm);
-    }
-}
-
-
+static uint8_t telemetryPacketIndex = 0; // 0=accel, 1=gyro, 2=pressure, 3=range, 4=height, 5=loop profile
+#if PROFILER_ENABLED
+static const uint8_t TELEMETRY_PACKET_TYPES = TEL_PART_COUNT + 1;
+#else
+static const uint8_t TELEMETRY_PACKET_TYPES = TEL_PART_COUNT;
+#endif
+static uint32_t lastPacketUs = 0;
+static uint32_t txSlotUs = 0;          // from the last control packet
+static uint32_t syncSlotUs = FAILSAFE_SLOT_US;   // TDMA slot from the sync frame
+static bool rxIdle = false;
+static bool sleptSincePacket = false;
 
-static uint32_t lastJoystickOutput = 0;
+// Serial log records (serial_log.h); formatted by the drain task
+enum : uint8_t { LOG_REC_JOYSTICK = 1, LOG_REC_CTL = 2 };
+enum : uint8_t { LOG_SLOT_JOYSTICK = 0, LOG_SLOT_CTL = 1 };
 
 // ====== Helpers ======
 static void setRadioChannel(uint8_t channel)
@@ -106,65 +139,51 @@ static void setRadioChannel(uint8_t channel)
 }
 
 // ====== Joystick functions ======
-static bool parseJoystickData(const char* payload, size_t payloadLength, JoystickData* joystickData)
+static void formatJoystick(Print& out, const uint8_t* data, uint8_t len)
 {
-    // Expected format: "J:LX:LY:RX:RY" where values are -1000 to +1000
-    if (payloadLength < 10 || payload[0] != 'J' || payload[1] != ':') {
-        return false;
-    }
-    
-    char* endPtr;
-    const char* start = payload + 2; // Skip "J:"
-    
-    // Parse LX (Left X)
-    joystickData->x_left = (int16_t)strtol(start, &endPtr, 10);
-    if (*endPtr != ':') return false;
-    start = endPtr + 1;
-    
-    // Parse LY (Left Y)
-    joystickData->y_left = (int16_t)strtol(start, &endPtr, 10);
-    if (*endPtr != ':') return false;
-    start = endPtr + 1;
-    
-    // Parse RX (Right X)
-    joystickData->x_right = (int16_t)strtol(start, &endPtr, 10);
-    if (*endPtr != ':') return false;
-    start = endPtr + 1;
-    
-    // Parse RY (Right Y)
-    joystickData->y_right = (int16_t)strtol(start, &endPtr, 10);
-    
-    // Validate ranges
-    if (joystickData->x_left < -1000 || joystickData->x_left > 1000 ||
-        joystickData->y_left < -1000 || joystickData->y_left > 1000 ||
-        joystickData->x_right < -1000 || joystickData->x_right > 1000 ||
-        joystickData->y_right < -1000 || joystickData->y_right > 1000) {
-        return false;
-    }
-    
-    return true;
+    if (len != sizeof(JoystickData)) return;
+    JoystickData js;
+    memcpy(&js, data, sizeof(js));
+    out.print("JOYSTICK: ");
+    out.print("LX="); out.print(js.x_left);
+    out.print(" LY="); out.print(js.y_left);
+    out.print(" RX="); out.print(js.x_right);
+    out.print(" RY="); out.println(js.y_right);
+
+    // Mode 1 interpretation
+    out.print("MODE1: Throttle="); out.print(js.y_left);
+    out.print(" Yaw="); out.print(js.x_left);
+    out.print(" Pitch="); out.print(js.y_right);
+    out.print(" Roll="); out.println(js.x_right);
+}
+
+static void formatControl(Print& out, const uint8_t* data, uint8_t len)
+{
+    out.print("CTL:");
+    out.write(data, len);
+    out.println();
 }
 
 static void outputJoystickData(const JoystickData* joystickData)
 {
     // Output joystick data with controlled frequency (max 50Hz)
-    if (millis() - lastJoystickOutput > 20) {
-        Serial.print("JOYSTICK: ");
-        Serial.print("LX="); Serial.print(joystickData->x_left);
-        Serial.print(" LY="); Serial.print(joystickData->y_left);
-        Serial.print(" RX="); Serial.print(joystickData->x_right);
-        Serial.print(" RY="); Serial.println(joystickData->y_right);
-        
-        // Mode 1 interpretation
-        Serial.print("MODE1: Throttle="); Serial.print(joystickData->y_left);
-        Serial.print(" Yaw="); Serial.print(joystickData->x_left);
-        Serial.print(" Pitch="); Serial.print(joystickData->y_right);
-        Serial.print(" Roll="); Serial.println(joystickData->x_right);
-        
-        lastJoystickOutput = millis();
+    if (logRateOk(LOG_SLOT_JOYSTICK, 20)) {
+        logRecord(LOG_REC_JOYSTICK, LOG_INFO, joystickData, sizeof(JoystickData));
     }
 }
 
+#if BENCH_KERNELS
+static uint32_t benchCycles()
+{
+    return esp_cpu_get_cycle_count();
+}
+
+static void printBench(const BenchStats& s)
+{
+    benchPrint(logOut, s, "cycles");
+}
+#endif
+
 static void configureRadioCommon()
 {
     radio.setDataRate(RF24_2MBPS);  // Maximum speed for nRF24L01
@@ -183,43 +202,46 @@ static void enterSyncMode()
     radio.openWritingPipe(rxAddress);   // for ACK payload context
     radio.openReadingPipe(1, txAddress);
     radio.startListening();
+    ackFifoFlush();   // sync magic goes out first
+    rcSmoothReset();  // the TX may come back at another rate
 }
 
 static void prepareAckTelemetry()
 {
-    // Before sync: always preload ACK with sync magic so TX can detect it
+    // One payload in the TX FIFO at a time; nothing to do until it is sent
+    const uint32_t nowUs = micros();
+    if (!ackFifoWantsPayload(nowUs)) return;
+
+    // Before sync: keep the sync magic loaded so TX can detect it
     if (!isSynchronized) {
-        const uint8_t ack[4] = {0xD2, 0xC3, 0xF0, 0xA5};
-        radio.writeAckPayload(1, ack, sizeof(ack));
+        const uint8_t ack[5] = {0xD2, 0xC3, 0xF0, 0xA5, AIRCRAFT_ID};
+        ackFifoLoad(ack, sizeof(ack), nowUs, nowUs);
         return;
     }
 
-    // After sync: read telemetry from sensors and format it
+    // After sync: format the next telemetry part from the sensor snapshot
     TelemetryPacket tp = {};
     tp.sequence = telemetrySequence++;
+    tp.flags = TEL_FLAG_STATE | (stabilizerDebug().armed ? TEL_FLAG_ARMED : 0);
 
-    // Read telemetry data from sensors every 20ms for faster updates
-    if (millis() - lastTelemetryRead > 20) {
-        readTelemetryData(&telemetryData);
-        lastTelemetryRead = millis();
-    }
+    // Same sample the controller used: no I2C here
+    SensorSnapshot snap;
+    sensorHubRead(&snap);
+    const TelemetryData& telemetryData = snap.data;
 
     // Send telemetry in parts to fit in 24 bytes
     char telemetryString[32] = {0};
     
-    switch (telemetryPacketIndex) {
-        case 0: // Accelerometer
-            snprintf(telemetryString, sizeof(telemetryString), "A:%.1f:%.1f:%.1f",
-                telemetryData.accel_x, telemetryData.accel_y, telemetryData.accel_z);
-            break;
-        case 1: // Gyroscope
-            snprintf(telemetryString, sizeof(telemetryString), "G:%.1f:%.1f:%.1f",
-                telemetryData.gyro_x, telemetryData.gyro_y, telemetryData.gyro_z);
-            break;
-        case 2: // Pressure
-            snprintf(telemetryString, sizeof(telemetryString), "P:%.0f",
-                telemetryData.pressure);
-            break;
+#if PROFILER_ENABLED
+    if (telemetryPacketIndex == TEL_PART_COUNT) { // Loop profile: worst loop us, mean loop us, deadline overruns
+        snprintf(telemetryString, sizeof(telemetryString), "L:%lu:%lu:%lu",
+            (unsigned long)profilerMaxUs(PROF_LOOP), (unsigned long)profilerMeanUs(PROF_LOOP),
+            (unsigned long)profilerOverruns());
+    } else
+#endif
+    {
+        formatTelemetryPart(telemetryPacketIndex, telemetryData, stabilizerDebug().vert,
+            stabilizerDebug().altHold, telemetryString, sizeof(telemetryString));
     }
     
     // (debug prints removed to avoid blocking the radio loop)
@@ -231,10 +253,10 @@ static void prepareAckTelemetry()
     }
     
     // Cycle through telemetry packets
-    telemetryPacketIndex = (telemetryPacketIndex + 1) % 3;
+    telemetryPacketIndex = (telemetryPacketIndex + 1) % TELEMETRY_PACKET_TYPES;
 
-    // Always prepare ACK payload, even if empty
-    radio.writeAckPayload(1, &tp, sizeof(tp));
+    // Age at delivery is counted from the IMU sample the payload came from
+    ackFifoLoad(&tp, sizeof(tp), snap.imuUs, nowUs);
 }
 
 static void handleSyncFrame(const uint8_t* data, uint8_t len)
@@ -242,12 +264,26 @@ static void handleSyncFrame(const uint8_t* data, uint8_t len)
     if (len < 4) return;
     // Expect magic 0xA5F0C3D2 in little-endian
     if (data[0] == 0xD2 && data[1] == 0xC3 && data[2] == 0xF0 && data[3] == 0xA5) {
-        // Send back the same 4 bytes as confirmation in ACK payload
-        uint8_t ack[4] = {0xD2, 0xC3, 0xF0, 0xA5};
-        radio.writeAckPayload(1, ack, sizeof(ack));
+        // Version 2 tells where the hopping is and how long a slot is
+        // (longer than 2 ms with several aircraft); version 1 starts at 0
+        SyncFrame frame = {};
+        memcpy(&frame, data, min<size_t>(len, sizeof(frame)));
+        if (frame.version >= 2 && len >= sizeof(frame)) {
+            if (frame.aircraftId != AIRCRAFT_ID) return;
+            currentChannelIndex = frame.channelIndex % NUM_CHANNELS;
+            syncSlotUs = frame.slotUs ? frame.slotUs : FAILSAFE_SLOT_US;
+        } else {
+            currentChannelIndex = 0;
+            syncSlotUs = FAILSAFE_SLOT_US;
+        }
+        failsafeSetSlotUs(syncSlotUs);
+
+        // This frame's ACK already carried the magic back; start telemetry fresh
+        ackFifoFlush();
         isSynchronized = true;
         lastPacketMillis = millis();
-        Serial.println("SYNC_OK_RX");
+        logText(LOG_INFO, "SYNC_OK_RX");
+        blackboxLogEvent(BBX_EV_SYNC_OK);
     }
 }
 
@@ -271,6 +307,7 @@ static void receiveLoop()
 
         uint8_t buf[32] = {0};
         radio.read(buf, len);
+        ackFifoOnPacket(micros());
 
         if (!isSynchronized && len >= 4) {
             handleSyncFrame(buf, len);
@@ -288,25 +325,36 @@ static void receiveLoop()
             if (pkt.payload[0] == 'J' && pkt.payload[1] == ':') {
                 JoystickData joystickData;
                 if (parseJoystickData(pkt.payload, pkt.payloadLength, &joystickData)) {
-                    lastJoystickData = joystickData;
+                    const uint32_t rxUs = micros();
+                    rcSmoothOnPacket(joystickData, rxUs);
+                    failsafeOnPacket(rxUs);
                     outputJoystickData(&joystickData);
                 }
             } else {
                 // Print other control data with controlled frequency
-                if (millis() - lastControlOutput > 10) {
-                    Serial.print("CTL:");
-                    Serial.write((const uint8_t*)pkt.payload, pkt.payloadLength);
-                    Serial.println();
-                    lastControlOutput = millis();
+                if (logRateOk(LOG_SLOT_CTL, 10)) {
+                    logRecord(LOG_REC_CTL, LOG_INFO, pkt.payload, pkt.payloadLength);
                 }
             }
         }
 
         lastPacketMillis = millis();
+        lastPacketUs = micros();
+        sleptSincePacket = false;
+        if (pkt.slotUs) {
+            txSlotUs = pkt.slotUs;
+            // Idle packets are not missed slots; armed, HOLD never stretches
+            // past the TDMA slot (the TX may not have seen the arm yet)
+            const bool armed = stabilizerDebug().armed;
+            failsafeSetSlotUs(armed && pkt.slotUs > syncSlotUs ? syncSlotUs : pkt.slotUs);
+        }
 
-        // After successfully handling a packet, hop to next channel (only when synced)
+        // After successfully handling a packet, hop to the channel after the
+        // one the TX says it used: the TX hops every slot, ACKed or not, so a
+        // missed packet is made up when the TX comes back to this channel
         if (isSynchronized) {
-            currentChannelIndex = (currentChannelIndex + 1) % NUM_CHANNELS;
+            const uint8_t index = pkt.channelIndex < NUM_CHANNELS ? pkt.channelIndex : currentChannelIndex;
+            currentChannelIndex = (index + 1) % NUM_CHANNELS;
         }
         
         packetCount++;
@@ -316,26 +364,72 @@ static void receiveLoop()
 static void attemptResyncIfNeeded()
 {
     if (isSynchronized && millis() - lastPacketMillis > MAX_NO_PACKET_MS) {
+        blackboxLogEvent(BBX_EV_LINK_LOST, (int32_t)(millis() - lastPacketMillis));
         enterSyncMode();
     }
 }
 
+static void radioSleep()
+{
+    radio.powerDown();
+    powerRadioOff(true);
+}
+
+static void radioWake()
+{
+    radio.powerUp(0);   // CE is high: RX again once the oscillator is up
+    powerRadioOff(false);
+}
+
+static void updatePowerMode()
+{
+#if POWER_IDLE
+    const bool idle = isSynchronized && !stabilizerDebug().armed && txSlotUs >= POWER_SLEEP_SLOT_US;
+    if (idle == rxIdle) return;
+    rxIdle = idle;
+    powerSetMode(idle ? PWR_IDLE : PWR_FULL);
+    logText(LOG_INFO, idle ? "PWR: idle" : "PWR: full rate");
+#endif
+}
+
+// Once per packet: sleep through the gap to the next idle packet
+static void idleSleep()
+{
+    if (!rxIdle || sleptSincePacket) return;
+    sleptSincePacket = true;
+    radioSleep();
+    if (powerSleepUntil(lastPacketUs + txSlotUs - RX_WAKE_EARLY_US)) profilerSkipLoop();
+    radioWake();
+}
+
 void setup(){
     mixerInit();
     stabilizerInit();
-    // Initialize motor output pins
-    for (int i = 0; i < 4; ++i) {
-        pinMode(MOTOR_PINS[i], OUTPUT);
-    }
+    failsafeInit();
 
     //SPI.begin(SCK_PIN, MISO_PIN, MOSI_PIN, NRF24_CSN_PIN);
     Serial.begin(115200);
     delay(50);
+    logInit(Serial);
+    logSetFormatter(LOG_REC_JOYSTICK, formatJoystick);
+    logSetFormatter(LOG_REC_CTL, formatControl);
+
+#if BENCH_KERNELS
+    // Same kernels as host/bench, in CPU cycles; then the normal start
+    logPrintf(LOG_INFO, "BENCH: CPU %lu MHz", (unsigned long)getCpuFrequencyMhz());
+    benchInit();
+    benchRunKernels(benchCycles, printBench);
+    stabilizerInit();
+#endif
 
     // Initialize telemetry sensors
     if (!initializeTelemetrySensors()) {
-        Serial.println("WARNING: Some telemetry sensors failed to initialize!");
+        logText(LOG_WARN, "Some telemetry sensors failed to initialize!");
     }
+    sensorHubInit();
+
+    blackboxInit();
+    profilerInit();
 
     
 
@@ -349,35 +443,139 @@ void setup(){
     radio.openWritingPipe(rxAddress);
     radio.openReadingPipe(1, txAddress);
     radio.startListening();
+    radio.sync();
 
+    ackFifoInit(radio);
     enterSyncMode();
-    pinMode(1, OUTPUT);
+
+    // C6 at 160 MHz; radio listening; MPU6050 always on
+    static const PowerModel model = { 32000, 200, 13500, 1, 4000 };
+    powerInit(model);
+}
+
+static void handleSerialCommands()
+{
+    if (!Serial.available()) return;
+    char c = (char)Serial.read();
+    // Blackbox dump streams the whole file straight to the port:
+    // stop-the-world, disarmed only; the log waits in its ring meanwhile
+    if (!stabilizerDebug().armed && (c == 'b' || c == 'x')) {
+        logHold(true);
+        blackboxCommand(c, Serial);
+        logHold(false);
+        return;
+    }
+    if (autotuneCommand(c, logOut)) return;
+    if (logCommand(c, logOut)) return;
+    if (c == 'h') {
+        stabilizerSetAltHold(!stabilizerAltHold());
+        logText(LOG_INFO, stabilizerAltHold() ? "ALT: hold on" : "ALT: hold off");
+        return;
+    }
+    if (profilerCommand(c, logOut)) return;
+    // Module counters: own letter, so they stay with PROFILER_ENABLED=0
+    if (c == 'd') {
+        sensorHubDump(logOut);
+        ackFifoDump(logOut);
+        rcSmoothDump(logOut);
+        blackboxDump(logOut);
+    }
+}
+
+// Log failsafe stage changes (Serial + blackbox)
+static void reportFailsafe(FailsafeStage stage)
+{
+    static FailsafeStage lastStage = FS_DISARM;   // = failsafeInit(), без сообщения при старте
+    if (stage == lastStage) return;
+    lastStage = stage;
+    logPrintf(stage == FS_OK ? LOG_INFO : LOG_WARN, "FS: %s missed=%lu",
+              failsafeStageName(stage), (unsigned long)failsafeMissedSlots());
+    blackboxLogEvent(BBX_EV_FAILSAFE, (int32_t)stage);
+}
+
+// Print autotune progress once per state/axis change (proposal on completion)
+static void reportAutotune()
+{
+    static uint8_t lastState = AT_IDLE, lastAxis = AT_ROLL;
+    uint8_t state = autotuneState(), axis = autotuneAxis();
+    if (state == lastState && axis == lastAxis) return;
+    lastState = state;
+    lastAxis = axis;
+    autotuneReport(logOut);
+}
+
+static void runReceive()
+{
+    PROF_START(PROF_RECEIVE);
+    receiveLoop();
+    PROF_STOP(PROF_RECEIVE);
+    attemptResyncIfNeeded();
 }
 
 void loop()
 {
+    profilerLoopTick();
+
     // Always prepare an ACK payload (telemetry) from Serial input if any
+    PROF_START(PROF_ACK_TELEMETRY);
     prepareAckTelemetry();
+    PROF_STOP(PROF_ACK_TELEMETRY);
 
-    receiveLoop();
-    attemptResyncIfNeeded();
+#if NRF_DMA
+    // Payload read goes out on the SPI DMA while the IMU is read over I2C
+    radio.prefetch();
+#else
+    runReceive();
+#endif
 
-    
     static uint32_t prevMicros = micros();
     uint32_t now = micros();
     float dt = (now - prevMicros) * 1e-6f;
     if (dt < 1e-6f) dt = 1e-6f;
     prevMicros = now;
 
-    TelemetryData sens;
-    readTelemetryData(&sens);
-
-    uint8_t m1, m2, m3, m4;
-    stabilizeMix(lastJoystickData, sens, dt, &m1, &m2, &m3, &m4);
-    mixerWrite(m1, m2, m3, m4);
+    PROF_START(PROF_SENSORS);
+    sensorHubUpdate(now);
+    PROF_STOP(PROF_SENSORS);
+#if NRF_DMA
+    runReceive();
+#endif
+    SensorSnapshot snap;
+    sensorHubRead(&snap);
+    const TelemetryData& sens = snap.data;
+
+    // Sticks at loop rate between packets (rc_smooth.h); failsafe: stale
+    // sticks are held, then levelled, then a descent
+    JoystickData cmd;
+    rcSmoothUpdate(now, &cmd);
+    reportFailsafe(failsafeUpdate(now, &cmd));
+
+    uint8_t motors[MIXER_MAX_MOTORS];
+    PROF_START(PROF_STABILIZE);
+    stabilizeMix(cmd, sens, dt, motors);
+    PROF_STOP(PROF_STABILIZE);
+    PROF_START(PROF_MIXER_WRITE);
+    mixerWrite(motors);
+    PROF_STOP(PROF_MIXER_WRITE);
+
+    // Blackbox: one session per arm, frame every loop
+    const StabilizerDebug& st = stabilizerDebug();
+    static bool loggedArmed = false;
+    if (st.armed != loggedArmed) {
+        if (st.armed) { blackboxStart(); blackboxLogEvent(BBX_EV_ARMED); }
+        else          { blackboxLogEvent(BBX_EV_DISARMED); blackboxStop(); }
+        loggedArmed = st.armed;
+    }
+    blackboxLogFrame(now, sens, st);
+    handleSerialCommands();
+    reportAutotune();
+    radio.report();
+    powerReport();
+
+    updatePowerMode();
+    idleSleep();
 // Minimal delay for high responsiveness
     delayMicroseconds(100);
-    // motorControl() replaced by mixerWrite
 }
 
 
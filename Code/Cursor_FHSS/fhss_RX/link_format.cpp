@@ -0,0 +1,93 @@
+#include "link_format.h"
+
+bool parseJoystickData(const char* payload, size_t payloadLength, JoystickData* joystickData) {
+  // Expected format: "J:LX:LY:RX:RY" where values are -1000 to +1000
+  if (payloadLength < 10 || payload[0] != 'J' || payload[1] != ':') {
+    return false;
+  }
+
+  char* endPtr;
+  const char* start = payload + 2; // Skip "J:"
+
+  // Parse LX (Left X)
+  joystickData->x_left = (int16_t)strtol(start, &endPtr, 10);
+  if (*endPtr != ':') return false;
+  start = endPtr + 1;
+
+  // Parse LY (Left Y)
+  joystickData->y_left = (int16_t)strtol(start, &endPtr, 10);
+  if (*endPtr != ':') return false;
+  start = endPtr + 1;
+
+  // Parse RX (Right X)
+  joystickData->x_right = (int16_t)strtol(start, &endPtr, 10);
+  if (*endPtr != ':') return false;
+  start = endPtr + 1;
+
+  // Parse RY (Right Y)
+  joystickData->y_right = (int16_t)strtol(start, &endPtr, 10);
+
+  // Validate ranges
+  if (joystickData->x_left < -1000 || joystickData->x_left > 1000 ||
+      joystickData->y_left < -1000 || joystickData->y_left > 1000 ||
+      joystickData->x_right < -1000 || joystickData->x_right > 1000 ||
+      joystickData->y_right < -1000 || joystickData->y_right > 1000) {
+    return false;
+  }
+
+  return true;
+}
+
+size_t formatTelemetryPart(uint8_t part, const TelemetryData& data, const VerticalState& vs, bool altHold,
+                           char* out, size_t outSize) {
+  int len = 0;
+  switch (part) {
+    case TEL_PART_ACCEL:
+      len = snprintf(out, outSize, "A:%.1f:%.1f:%.1f", data.accel_x, data.accel_y, data.accel_z);
+      break;
+    case TEL_PART_GYRO:
+      len = snprintf(out, outSize, "G:%.1f:%.1f:%.1f", data.gyro_x, data.gyro_y, data.gyro_z);
+      break;
+    case TEL_PART_PRESSURE:
+      len = snprintf(out, outSize, "P:%.0f", data.pressure);
+      break;
+    case TEL_PART_RANGE:
+      len = snprintf(out, outSize, "D:%d", (int)data.range_mm);
+      break;
+    case TEL_PART_HEIGHT: // m, climb m/s, hold flag
+      len = snprintf(out, outSize, "H:%.2f:%.2f:%d", vs.height, vs.climb, altHold ? 1 : 0);
+      break;
+    default:
+      if (outSize > 0) out[0] = '\0';
+      return 0;
+  }
+  if (len < 0) return 0;
+  return (size_t)len < outSize ? (size_t)len : outSize - 1;
+}
+
+// ====== Format telemetry data as string ======
+void formatTelemetryString(const TelemetryData* data, char* output, size_t maxLen) {
+  if (data == nullptr || output == nullptr || maxLen == 0) return;
+
+  // Ultra-compact format to fit in 24 bytes
+  // Format: aX:aY:aZ.gX:gY:gZ.p
+  // Example: 1.2:4.5:7.8.0.1:0.3:0.5.1013
+
+  int len = snprintf(output, maxLen, "%.1f:%.1f:%.1f.%.1f:%.1f:%.1f.%.0f",
+                     data->accel_x, data->accel_y, data->accel_z,
+                     data->gyro_x, data->gyro_y, data->gyro_z,
+                     data->pressure);
+
+  // If still too long, use even more compact format
+  if (len >= (int)maxLen - 1) {
+    len = snprintf(output, maxLen, "%.0f:%.0f:%.0f.%.0f:%.0f:%.0f.%.0f",
+                   data->accel_x, data->accel_y, data->accel_z,
+                   data->gyro_x, data->gyro_y, data->gyro_z,
+                   data->pressure);
+  }
+
+  // Ensure null termination
+  if (len >= (int)maxLen) {
+    output[maxLen - 1] = '\0';
+  }
+}
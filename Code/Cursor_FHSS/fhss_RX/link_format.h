@@ -0,0 +1,34 @@
+#ifndef LINK_FORMAT_H
+#define LINK_FORMAT_H
+
+#include <Arduino.h>
+#include "joystick.h"
+#include "telemetry.h"
+#include "altitude.h"
+
+// ====== Text payloads of the control link ======
+// Control packets carry "J:LX:LY:RX:RY"; ACK payloads carry one telemetry
+// part per packet ("A:", "G:", "P:", "D:", "H:"). Kept out of the sketch so
+// host/bench can time the same code.
+
+// "J:LX:LY:RX:RY", values -1000..+1000; false on anything else
+bool parseJoystickData(const char* payload, size_t payloadLength, JoystickData* joystickData);
+
+// Telemetry parts of prepareAckTelemetry(), in the order they are sent
+enum TelemetryPart : uint8_t {
+  TEL_PART_ACCEL = 0,    // A:ax:ay:az
+  TEL_PART_GYRO,         // G:gx:gy:gz
+  TEL_PART_PRESSURE,     // P:hPa
+  TEL_PART_RANGE,        // D:mm (-1 = нет)
+  TEL_PART_HEIGHT,       // H:m:m/s:hold
+  TEL_PART_COUNT
+};
+
+// Formats one part into out (NUL-terminated); returns its length, 0 for an unknown part
+size_t formatTelemetryPart(uint8_t part, const TelemetryData& data, const VerticalState& vs, bool altHold,
+                           char* out, size_t outSize);
+
+// All of accel/gyro/pressure in one line, "ax:ay:az.gx:gy:gz.p"
+void formatTelemetryString(const TelemetryData* data, char* output, size_t maxLen);
+
+#endif // LINK_FORMAT_H
@@ -1,15 +1,78 @@
 #include "mixer.h"
 
-void mixerInit() {
-  pinMode(MOTOR1_PIN, OUTPUT);
-  pinMode(MOTOR2_PIN, OUTPUT);
-  pinMode(MOTOR3_PIN, OUTPUT);
-  pinMode(MOTOR4_PIN, OUTPUT);
-}
-
-void mixerWrite(uint8_t m1, uint8_t m2, uint8_t m3, uint8_t m4) {
-  analogWrite(MOTOR1_PIN, m1);
-  analogWrite(MOTOR2_PIN, m2);
-  analogWrite(MOTOR3_PIN, m3);
-  analogWrite(MOTOR4_PIN, m4);
+// ===== Таблицы смешивания =====
+// Нумерация моторов = порядок строк. Знаки: +roll -> левые моторы быстрее,
+// +pitch -> передние быстрее; yaw чередуется по направлению вращения винтов.
+
+// Quad X: M1 передний левый, M2 передний правый, M3 задний правый, M4 задний левый
+static const MixerRule QUAD_X_RULES[] = {
+  { MOTOR1_PIN, +1.0f, +1.0f, -1.0f },
+  { MOTOR2_PIN, -1.0f, +1.0f, +1.0f },
+  { MOTOR3_PIN, -1.0f, -1.0f, -1.0f },
+  { MOTOR4_PIN, +1.0f, -1.0f, +1.0f },
+};
+
+// Quad +: M1 передний, M2 правый, M3 задний, M4 левый
+static const MixerRule QUAD_PLUS_RULES[] = {
+  { MOTOR1_PIN,  0.0f, +1.0f, -1.0f },
+  { MOTOR2_PIN, -1.0f,  0.0f, +1.0f },
+  { MOTOR3_PIN,  0.0f, -1.0f, -1.0f },
+  { MOTOR4_PIN, +1.0f,  0.0f, +1.0f },
+};
+
+// Hexa X (по часовой от переднего левого): M1 330°, M2 30°, M3 90°, M4 150°, M5 210°, M6 270°
+static const MixerRule HEXA_X_RULES[] = {
+  { MOTOR1_PIN, +0.5f, +0.866f, -1.0f },
+  { MOTOR2_PIN, -0.5f, +0.866f, +1.0f },
+  { MOTOR3_PIN, -1.0f,  0.0f,   -1.0f },
+  { MOTOR4_PIN, -0.5f, -0.866f, +1.0f },
+  { MOTOR5_PIN, +0.5f, -0.866f, -1.0f },
+  { MOTOR6_PIN, +1.0f,  0.0f,   +1.0f },
+};
+
+static const MixerTable TABLES[] = {
+  { QUAD_X_RULES,    sizeof(QUAD_X_RULES)    / sizeof(QUAD_X_RULES[0]) },
+  { QUAD_PLUS_RULES, sizeof(QUAD_PLUS_RULES) / sizeof(QUAD_PLUS_RULES[0]) },
+  { HEXA_X_RULES,    sizeof(HEXA_X_RULES)    / sizeof(HEXA_X_RULES[0]) },
+};
+
+static const MixerTable* s_table = &TABLES[MIXER_QUAD_X];
+static MixerCoeffs<ctrl_t> s_coeffs;
+
+const MixerTable& mixerTableFor(MixerGeometry g) {
+  if (g > MIXER_HEXA_X) g = MIXER_QUAD_X;
+  return TABLES[g];
+}
+
+uint8_t mixerCompute(const MixerTable& t, float throttle,
+                     float roll, float pitch, float yaw,
+                     bool airmode, uint8_t* out)
+{
+  MixerCoeffs<float> c;
+  mixerLoadCoeffs(t, &c);
+  return mixerComputeT(c, throttle, roll, pitch, yaw, airmode, out);
+}
+
+uint8_t mixerComputeActive(ctrl_t throttle, ctrl_t roll, ctrl_t pitch, ctrl_t yaw,
+                           bool airmode, uint8_t* out)
+{
+  return mixerComputeT(s_coeffs, throttle, roll, pitch, yaw, airmode, out);
+}
+
+void mixerInit(MixerGeometry g) {
+  s_table = &mixerTableFor(g);
+  mixerLoadCoeffs(*s_table, &s_coeffs);
+  for (uint8_t i = 0; i < s_table->count; ++i) {
+    pinMode(s_table->rules[i].pin, OUTPUT);
+  }
+}
+
+const MixerTable& mixerTable() { return *s_table; }
+
+uint8_t mixerMotorCount() { return s_table->count; }
+
+void mixerWrite(const uint8_t* out) {
+  for (uint8_t i = 0; i < s_table->count; ++i) {
+    analogWrite(s_table->rules[i].pin, out[i]);
+  }
 }
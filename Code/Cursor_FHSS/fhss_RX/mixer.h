@@ -2,6 +2,7 @@
 #define MIXER_H
 
 #include <Arduino.h>
+#include "ctrl_scalar.h"
 
 #ifndef MOTOR1_PIN
 #define MOTOR1_PIN 3
@@ -15,8 +16,152 @@
 #ifndef MOTOR4_PIN
 #define MOTOR4_PIN 4
 #endif
+#ifndef MOTOR5_PIN
+#define MOTOR5_PIN 20   // только для гексы
+#endif
+#ifndef MOTOR6_PIN
+#define MOTOR6_PIN 21   // только для гексы
+#endif
+
+#define MIXER_MAX_MOTORS 6
+#define MIXER_OUT_MAX    255.0f   // диапазон analogWrite
+
+// Геометрия рамы (выбирается при сборке через MIXER_GEOMETRY)
+enum MixerGeometry : uint8_t {
+  MIXER_QUAD_X = 0,
+  MIXER_QUAD_PLUS,
+  MIXER_HEXA_X,
+};
+
+#ifndef MIXER_GEOMETRY
+#define MIXER_GEOMETRY MIXER_QUAD_X
+#endif
+
+// One row per motor, in motor-number order: output pin and how much of each
+// axis correction this motor takes (+1 = speeds up for positive command).
+struct MixerRule {
+  uint8_t pin;
+  float roll;
+  float pitch;
+  float yaw;
+};
+
+struct MixerTable {
+  const MixerRule* rules;
+  uint8_t count;
+};
+
+// Flags returned by mixerCompute()
+#define MIXER_SAT_LOW      0x01  // collective hit the bottom of the range
+#define MIXER_SAT_HIGH     0x02  // collective hit the top of the range
+#define MIXER_YAW_LIMITED  0x04  // yaw was scaled down to keep roll/pitch
+#define MIXER_RP_LIMITED   0x08  // roll/pitch alone exceed the output range
+
+const MixerTable& mixerTableFor(MixerGeometry g);
+
+// Table coefficients converted to the controller scalar once, so the
+// fixed-point build does no float work per loop.
+template <typename T>
+struct MixerCoeffs {
+  T roll[MIXER_MAX_MOTORS];
+  T pitch[MIXER_MAX_MOTORS];
+  T yaw[MIXER_MAX_MOTORS];
+  uint8_t count;
+};
+
+template <typename T>
+inline void mixerLoadCoeffs(const MixerTable& t, MixerCoeffs<T>* c) {
+  c->count = min<uint8_t>(t.count, MIXER_MAX_MOTORS);
+  for (uint8_t i = 0; i < c->count; ++i) {
+    c->roll[i] = T(t.rules[i].roll);
+    c->pitch[i] = T(t.rules[i].pitch);
+    c->yaw[i] = T(t.rules[i].yaw);
+  }
+}
+
+// Pure mixing step, no hardware access (usable from host benchmarks).
+// throttle is 0..MIXER_OUT_MAX, corrections are in the same units.
+// Roll/pitch authority is kept first, yaw is scaled into what is left,
+// then collective is shifted so no motor leaves the range. Without airmode
+// collective is only ever lowered, so at low throttle motors clip at zero.
+template <typename T>
+uint8_t mixerComputeT(const MixerCoeffs<T>& c, T throttle,
+                      T roll, T pitch, T yaw,
+                      bool airmode, uint8_t* out)
+{
+  const T OUT_MAX = T(MIXER_OUT_MAX);
+  uint8_t flags = 0;
+  T rp[MIXER_MAX_MOTORS];
+  T mix[MIXER_MAX_MOTORS];
+
+  // 1) Roll/pitch: if they alone don't fit, scale them down together
+  T rpMin = T(0), rpMax = T(0);
+  for (uint8_t i = 0; i < c.count; ++i) {
+    rp[i] = roll * c.roll[i] + pitch * c.pitch[i];
+    if (rp[i] < rpMin) rpMin = rp[i];
+    if (rp[i] > rpMax) rpMax = rp[i];
+  }
+  const T rpRange = rpMax - rpMin;
+  if (rpRange > OUT_MAX) {
+    T k = OUT_MAX / rpRange;
+    for (uint8_t i = 0; i < c.count; ++i) rp[i] = rp[i] * k;
+    flags |= MIXER_RP_LIMITED;
+  }
+
+  // 2) Yaw gets whatever span is left: the largest share k (0..1) of it
+  //    that keeps every pair of motors within OUT_MAX. Bounded per pair,
+  //    so k moves continuously with the inputs: no edge where rounding
+  //    keeps or drops the whole yaw command.
+  T yw[MIXER_MAX_MOTORS];
+  for (uint8_t i = 0; i < c.count; ++i) yw[i] = yaw * c.yaw[i];
+  T kyaw = T(1);
+  for (uint8_t i = 0; i < c.count; ++i) {
+    for (uint8_t j = 0; j < c.count; ++j) {
+      const T dy = yw[i] - yw[j];
+      if (dy <= T(0)) continue;
+      T room = OUT_MAX - (rp[i] - rp[j]);
+      if (room < T(0)) room = T(0);   // rp scaled to OUT_MAX, off by rounding
+      if (room < kyaw * dy) kyaw = room / dy;
+    }
+  }
+  if (kyaw < T(1)) flags |= MIXER_YAW_LIMITED;
+
+  T mMin = T(0), mMax = T(0);
+  for (uint8_t i = 0; i < c.count; ++i) {
+    mix[i] = rp[i] + kyaw * yw[i];
+    if (mix[i] < mMin) mMin = mix[i];
+    if (mix[i] > mMax) mMax = mix[i];
+  }
+
+  // 3) Shift collective so the whole correction fits (airmode)
+  T base = throttle;
+  if (base > OUT_MAX - mMax) {
+    base = OUT_MAX - mMax;
+    flags |= MIXER_SAT_HIGH;
+  }
+  if (base < -mMin) {
+    if (airmode) base = -mMin;
+    flags |= MIXER_SAT_LOW;
+  }
+
+  for (uint8_t i = 0; i < c.count; ++i) {
+    out[i] = ctrlRoundU8(ctrlClamp(base + mix[i], T(0), OUT_MAX));
+  }
+  return flags;
+}
+
+// Float convenience wrapper (converts the table on every call)
+uint8_t mixerCompute(const MixerTable& t, float throttle,
+                     float roll, float pitch, float yaw,
+                     bool airmode, uint8_t* out);
+
+// Active table, precomputed coefficients in the controller scalar
+uint8_t mixerComputeActive(ctrl_t throttle, ctrl_t roll, ctrl_t pitch, ctrl_t yaw,
+                           bool airmode, uint8_t* out);
 
-void mixerInit();
-void mixerWrite(uint8_t m1, uint8_t m2, uint8_t m3, uint8_t m4);
+void mixerInit(MixerGeometry g = MIXER_GEOMETRY);
+const MixerTable& mixerTable();      // active table
+uint8_t mixerMotorCount();
+void mixerWrite(const uint8_t* out); // mixerMotorCount() values
 
 #endif // MIXER_H
@@ -0,0 +1,395 @@
+#include "nrf_dma.h"
+
+#if NRF_DMA
+
+#include <driver/spi_master.h>
+#include <esp_timer.h>
+#include <nRF24L01.h>
+#include "serial_log.h"
+
+enum : uint8_t { OP_RAW, OP_PL_WID, OP_PAYLOAD, OP_ACK };
+
+static const uint8_t CMD_NOP = 0xFF;
+static const uint8_t XFER_MAX = 33;        // command + 32 bytes
+static const uint8_t STATUS_FLAGS = _BV(RX_DR) | _BV(TX_DS) | _BV(MAX_RT);
+static const uint8_t RX_P_NO_EMPTY = 0x07;
+
+struct DmaSlot {
+  spi_transaction_t t;
+  uint8_t op;
+  volatile uint32_t startUs, endUs;
+};
+
+static spi_device_handle_t s_dev = nullptr;
+static DmaSlot s_slots[NRF_DMA_QUEUE];
+static uint8_t s_head = 0, s_tail = 0, s_inFlight = 0;
+
+// DMA reads whole words: buffers word-aligned, in internal RAM
+DMA_ATTR static uint8_t s_tx[NRF_DMA_QUEUE][36];
+DMA_ATTR static uint8_t s_rx[NRF_DMA_QUEUE][36];
+DMA_ATTR static uint8_t s_syncTx[36];
+DMA_ATTR static uint8_t s_syncRx[36];
+
+// Driver callbacks (SPI interrupt): bus time of queued transfers only
+static void IRAM_ATTR onTransferStart(spi_transaction_t* t) {
+  if (t->user) ((DmaSlot*)t->user)->startUs = (uint32_t)esp_timer_get_time();
+}
+
+static void IRAM_ATTR onTransferEnd(spi_transaction_t* t) {
+  if (t->user) ((DmaSlot*)t->user)->endUs = (uint32_t)esp_timer_get_time();
+}
+
+static bool rxHasData(uint8_t status) {
+  return ((status >> RX_P_NO) & 0x07) != RX_P_NO_EMPTY;
+}
+
+// ===== Queue =====
+
+void NrfDma::queue(uint8_t op, const uint8_t* tx, uint8_t len) {
+  if (s_inFlight == NRF_DMA_QUEUE) drain();
+  const uint8_t i = s_head;
+  DmaSlot& s = s_slots[i];
+  memcpy(s_tx[i], tx, len);
+  memset(&s.t, 0, sizeof(s.t));
+  s.t.length = len * 8;
+  s.t.tx_buffer = s_tx[i];
+  s.t.rx_buffer = s_rx[i];
+  s.t.user = &s;
+  s.op = op;
+  s.startUs = s.endUs = 0;
+  if (spi_device_queue_trans(s_dev, &s.t, portMAX_DELAY) != ESP_OK) return;
+  s_head = (uint8_t)((s_head + 1) % NRF_DMA_QUEUE);
+  s_inFlight++;
+  counters.queued++;
+}
+
+bool NrfDma::serviceOne(bool wait) {
+  if (!s_inFlight) return false;
+  spi_transaction_t* t;
+  const uint32_t t0 = micros();
+  if (spi_device_get_trans_result(s_dev, &t, wait ? portMAX_DELAY : 0) != ESP_OK) return false;
+  if (wait) counters.waitedUs += micros() - t0;
+  const uint8_t i = s_tail;   // results come back in queue order
+  s_tail = (uint8_t)((s_tail + 1) % NRF_DMA_QUEUE);
+  s_inFlight--;
+  finish(i);   // may queue the next transfer (payload after width)
+  return true;
+}
+
+void NrfDma::finish(uint8_t i) {
+  const DmaSlot& s = s_slots[i];
+  const uint8_t* rx = s_rx[i];
+  counters.busUs += s.endUs - s.startUs;
+
+  switch (s.op) {
+    case OP_PL_WID: {
+      if (!rxHasData(rx[0])) {
+        rxState = PKT_EMPTY;   // nothing to read, RX_DR left alone
+        break;
+      }
+      if (rx[1] == 0 || rx[1] > 32) {
+        rxState = PKT_NONE;    // corrupt width: getDynamicPayloadSize() flushes
+        break;
+      }
+      rxLen = rx[1];
+      rxState = PKT_PENDING;
+      uint8_t payload[XFER_MAX];
+      payload[0] = R_RX_PAYLOAD;
+      memset(payload + 1, CMD_NOP, rxLen);
+      queue(OP_PAYLOAD, payload, rxLen + 1);
+      const uint8_t clear[2] = { W_REGISTER | NRF_STATUS, _BV(RX_DR) };
+      queue(OP_RAW, clear, sizeof(clear));
+      break;
+    }
+    case OP_PAYLOAD:
+      memcpy(rxData, rx + 1, rxLen);
+      rxState = PKT_READY;
+      counters.packets++;
+      break;
+    case OP_ACK:
+      if (rx[0] & _BV(TX_FULL)) counters.ackFull++;   // write was ignored
+      break;
+  }
+}
+
+void NrfDma::prefetch() {
+  if (rxState == PKT_PENDING || rxState == PKT_READY) return;   // previous one not taken yet
+  rxState = PKT_WIDTH;
+
+  // Only the 2-byte width read is waited for; its STATUS decides whether
+  // the payload read goes into the queue at all (finish)
+  const uint8_t width[2] = { R_RX_PL_WID, CMD_NOP };
+  queue(OP_PL_WID, width, sizeof(width));
+  while (rxState == PKT_WIDTH && serviceOne(true)) {}
+}
+
+// ===== Blocking transfers (polling, after the queue) =====
+
+uint8_t NrfDma::transfer(const uint8_t* tx, uint8_t* rx, uint8_t len) {
+  drain();
+  memcpy(s_syncTx, tx, len);
+  spi_transaction_t t;
+  memset(&t, 0, sizeof(t));
+  t.length = len * 8;
+  t.tx_buffer = s_syncTx;
+  t.rx_buffer = s_syncRx;
+  spi_device_polling_transmit(s_dev, &t);
+  counters.blocking++;
+  if (rx) memcpy(rx, s_syncRx, len);
+  return s_syncRx[0];
+}
+
+uint8_t NrfDma::command(uint8_t cmd) {
+  return transfer(&cmd, nullptr, 1);
+}
+
+uint8_t NrfDma::writeRegister(uint8_t reg, const uint8_t* data, uint8_t len) {
+  uint8_t tx[6];
+  tx[0] = W_REGISTER | (REGISTER_MASK & reg);
+  memcpy(tx + 1, data, len);
+  return transfer(tx, nullptr, len + 1);
+}
+
+uint8_t NrfDma::readRegister(uint8_t reg) {
+  const uint8_t tx[2] = { (uint8_t)(R_REGISTER | (REGISTER_MASK & reg)), CMD_NOP };
+  uint8_t rx[2];
+  transfer(tx, rx, sizeof(tx));
+  return rx[1];
+}
+
+// ===== RF24 subset =====
+
+bool NrfDma::begin(int8_t sck, int8_t miso, int8_t mosi) {
+  pinMode(ce, OUTPUT);
+  digitalWrite(ce, LOW);
+
+  spi_bus_config_t bus;
+  memset(&bus, 0, sizeof(bus));
+  bus.mosi_io_num = mosi;
+  bus.miso_io_num = miso;
+  bus.sclk_io_num = sck;
+  bus.quadwp_io_num = -1;
+  bus.quadhd_io_num = -1;
+  bus.max_transfer_sz = 64;
+  if (spi_bus_initialize(SPI2_HOST, &bus, SPI_DMA_CH_AUTO) != ESP_OK) return false;
+
+  spi_device_interface_config_t dev;
+  memset(&dev, 0, sizeof(dev));
+  dev.mode = 0;
+  dev.clock_speed_hz = NRF_DMA_SPI_HZ;
+  dev.spics_io_num = csn;
+  dev.queue_size = NRF_DMA_QUEUE;
+  dev.pre_cb = onTransferStart;
+  dev.post_cb = onTransferEnd;
+  if (spi_bus_add_device(SPI2_HOST, &dev, &s_dev) != ESP_OK) return false;
+
+  delay(5);   // power-on reset
+
+  // Same defaults as RF24::begin() (nRF24L01+ only: no ACTIVATE)
+  config = _BV(EN_CRC) | _BV(CRCO);
+  writeRegister(NRF_CONFIG, config);
+  setRetries(5, 15);
+  rfSetup = readRegister(RF_SETUP);
+  setDataRate(RF24_1MBPS);
+  feature = 0;
+  writeRegister(FEATURE, feature);
+  writeRegister(DYNPD, 0);
+  writeRegister(EN_AA, 0x3F);
+  enRxAddr = _BV(ERX_P0) | _BV(ERX_P1);
+  writeRegister(EN_RXADDR, enRxAddr);
+  for (uint8_t pipe = 0; pipe < 6; pipe++) writeRegister(RX_PW_P0 + pipe, 32);
+  writeRegister(SETUP_AW, 3);   // 5-byte addresses
+  setChannel(76);
+  writeRegister(NRF_STATUS, STATUS_FLAGS);
+  flush_rx();
+  flush_tx();
+
+  config |= _BV(PWR_UP);
+  writeRegister(NRF_CONFIG, config);
+  delay(5);
+  return readRegister(SETUP_AW) == 3;
+}
+
+bool NrfDma::setDataRate(rf24_datarate_e rate) {
+  rfSetup &= ~(_BV(RF_DR_LOW) | _BV(RF_DR_HIGH));
+  if (rate == RF24_250KBPS) rfSetup |= _BV(RF_DR_LOW);
+  else if (rate == RF24_2MBPS) rfSetup |= _BV(RF_DR_HIGH);
+  writeRegister(RF_SETUP, rfSetup);
+  return readRegister(RF_SETUP) == rfSetup;
+}
+
+void NrfDma::setPALevel(uint8_t level, bool lnaEnable) {
+  rfSetup = (uint8_t)((rfSetup & 0xF8) | (min<uint8_t>(level, RF24_PA_MAX) << 1) | (lnaEnable ? 1 : 0));
+  writeRegister(RF_SETUP, rfSetup);
+}
+
+void NrfDma::setCRCLength(rf24_crclength_e length) {
+  config &= ~(_BV(EN_CRC) | _BV(CRCO));
+  if (length != RF24_CRC_DISABLED) config |= _BV(EN_CRC);
+  if (length == RF24_CRC_16) config |= _BV(CRCO);
+  writeRegister(NRF_CONFIG, config);
+}
+
+void NrfDma::setAutoAck(bool enable) {
+  writeRegister(EN_AA, enable ? 0x3F : 0);
+}
+
+void NrfDma::enableDynamicPayloads() {
+  feature |= _BV(EN_DPL);
+  writeRegister(FEATURE, feature);
+  writeRegister(DYNPD, 0x3F);
+}
+
+void NrfDma::enableAckPayload() {
+  feature |= _BV(EN_ACK_PAY) | _BV(EN_DPL);
+  writeRegister(FEATURE, feature);
+  writeRegister(DYNPD, readRegister(DYNPD) | _BV(DPL_P0) | _BV(DPL_P1));
+}
+
+void NrfDma::setRetries(uint8_t delay, uint8_t count) {
+  writeRegister(SETUP_RETR, (uint8_t)((min<uint8_t>(delay, 15) << ARD) | min<uint8_t>(count, 15)));
+}
+
+void NrfDma::setChannel(uint8_t ch) {
+  ch = min<uint8_t>(ch, 125);
+  if (ch == channel) return;   // receiveLoop() sets it every pass
+  writeRegister(RF_CH, ch);
+  channel = ch;
+}
+
+void NrfDma::openWritingPipe(const uint8_t* address) {
+  writeRegister(RX_ADDR_P0, address, 5);
+  writeRegister(TX_ADDR, address, 5);
+}
+
+void NrfDma::openReadingPipe(uint8_t pipe, const uint8_t* address) {
+  if (pipe > 5) return;
+  writeRegister(RX_ADDR_P0 + pipe, address, pipe < 2 ? 5 : 1);
+  writeRegister(RX_PW_P0 + pipe, 32);
+  enRxAddr |= _BV(pipe);
+  writeRegister(EN_RXADDR, enRxAddr);
+}
+
+void NrfDma::startListening() {
+  config |= _BV(PWR_UP) | _BV(PRIM_RX);
+  writeRegister(NRF_CONFIG, config);
+  writeRegister(NRF_STATUS, STATUS_FLAGS);
+  digitalWrite(ce, HIGH);
+  enRxAddr &= ~_BV(ERX_P0);   // pipe 0 = writing pipe, as RF24
+  writeRegister(EN_RXADDR, enRxAddr);
+}
+
+void NrfDma::stopListening() {
+  digitalWrite(ce, LOW);
+  if (feature & _BV(EN_ACK_PAY)) flush_tx();
+  config &= ~_BV(PRIM_RX);
+  writeRegister(NRF_CONFIG, config);
+  enRxAddr |= _BV(ERX_P0);
+  writeRegister(EN_RXADDR, enRxAddr);
+}
+
+void NrfDma::powerDown() {
+  digitalWrite(ce, LOW);
+  config &= ~_BV(PWR_UP);
+  writeRegister(NRF_CONFIG, config);
+}
+
+void NrfDma::powerUp(uint32_t settleUs) {
+  if (config & _BV(PWR_UP)) return;
+  config |= _BV(PWR_UP);
+  writeRegister(NRF_CONFIG, config);
+  if (config & _BV(PRIM_RX)) digitalWrite(ce, HIGH);   // back to RX by itself
+  if (settleUs) delayMicroseconds(settleUs);
+}
+
+bool NrfDma::available() {
+  if (rxState == PKT_PENDING) drain();
+  if (rxState == PKT_READY) return true;
+  if (rxState == PKT_EMPTY) {
+    rxState = PKT_NONE;   // prefetch() just looked: no second SPI round
+    return false;
+  }
+  return rxHasData(command(CMD_NOP));
+}
+
+uint8_t NrfDma::getDynamicPayloadSize() {
+  uint8_t width;
+  if (rxState == PKT_READY) {
+    width = rxLen;
+  } else {
+    const uint8_t tx[2] = { R_RX_PL_WID, CMD_NOP };
+    uint8_t rx[2];
+    transfer(tx, rx, sizeof(tx));
+    width = rx[1];
+  }
+  if (width > 32) {
+    // Corrupt width: the datasheet says flush
+    flush_rx();
+    rxState = PKT_NONE;
+    return 0;
+  }
+  return width;
+}
+
+void NrfDma::read(void* buf, uint8_t len) {
+  len = min<uint8_t>(len, 32);
+  if (rxState == PKT_READY) {
+    memcpy(buf, rxData, len);
+    rxState = PKT_NONE;
+    return;
+  }
+  uint8_t tx[XFER_MAX], rx[XFER_MAX];
+  tx[0] = R_RX_PAYLOAD;
+  memset(tx + 1, CMD_NOP, len);
+  transfer(tx, rx, len + 1);
+  memcpy(buf, rx + 1, len);
+  writeRegister(NRF_STATUS, _BV(RX_DR));
+}
+
+bool NrfDma::writeAckPayload(uint8_t pipe, const void* buf, uint8_t len) {
+  uint8_t tx[XFER_MAX];
+  len = min<uint8_t>(len, 32);
+  tx[0] = W_ACK_PAYLOAD | (pipe & 0x07);
+  memcpy(tx + 1, buf, len);
+  queue(OP_ACK, tx, len + 1);
+  return true;   // a full FIFO shows up in stats().ackFull
+}
+
+bool NrfDma::isFifo(bool aboutTx, bool checkEmpty) {
+  uint8_t fifo = readRegister(FIFO_STATUS);
+  if (aboutTx) fifo >>= 4;
+  return checkEmpty ? (fifo & _BV(RX_EMPTY)) : (fifo & _BV(RX_FULL));
+}
+
+uint8_t NrfDma::flush_rx() {
+  if (rxState != PKT_PENDING) rxState = PKT_NONE;
+  return command(FLUSH_RX);
+}
+
+uint8_t NrfDma::flush_tx() {
+  return command(FLUSH_TX);
+}
+
+void NrfDma::report() {
+#if NRF_DMA_REPORT_MS > 0
+  static uint32_t lastMs = 0;
+  static NrfDmaStats last = {};
+  const uint32_t now = millis();
+  if (now - lastMs < NRF_DMA_REPORT_MS) return;
+
+  const NrfDmaStats s = counters;
+  const uint32_t packets = s.packets - last.packets;
+  const uint32_t bus = s.busUs - last.busUs;
+  const uint32_t waited = s.waitedUs - last.waitedUs;
+  if (packets) {
+    logPrintf(LOG_INFO, "DMA: %lu packets, bus %lu us/packet, waited %lu, saved %lu us/packet, ack full %lu",
+              (unsigned long)packets, (unsigned long)(bus / packets), (unsigned long)(waited / packets),
+              (unsigned long)(bus > waited ? (bus - waited) / packets : 0),
+              (unsigned long)(s.ackFull - last.ackFull));
+  }
+  last = s;
+  lastMs = now;
+#endif
+}
+
+#endif // NRF_DMA
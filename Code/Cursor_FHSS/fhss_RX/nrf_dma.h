@@ -0,0 +1,117 @@
+#ifndef NRF_DMA_H
+#define NRF_DMA_H
+
+#include <Arduino.h>
+#include <RF24.h>
+#include "rf24_shadow.h"
+
+// ====== nRF24 over ESP-IDF spi_master (queued DMA) ======
+// With NRF_DMA 1 the RX radio is NrfDma instead of RF24Shadow: the same
+// RF24 methods fhss_RX.ino and ack_fifo use, but the driver owns the SPI
+// bus through spi_master and can leave transfers running while the CPU
+// does other work:
+//
+//   prefetch()           R_RX_PL_WID (2 bytes, waited for); only if its
+//                        STATUS shows a packet, queues R_RX_PAYLOAD of
+//                        that width + RX_DR clear; available()/read()
+//                        then return that packet
+//   writeAckPayload()    queued, returns at once (ack_fifo keeps at most
+//                        one payload loaded, so the FIFO can't be full)
+//
+// Finished transfers are handled by serviceOne() in the caller's task, never
+// in the SPI interrupt; every blocking call services the queue first, so
+// transactions stay in order. loop() calls prefetch() before the I2C
+// sensor reads and receiveLoop() after them: the payload read overlaps
+// the IMU transfer instead of adding to it, and an empty FIFO costs one
+// 2-byte transfer.
+//
+// Per-transaction bus time comes from the driver's pre/post callbacks;
+// "saved" is bus time of queued transfers minus the time spent waiting
+// for them. RF24 (Arduino SPI) is not used at all in this mode.
+
+#ifndef NRF_DMA
+#define NRF_DMA 0                   // 1 = spi_master вместо RF24 на RX
+#endif
+#ifndef NRF_DMA_SPI_HZ
+#define NRF_DMA_SPI_HZ 10000000
+#endif
+#ifndef NRF_DMA_QUEUE
+#define NRF_DMA_QUEUE 8             // транзакций в очереди драйвера
+#endif
+#ifndef NRF_DMA_REPORT_MS
+#define NRF_DMA_REPORT_MS 5000      // строка DMA: в лог, 0 = не выводить
+#endif
+
+struct NrfDmaStats {
+  uint32_t packets;      // received through prefetch()
+  uint32_t queued;       // asynchronous transactions
+  uint32_t blocking;     // polling transactions (configuration, FIFO checks)
+  uint32_t busUs;        // SPI time of the queued ones
+  uint32_t waitedUs;     // time spent blocked on them
+  uint32_t ackFull;      // ACK payload found the TX FIFO full
+};
+
+#if NRF_DMA
+
+class NrfDma {
+public:
+  NrfDma(uint16_t cePin, uint16_t csnPin) : ce(cePin), csn(csnPin) {}
+
+  // RF24 subset used by the RX
+  bool begin(int8_t sck = SCK, int8_t miso = MISO, int8_t mosi = MOSI);
+  bool setDataRate(rf24_datarate_e rate);
+  void setPALevel(uint8_t level, bool lnaEnable = true);
+  void setCRCLength(rf24_crclength_e length);
+  void setAutoAck(bool enable);
+  void enableDynamicPayloads();
+  void enableAckPayload();
+  void setRetries(uint8_t delay, uint8_t count);
+  void setChannel(uint8_t channel);
+  void openWritingPipe(const uint8_t* address);
+  void openReadingPipe(uint8_t pipe, const uint8_t* address);
+  void startListening();
+  void stopListening();
+  void powerDown();
+  void powerUp(uint32_t settleUs = 5000);   // 0 = caller waits (Tpd2stby)
+  bool available();
+  uint8_t getDynamicPayloadSize();
+  void read(void* buf, uint8_t len);
+  bool writeAckPayload(uint8_t pipe, const void* buf, uint8_t len);
+  bool isFifo(bool aboutTx, bool checkEmpty);
+  uint8_t flush_rx();
+  uint8_t flush_tx();
+  void sync() {}          // state is always known here (RF24Shadow API)
+  void report();          // "DMA:" log line every NRF_DMA_REPORT_MS
+
+  void prefetch();   // see above; loop() before the sensor reads
+  NrfDmaStats stats() const { return counters; }
+
+private:
+  uint16_t ce, csn;
+  uint8_t config = 0, rfSetup = 0, enRxAddr = 0, feature = 0, channel = 0xFF;
+
+  // Packet taken by prefetch()
+  enum : uint8_t { PKT_NONE, PKT_WIDTH, PKT_PENDING, PKT_READY, PKT_EMPTY };
+  uint8_t rxState = PKT_NONE;
+  uint8_t rxLen = 0;
+  uint8_t rxData[32];
+
+  NrfDmaStats counters = {};
+
+  uint8_t transfer(const uint8_t* tx, uint8_t* rx, uint8_t len);   // blocking
+  uint8_t command(uint8_t cmd);
+  uint8_t writeRegister(uint8_t reg, const uint8_t* data, uint8_t len);
+  uint8_t writeRegister(uint8_t reg, uint8_t value) { return writeRegister(reg, &value, 1); }
+  uint8_t readRegister(uint8_t reg);
+  void queue(uint8_t op, const uint8_t* tx, uint8_t len);
+  bool serviceOne(bool wait);   // handle the oldest finished transfer
+  void finish(uint8_t slot);
+  void drain() { while (serviceOne(true)) {} }
+};
+
+typedef NrfDma RadioDriver;
+#else
+typedef RF24Shadow RadioDriver;
+#endif
+
+#endif // NRF_DMA_H
@@ -1,48 +1,74 @@
-#ifndef PID_H 
+#ifndef PID_H
 #define PID_H
 
 #include <Arduino.h>
+#include "ctrl_scalar.h"
 
-struct PID {
-  float kp, ki, kd;
-  float i_min, i_max;
-  float out_min, out_max;
-  float integrator;
-  float prev_err;
+// Scalar-generic PID: PIDT<float> or PIDT<q16_t> (see ctrl_scalar.h)
+template <typename T>
+struct PIDT {
+  T kp, ki, kd;
+  T i_min, i_max;
+  T out_min, out_max;
+  T integrator;
+  T prev_err;
   bool  first;
+  T p_term, i_term, d_term; // last step, for logging
 };
 
-inline void pidInit(PID &p, float kp, float ki, float kd,
+typedef PIDT<float> PID;
+
+template <typename T>
+inline void pidInit(PIDT<T> &p, float kp, float ki, float kd,
                     float i_min, float i_max, float out_min, float out_max) {
-  p.kp = kp; p.ki = ki; p.kd = kd;
-  p.i_min = i_min; p.i_max = i_max;
-  p.out_min = out_min; p.out_max = out_max;
-  p.integrator = 0.0f;
-  p.prev_err = 0.0f;
+  p.kp = T(kp); p.ki = T(ki); p.kd = T(kd);
+  p.i_min = T(i_min); p.i_max = T(i_max);
+  p.out_min = T(out_min); p.out_max = T(out_max);
+  p.integrator = T(0);
+  p.prev_err = T(0);
   p.first = true;
+  p.p_term = p.i_term = p.d_term = T(0);
 }
 
-inline float pidStep(PID &p, float setpoint, float measurement, float dt, float d_meas = NAN) {
-  float err = setpoint - measurement;
-  float P = p.kp * err;
-  p.integrator += err * dt * p.ki;
-  if (p.integrator > p.i_max) p.integrator = p.i_max;
-  if (p.integrator < p.i_min) p.integrator = p.i_min;
-  float I = p.integrator;
-  float deriv;
-  if (!isnan(d_meas)) {
-    deriv = -d_meas;
-  } else {
-    deriv = p.first ? 0.0f : (err - p.prev_err) / max(dt, 1e-6f);
-  }
-  float D = p.kd * deriv;
+// Clear integrator and derivative history, keep gains and limits
+template <typename T>
+inline void pidReset(PIDT<T> &p) {
+  p.integrator = T(0);
+  p.prev_err = T(0);
+  p.first = true;
+  p.p_term = p.i_term = p.d_term = T(0);
+}
+
+template <typename T>
+inline T pidFinish(PIDT<T> &p, T err, T P, T D) {
   p.prev_err = err;
   p.first = false;
+  p.p_term = P; p.i_term = p.integrator; p.d_term = D;
+  return ctrlClamp(P + p.integrator + D, p.out_min, p.out_max);
+}
+
+template <typename T>
+inline T pidIntegrate(PIDT<T> &p, T err, T dt) {
+  p.integrator = ctrlClamp(p.integrator + err * dt * p.ki, p.i_min, p.i_max);
+  return p.kp * err;
+}
+
+// D on error
+template <typename T>
+inline T pidStep(PIDT<T> &p, T setpoint, T measurement, T dt) {
+  T err = setpoint - measurement;
+  T P = pidIntegrate(p, err, dt);
+  // kd first: a setpoint step / dt alone would overflow Q15.16
+  T D = p.first ? T(0) : p.kd * (err - p.prev_err) / ctrlMax(dt, ctrlEpsilon(dt));
+  return pidFinish(p, err, P, D);
+}
 
-  float out = P + I + D;
-  if (out > p.out_max) out = p.out_max;
-  if (out < p.out_min) out = p.out_min;
-  return out;
+// D on measurement: d_meas = d(measurement)/dt (gyro), no setpoint kick
+template <typename T>
+inline T pidStep(PIDT<T> &p, T setpoint, T measurement, T dt, T d_meas) {
+  T err = setpoint - measurement;
+  T P = pidIntegrate(p, err, dt);
+  return pidFinish(p, err, P, -(p.kd * d_meas));
 }
 
 #endif // PID_H
@@ -0,0 +1,69 @@
+#ifndef POWER_IDLE_H
+#define POWER_IDLE_H
+
+#include <Arduino.h>
+
+// ====== Power-aware idle while disarmed ======
+// The sketch decides when it is idle (TX: arm switch off and sticks at
+// rest, RX: disarmed and the TX sending at its idle rate) and powers the
+// nRF24 down itself; this module sleeps the ESP32 between the wake-ups the
+// sketch schedules and keeps the books for the "PWR:" report.
+//
+// powerSleepUntil() uses light sleep (timer wake-up plus any pin set with
+// powerWakeOnPin()); micros() keeps counting across it. Light sleep stops
+// USB Serial/JTAG, the console reconnects on every wake-up:
+// -DPOWER_LIGHT_SLEEP=0 waits in vTaskDelay() instead (CPU in WFI).
+//
+// There is no current sensor: the report multiplies the time spent awake,
+// asleep, with the radio on and powered down by the board's PowerModel
+// (datasheet figures), per mode. Same file in fhss_TX/ and fhss_RX/.
+
+#ifndef POWER_IDLE
+#define POWER_IDLE 1                 // 0 = всегда полная частота
+#endif
+#ifndef POWER_LIGHT_SLEEP
+#define POWER_LIGHT_SLEEP 1          // 0 = vTaskDelay вместо light sleep
+#endif
+#ifndef POWER_SLEEP_MIN_US
+#define POWER_SLEEP_MIN_US 1000      // короче не засыпать: вход/выход ~0.3 мс
+#endif
+#ifndef POWER_WAKE_LATENCY_US
+#define POWER_WAKE_LATENCY_US 400    // проснуться раньше на время выхода из сна
+#endif
+#ifndef POWER_REPORT_MS
+#define POWER_REPORT_MS 5000         // строки PWR: в лог, 0 = не выводить
+#endif
+
+// Typical currents of one board, uA
+struct PowerModel {
+  uint32_t cpuActiveUa;    // ESP32 running, radio not counted
+  uint32_t cpuSleepUa;     // light sleep
+  uint32_t radioOnUa;      // nRF24 powered up (RX / standby mix of this side)
+  uint32_t radioOffUa;     // nRF24 power-down
+  uint32_t otherUa;        // always on: regulator, LEDs, sensors, display
+};
+
+enum PowerMode : uint8_t {
+  PWR_FULL = 0,
+  PWR_IDLE,
+  PWR_MODES
+};
+
+void powerInit(const PowerModel& model);
+void powerSetMode(PowerMode mode);
+PowerMode powerMode();
+
+// Accounting only: the sketch does the SPI (RF24Shadow::powerDown/powerUp)
+void powerRadioOff(bool off);
+
+// Wake-up source besides the timer (TX arm switch); level HIGH or LOW
+void powerWakeOnPin(uint8_t pin, uint8_t level);
+
+// Sleeps until deadlineUs (micros()) if that is at least POWER_SLEEP_MIN_US
+// away; returns at once otherwise. Returns the time slept.
+uint32_t powerSleepUntil(uint32_t deadlineUs);
+
+// "PWR full: ..." / "PWR idle: ..." every POWER_REPORT_MS
+void powerReport();
+
+#endif // POWER_IDLE_H
@@ -0,0 +1,109 @@
+#include "profiler.h"
+
+#if PROFILER_ENABLED
+
+struct ProfStat {
+  uint32_t count;
+  uint32_t minCycles;
+  uint32_t maxCycles;
+  uint64_t sumCycles;
+  uint32_t hist[PROF_HIST_BINS];
+};
+
+static const char* const STAGE_NAMES[PROF_STAGE_COUNT] = {
+  "ack_telemetry", "receive", "sensors",
+  "stabilize", "mixer_write", "loop",
+};
+
+static ProfStat s_stats[PROF_STAGE_COUNT];
+static uint32_t s_cyclesPerUs = 160;
+static uint32_t s_deadlineCycles = 0;
+static uint32_t s_overruns = 0;
+static uint32_t s_lastLoopStart = 0;
+static bool s_haveLoopStart = false;
+
+void profilerReset() {
+  memset(s_stats, 0, sizeof(s_stats));
+  for (uint8_t i = 0; i < PROF_STAGE_COUNT; ++i) s_stats[i].minCycles = 0xFFFFFFFF;
+  s_overruns = 0;
+  s_haveLoopStart = false;
+}
+
+void profilerInit() {
+  s_cyclesPerUs = getCpuFrequencyMhz();
+  if (s_cyclesPerUs == 0) s_cyclesPerUs = 1;
+  s_deadlineCycles = PROFILER_DEADLINE_US * s_cyclesPerUs;
+  profilerReset();
+}
+
+void profilerRecord(uint8_t stage, uint32_t cycles) {
+  ProfStat& s = s_stats[stage];
+  s.count++;
+  s.sumCycles += cycles;
+  if (cycles < s.minCycles) s.minCycles = cycles;
+  if (cycles > s.maxCycles) s.maxCycles = cycles;
+
+  uint32_t us = cycles / s_cyclesPerUs;
+  uint8_t bin = 0;
+  if (us >= 8) {
+    bin = (uint8_t)(31 - __builtin_clz(us)) - 2;
+    if (bin >= PROF_HIST_BINS) bin = PROF_HIST_BINS - 1;
+  }
+  s.hist[bin]++;
+}
+
+void profilerLoopTick() {
+  uint32_t now = profNow();
+  if (s_haveLoopStart) {
+    uint32_t period = now - s_lastLoopStart;
+    profilerRecord(PROF_LOOP, period);
+    if (period > s_deadlineCycles) s_overruns++;
+  }
+  s_lastLoopStart = now;
+  s_haveLoopStart = true;
+}
+
+// Light sleep stops (or at least stretches) the cycle counter: an idle
+// loop's period is neither a real loop time nor an overrun
+void profilerSkipLoop() {
+  s_haveLoopStart = false;
+}
+
+uint32_t profilerMaxUs(uint8_t stage) {
+  return s_stats[stage].maxCycles / s_cyclesPerUs;
+}
+
+uint32_t profilerMeanUs(uint8_t stage) {
+  const ProfStat& s = s_stats[stage];
+  return s.count ? (uint32_t)(s.sumCycles / s.count / s_cyclesPerUs) : 0;
+}
+
+uint32_t profilerOverruns() { return s_overruns; }
+
+void profilerDump(Print& out) {
+  out.println("PROF: stage count min_us mean_us max_us | hist <8 <16 <32 <64 <128 <256 <512 <1k <2k >=2k");
+  for (uint8_t i = 0; i < PROF_STAGE_COUNT; ++i) {
+    const ProfStat& s = s_stats[i];
+    out.print("PROF: "); out.print(STAGE_NAMES[i]);
+    out.print(' '); out.print(s.count);
+    out.print(' '); out.print(s.count ? s.minCycles / s_cyclesPerUs : 0);
+    out.print(' '); out.print(profilerMeanUs(i));
+    out.print(' '); out.print(profilerMaxUs(i));
+    out.print(" |");
+    for (uint8_t b = 0; b < PROF_HIST_BINS; ++b) { out.print(' '); out.print(s.hist[b]); }
+    out.println();
+  }
+  out.print("PROF: worst_loop_us="); out.print(profilerMaxUs(PROF_LOOP));
+  out.print(" deadline_us="); out.print(PROFILER_DEADLINE_US);
+  out.print(" overruns="); out.println(s_overruns);
+}
+
+bool profilerCommand(char c, Print& out) {
+  switch (c) {
+    case 'p': profilerDump(out); return true;
+    case 'r': profilerReset(); out.println("PROF: reset"); return true;
+    default:  return false;
+  }
+}
+
+#endif // PROFILER_ENABLED
@@ -0,0 +1,70 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <Arduino.h>
+
+// ====== Per-stage cycle profiler for the RX loop ======
+// PROF_START(stage) ... PROF_STOP(stage) around a stage in one scope.
+// With PROFILER_ENABLED 0 the macros expand to nothing and the module
+// compiles out (release builds).
+
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+#ifndef PROFILER_DEADLINE_US
+#define PROFILER_DEADLINE_US 2000   // одна слот-пауза TX (500 Гц)
+#endif
+
+enum ProfStage : uint8_t {
+  PROF_ACK_TELEMETRY = 0,   // prepareAckTelemetry() целиком
+  PROF_RECEIVE,             // receiveLoop()
+  PROF_SENSORS,             // sensorHubUpdate(): все чтения I2C за цикл
+  PROF_STABILIZE,           // stabilizeMix()
+  PROF_MIXER_WRITE,         // mixerWrite()
+  PROF_LOOP,                // период loop() (от начала до начала)
+  PROF_STAGE_COUNT
+};
+
+// Histogram bins by duration: <8us, <16, <32, ... , >=2048us
+#define PROF_HIST_BINS 10
+
+#if PROFILER_ENABLED
+
+#include <esp_cpu.h>
+
+void profilerInit();
+void profilerReset();
+void profilerRecord(uint8_t stage, uint32_t cycles);
+void profilerLoopTick();            // call once at the top of loop()
+void profilerSkipLoop();            // this loop slept: no period sample at the next tick
+uint32_t profilerMaxUs(uint8_t stage);
+uint32_t profilerMeanUs(uint8_t stage);
+uint32_t profilerOverruns();        // loop periods longer than PROFILER_DEADLINE_US
+void profilerDump(Print& out);
+
+// Serial command: 'p' = dump, 'r' = reset. Returns true if handled.
+bool profilerCommand(char c, Print& out);
+
+static inline uint32_t profNow() { return esp_cpu_get_cycle_count(); }
+
+#define PROF_START(stage) const uint32_t _prof_t0_##stage = profNow()
+#define PROF_STOP(stage)  profilerRecord(stage, profNow() - _prof_t0_##stage)
+
+#else
+
+inline void profilerInit() {}
+inline void profilerReset() {}
+inline void profilerLoopTick() {}
+inline void profilerSkipLoop() {}
+inline uint32_t profilerMaxUs(uint8_t) { return 0; }
+inline uint32_t profilerMeanUs(uint8_t) { return 0; }
+inline uint32_t profilerOverruns() { return 0; }
+inline void profilerDump(Print&) {}
+inline bool profilerCommand(char, Print&) { return false; }
+
+#define PROF_START(stage) do {} while (0)
+#define PROF_STOP(stage)  do {} while (0)
+
+#endif // PROFILER_ENABLED
+
+#endif // PROFILER_H
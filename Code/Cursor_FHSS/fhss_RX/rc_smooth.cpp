@@ -0,0 +1,160 @@
+#include "rc_smooth.h"
+
+#define RC_AXES 4
+#define RC_FRAC 8                      // фильтр в 1/256 единицы стика
+
+static int16_t  s_prev[RC_AXES];       // packet before the last one
+static int16_t  s_last[RC_AXES];
+static int32_t  s_filt[RC_AXES];       // PT1 state, stick << RC_FRAC
+static uint32_t s_lastUs = 0;
+static uint32_t s_pairUs = 0;          // TX time between s_prev and s_last, 0 = no slope
+static int32_t  s_slope[RC_AXES];      // last pair, stick / us << 16
+static int32_t  s_predict[RC_AXES];    // slope the prediction uses, same units
+static uint32_t s_tauUs = 0;           // PT1 time constant
+static uint32_t s_updateUs = 0;        // last rcSmoothUpdate()
+static uint8_t  s_packetsSeen = 0;     // 0, 1, 2 = have a slope
+static uint8_t  s_longRun = 0;
+static RcSmoothStats s_stats;
+
+static inline void toAxes(const JoystickData& js, int16_t* v) {
+  v[0] = js.x_left; v[1] = js.y_left; v[2] = js.x_right; v[3] = js.y_right;
+}
+
+static inline int16_t clampStick(int32_t v) {
+  return (int16_t)(v < -1000 ? -1000 : (v > 1000 ? 1000 : v));
+}
+
+// tau = 1 / (2 pi fc), fc = interval rate * pct / 100
+static void setInterval(uint32_t us) {
+  s_stats.intervalUs = us;
+  s_tauUs = (uint32_t)((uint64_t)us * 100000u / (6283u * RC_SMOOTH_CUTOFF_PCT));
+  s_stats.cutoffHz = 1000000u * RC_SMOOTH_CUTOFF_PCT / 100u / us;
+}
+
+// Keeps the last sticks: failsafe holds the throttle from them across a resync
+void rcSmoothReset() {
+  s_pairUs = 0;
+  s_tauUs = 0;
+  s_packetsSeen = 0;
+  s_longRun = 0;
+  const RcSmoothStats zero = {};
+  s_stats = zero;
+}
+
+void rcSmoothOnPacket(const JoystickData& js, uint32_t nowUs) {
+  s_stats.packets++;
+  memcpy(s_prev, s_last, sizeof(s_prev));
+  toAxes(js, s_last);
+
+  if (s_packetsSeen == 0) {
+    // First packet: start the filter on it, no slope yet
+    for (uint8_t a = 0; a < RC_AXES; a++) s_filt[a] = (int32_t)s_last[a] * (1 << RC_FRAC);
+    s_packetsSeen = 1;
+    s_lastUs = nowUs;
+    return;
+  }
+
+  const uint32_t dt = nowUs - s_lastUs;
+  s_lastUs = nowUs;
+  if (dt == 0) return;
+  const uint32_t est = s_stats.intervalUs;
+
+  if (est == 0) {
+    setInterval(dt);
+  } else if (dt * 2 < est * 3) {
+    // On time, give or take jitter: 1/8 running average
+    setInterval((uint32_t)((int32_t)est + ((int32_t)dt - (int32_t)est) / 8));
+    s_longRun = 0;
+  } else {
+    if (dt > est * RC_SMOOTH_GAP_INTERVALS) s_stats.gaps++;
+    else s_stats.lost++;
+    // The TX went slower (idle, more aircraft): several long ones in a row
+    if (++s_longRun >= RC_SMOOTH_RESEED_PACKETS) {
+      setInterval(dt);
+      s_longRun = 0;
+      s_stats.reseeds++;
+    }
+  }
+
+  // The TX sends on a slot grid: the pair is whole intervals apart, arrival
+  // jitter (and two packets read in one loop) would only add slope noise.
+  // A slope across a gap would be a guess about the whole gap.
+  const uint32_t interval = s_stats.intervalUs;
+  const uint32_t slots = max<uint32_t>((dt + interval / 2) / interval, 1);
+  s_pairUs = slots <= RC_SMOOTH_GAP_INTERVALS ? slots * interval : 0;
+
+  // Predict only a movement seen over two pairs in a row, at the smaller
+  // of the two slopes: a stick step or a reversal is not extrapolated
+  for (uint8_t a = 0; a < RC_AXES; a++) {
+    const int32_t slope = s_pairUs ? (int32_t)(((int64_t)(s_last[a] - s_prev[a]) << 16) / s_pairUs) : 0;
+    const int32_t prev = s_packetsSeen >= 2 ? s_slope[a] : 0;
+    if ((slope > 0 && prev > 0) || (slope < 0 && prev < 0)) {
+      s_predict[a] = abs(slope) < abs(prev) ? slope : prev;
+    } else {
+      s_predict[a] = 0;
+    }
+    s_slope[a] = slope;
+  }
+  s_packetsSeen = 2;
+}
+
+#if RC_SMOOTH
+// Stick value the filter follows at nowUs
+static int32_t target(uint8_t a, uint32_t sinceUs) {
+  const int32_t last = s_last[a];
+  const uint32_t interval = s_stats.intervalUs;
+  if (s_pairUs == 0 || interval == 0 || sinceUs > interval * RC_SMOOTH_GAP_INTERVALS) return last;
+
+#if RC_SMOOTH_PREDICT
+  // Along the slope, at most one interval on, plus the PT1 lag
+  const uint32_t ahead = min<uint32_t>(sinceUs, interval) + s_tauUs;
+  return clampStick(last + (int32_t)(((int64_t)s_predict[a] * ahead) >> 16));
+#else
+  // From the previous packet to the last one over one interval
+  const uint32_t done = min<uint32_t>(sinceUs, interval);
+  return s_prev[a] + (int32_t)((int64_t)(last - s_prev[a]) * done / interval);
+#endif
+}
+#endif
+
+void rcSmoothUpdate(uint32_t nowUs, JoystickData* out) {
+  int16_t v[RC_AXES];
+  memcpy(v, s_last, sizeof(v));
+
+#if RC_SMOOTH
+  if (s_packetsSeen >= 2 && s_stats.intervalUs > 0) {
+    // A packet read later in this loop than nowUs is simply "just now"
+    const int32_t sinceRaw = (int32_t)(nowUs - s_lastUs);
+    const uint32_t since = sinceRaw > 0 ? (uint32_t)sinceRaw : 0;
+    const uint32_t dt = nowUs - s_updateUs;
+    // alpha = dt / (tau + dt), 1/65536
+    const int64_t alpha = ((int64_t)dt << 16) / ((int64_t)s_tauUs + dt + 1);
+    for (uint8_t a = 0; a < RC_AXES; a++) {
+      const int32_t x = target(a, since) * (1 << RC_FRAC);
+      s_filt[a] += (int32_t)(((int64_t)(x - s_filt[a]) * alpha) >> 16);
+      // Round to the nearest count: the filter settles exactly on x
+      v[a] = clampStick((s_filt[a] + (1 << (RC_FRAC - 1))) >> RC_FRAC);
+    }
+  }
+#endif
+  s_updateUs = nowUs;
+
+  out->x_left = v[0];
+  out->y_left = v[1];
+  out->x_right = v[2];
+  out->y_right = v[3];
+}
+
+const RcSmoothStats& rcSmoothStats() {
+  return s_stats;
+}
+
+void rcSmoothDump(Print& out) {
+  out.print("RC: interval_us="); out.print((unsigned long)s_stats.intervalUs);
+  out.print(" cutoff_hz="); out.print((unsigned long)s_stats.cutoffHz);
+  out.print(RC_SMOOTH ? (RC_SMOOTH_PREDICT ? " predict" : " interpolate") : " off");
+  out.print(" packets="); out.print((unsigned long)s_stats.packets);
+  out.print(" lost="); out.print((unsigned long)s_stats.lost);
+  out.print(" gaps="); out.print((unsigned long)s_stats.gaps);
+  out.print(" reseeds="); out.println((unsigned long)s_stats.reseeds);
+}
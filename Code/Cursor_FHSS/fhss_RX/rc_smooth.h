@@ -0,0 +1,59 @@
+#ifndef RC_SMOOTH_H
+#define RC_SMOOTH_H
+
+#include <Arduino.h>
+#include "joystick.h"
+
+// ====== RC command smoothing ======
+// Sticks arrive once per TX slot (2 ms; longer with TDMA or in idle), with
+// arrival jitter and the odd lost slot, while the loop runs faster: fed as
+// received, every packet is a step in the setpoints and a kick in the D
+// term. Each packet is timestamped on arrival and the packet interval
+// measured (running average; lost slots and gaps left out, a lasting
+// change of rate re-seeds it). At loop rate the sticks are then
+//
+//   RC_SMOOTH_PREDICT 1  extrapolated along the slope of the last two
+//                        packets, up to one interval past the last one
+//                        (no lag on a steady stick movement, a small
+//                        overshoot when it stops)
+//   RC_SMOOTH_PREDICT 0  ramped from the previous packet to the last one
+//                        over one interval (no overshoot, one interval lag)
+//
+// and passed through a PT1 whose cutoff is RC_SMOOTH_CUTOFF_PCT of the
+// measured packet rate (125 Hz at 500 packets/s). The prediction looks
+// the PT1's time constant further ahead, so a ramp comes out without its
+// lag. No packet for RC_SMOOTH_GAP_INTERVALS: the last packet as received
+// (failsafe.h takes it from there). Integer maths: the C6 has no FPU.
+
+#ifndef RC_SMOOTH
+#define RC_SMOOTH 1                    // 0 = последний пакет как есть (ступеньки)
+#endif
+#ifndef RC_SMOOTH_PREDICT
+#define RC_SMOOTH_PREDICT 1            // 1 = экстраполяция, 0 = интерполяция (+1 интервал задержки)
+#endif
+#ifndef RC_SMOOTH_CUTOFF_PCT
+#define RC_SMOOTH_CUTOFF_PCT 25        // срез PT1, % от частоты пакетов
+#endif
+#ifndef RC_SMOOTH_GAP_INTERVALS
+#define RC_SMOOTH_GAP_INTERVALS 3      // дольше без пакета — держать последний
+#endif
+#ifndef RC_SMOOTH_RESEED_PACKETS
+#define RC_SMOOTH_RESEED_PACKETS 4     // столько длинных интервалов подряд — новая частота
+#endif
+
+struct RcSmoothStats {
+  uint32_t intervalUs;   // measured packet interval, 0 = not yet
+  uint32_t cutoffHz;     // PT1 cutoff now
+  uint32_t packets;
+  uint32_t lost;         // intervals of 1.5..RC_SMOOTH_GAP_INTERVALS: lost slots
+  uint32_t gaps;         // longer: output held
+  uint32_t reseeds;      // packet rate changed (TX idle / full rate, TDMA)
+};
+
+void rcSmoothReset();                                     // re-measure the rate (resync)
+void rcSmoothOnPacket(const JoystickData& js, uint32_t nowUs);
+void rcSmoothUpdate(uint32_t nowUs, JoystickData* out);   // once per loop
+const RcSmoothStats& rcSmoothStats();
+void rcSmoothDump(Print& out);                            // "RC: ..." line
+
+#endif // RC_SMOOTH_H
@@ -0,0 +1,95 @@
+#ifndef RF24_SHADOW_H
+#define RF24_SHADOW_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <RF24.h>
+#include <nRF24L01.h>
+
+// ====== RF24 with shadowed registers ======
+// Drop-in for RF24 (same file in fhss_TX/ and fhss_RX/). After sync() it
+// keeps a copy of RF_CH, CONFIG, RF_SETUP, EN_RXADDR and the pipe
+// addresses and skips calls that would write what is already there:
+// setChannel() to the current channel, startListening() while listening,
+// openWritingPipe() to the same address, ...
+//
+// Mode changes are done here in as few transactions as the state allows:
+// RF24 1.4 spends 4 per stopListening() (flush, CONFIG, read-modify-write
+// of EN_RXADDR) plus a txDelay busy wait, and 4 per startListening();
+// with the registers known it is one CONFIG and one EN_RXADDR write, and
+// STATUS is cleared only when the status byte that comes back shows a
+// flag. Pipe 0 stays the writing pipe (closed while listening, as in RF24).
+// stopListening() keeps RF24's FLUSH_TX unless the side says its TX FIFO
+// is empty by then (keepTxFifo): the RX leaves an ACK payload loaded
+// (ack_fifo), which would otherwise go out as the next packet.
+//
+// Calls made through a plain RF24& (rf_survey, ack_fifo) are not seen:
+// forgetChannel() after a retune there, sync() after any other register
+// change (setCRCLength, setRetries, ...). powerUp()/powerDown() must go
+// through this class, RF24's own copy of CONFIG is stale after a mode
+// change here. powerUp() while listening sets CE again: the radio goes back
+// to RX by itself once the oscillator is up.
+
+#ifndef RF24_SHADOW_SPI_HZ
+#define RF24_SHADOW_SPI_HZ 10000000   // = RF24_SPI_SPEED
+#endif
+#ifndef RF24_SHADOW_COUNT
+#define RF24_SHADOW_COUNT 0           // 1: счёт всех транзакций, прерывание на каждый спад CSN
+#endif
+#ifndef RF24_SHADOW_REPORT_MS
+#define RF24_SHADOW_REPORT_MS 5000    // строка RF: в лог, 0 = не выводить
+#endif
+
+struct RF24ShadowStats {
+  uint32_t spi;        // all transactions, RF24 included (CSN falling edges); RF24_SHADOW_COUNT 1
+  uint32_t own;        // issued by RF24Shadow
+  uint32_t elided;     // calls skipped entirely
+  uint32_t saved;      // RF24 transactions avoided (skipped calls + cheaper mode changes)
+};
+
+class RF24Shadow : public RF24 {
+public:
+  // keepTxFifo: stopListening() skips FLUSH_TX. Only for a side that never
+  // has a payload queued while listening (TX: write() leaves the FIFO empty)
+  RF24Shadow(uint16_t cePin, uint16_t csnPin, bool keepTxFifo = false)
+      : RF24(cePin, csnPin), ce(cePin), csn(csnPin), keepTxFifo(keepTxFifo) {}
+
+  // Reads the shadowed registers; after begin() and the configuration.
+  // Until then every call goes straight to RF24.
+  void sync();
+  void forgetChannel() { channelKnown = false; }
+
+  void setChannel(uint8_t channel);
+  void startListening();
+  void stopListening();
+  void powerUp(uint32_t settleUs = 5000);   // = RF24_POWERUP_DELAY; 0 = caller waits (Tpd2stby)
+  void powerDown();
+  void openWritingPipe(const uint8_t* address);
+  void openReadingPipe(uint8_t pipe, const uint8_t* address);
+  bool setDataRate(rf24_datarate_e rate);
+  void setPALevel(uint8_t level, bool lnaEnable = true);
+
+  bool isListening() const { return valid && (config & _BV(PRIM_RX)); }
+  RF24ShadowStats stats() const;
+  void report();   // "RF:" log line every RF24_SHADOW_REPORT_MS
+
+private:
+  uint16_t ce, csn;
+  bool keepTxFifo;
+  bool valid = false;
+  bool channelKnown = false;
+  uint8_t channel = 0;
+  uint8_t config = 0;
+  uint8_t rfSetup = 0;
+  uint8_t enRxAddr = 0;
+  uint8_t txAddr[5] = {};
+  uint8_t rxAddr[6][5] = {};   // pipes 2..5: only byte 0 is their own
+  RF24ShadowStats counters = {};
+
+  uint8_t writeRegister(uint8_t reg, uint8_t value);
+  void command(uint8_t cmd);
+  void readRegister(uint8_t reg, uint8_t* buf, uint8_t len);
+  uint8_t writeConfig(uint8_t value);
+};
+
+#endif // RF24_SHADOW_H
@@ -0,0 +1,84 @@
+#include "sensor_hub.h"
+#include <atomic>
+
+static SensorSnapshot s_snap;
+static std::atomic<uint32_t> s_seq(0);   // нечётное = идёт запись
+static SensorHubStats s_stats;
+static bool s_baroDue = true;
+static bool s_tofDue = true;
+static uint32_t s_lastBaroUs = 0;
+static uint32_t s_lastTofUs = 0;
+
+void sensorHubInit() {
+  memset(&s_snap, 0, sizeof(s_snap));
+  s_snap.data.range_mm = -1;
+  memset(&s_stats, 0, sizeof(s_stats));
+  s_seq.store(0, std::memory_order_relaxed);
+  s_baroDue = s_tofDue = true;
+}
+
+void sensorHubUpdate(uint32_t nowUs) {
+  // Only this function writes s_snap, so reading it here needs no lock
+  SensorSnapshot next = s_snap;
+  bool changed = false;
+
+  if (SENSOR_IMU_PERIOD_US == 0 || nowUs - next.imuUs >= SENSOR_IMU_PERIOD_US) {
+    readImuSample(&next.data);
+    next.imuUs = nowUs;
+    s_stats.imuReads++;
+    changed = true;
+  }
+  if (s_baroDue || nowUs - s_lastBaroUs >= SENSOR_BARO_PERIOD_MS * 1000UL) {
+    next.data.pressure = readBaroHpa();
+    next.baroUs = s_lastBaroUs = nowUs;
+    s_baroDue = false;
+    s_stats.baroReads++;
+    changed = true;
+  }
+  if (s_tofDue || nowUs - s_lastTofUs >= SENSOR_TOF_POLL_MS * 1000UL) {
+    int16_t mm = pollTofRange();
+    s_lastTofUs = nowUs;
+    s_tofDue = false;
+    s_stats.tofPolls++;
+    if (mm != next.data.range_mm) {
+      next.data.range_mm = mm;
+      next.tofUs = nowUs;
+      changed = true;
+    }
+  }
+  if (!changed) return;
+
+  const uint32_t seq = s_seq.load(std::memory_order_relaxed);
+  s_seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  s_snap = next;
+  s_seq.store(seq + 2, std::memory_order_release);
+}
+
+uint32_t sensorHubRead(SensorSnapshot* out) {
+  for (;;) {
+    const uint32_t before = s_seq.load(std::memory_order_acquire);
+    if (!(before & 1u)) {
+      *out = s_snap;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (s_seq.load(std::memory_order_relaxed) == before) return before;
+    }
+    s_stats.readRetries++;
+  }
+}
+
+uint32_t sensorHubVersion() {
+  return s_seq.load(std::memory_order_acquire) & ~1u;
+}
+
+SensorHubStats sensorHubStats() {
+  return s_stats;
+}
+
+void sensorHubDump(Print& out) {
+  out.print("SENS: version="); out.print(sensorHubVersion());
+  out.print(" imu="); out.print(s_stats.imuReads);
+  out.print(" baro="); out.print(s_stats.baroReads);
+  out.print(" tof_polls="); out.print(s_stats.tofPolls);
+  out.print(" retries="); out.println(s_stats.readRetries);
+}
@@ -0,0 +1,52 @@
+#ifndef SENSOR_HUB_H
+#define SENSOR_HUB_H
+
+#include <Arduino.h>
+#include "telemetry.h"
+
+// ====== Sensor hub: one I2C read per device per period ======
+// sensorHubUpdate() (once per loop) samples only the devices that are due
+// and publishes the result as a versioned snapshot under a seqlock.
+// Control, ACK telemetry and blackbox all read that snapshot: nobody
+// touches the bus twice for the same data and all consumers of one
+// version see the same sample. Readers never block the writer; a reader
+// racing with a publish just copies again.
+
+#ifndef SENSOR_IMU_PERIOD_US
+#define SENSOR_IMU_PERIOD_US 0      // 0 = каждый цикл: контуру нужен свежий гироскоп
+#endif
+#ifndef SENSOR_BARO_PERIOD_MS
+#define SENSOR_BARO_PERIOD_MS 20    // BMP280 в normal mode всё равно обновляется реже
+#endif
+#ifndef SENSOR_TOF_POLL_MS
+#define SENSOR_TOF_POLL_MS 10       // опрос готовности VL53L0X (TOF_PERIOD_MS 33)
+#endif
+
+struct SensorSnapshot {
+  TelemetryData data;
+  uint32_t imuUs;       // micros() of the last sample per device
+  uint32_t baroUs;
+  uint32_t tofUs;
+};
+
+struct SensorHubStats {
+  uint32_t imuReads;
+  uint32_t baroReads;
+  uint32_t tofPolls;
+  uint32_t readRetries;  // reader overlapped a publish and copied again
+};
+
+void sensorHubInit();
+
+// Single writer: call from loop() only
+void sensorHubUpdate(uint32_t nowUs);
+
+// Consistent copy of the latest snapshot; returns its version
+// (even, grows by 2 per publish; 0 = nothing published yet)
+uint32_t sensorHubRead(SensorSnapshot* out);
+uint32_t sensorHubVersion();
+
+SensorHubStats sensorHubStats();
+void sensorHubDump(Print& out);   // one "SENS:" line, printed by the 'd' command
+
+#endif // SENSOR_HUB_H
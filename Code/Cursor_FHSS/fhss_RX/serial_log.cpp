@@ -0,0 +1,212 @@
+#include "serial_log.h"
+
+#if LOG_ENABLED
+
+#include <atomic>
+#include <stdarg.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static_assert((LOG_RING_SIZE & (LOG_RING_SIZE - 1)) == 0, "LOG_RING_SIZE must be a power of two");
+static_assert(LOG_MAX_RECORD <= 255 - 2, "record length is one byte");
+
+// Record: [len][more << 7 | type << 2 | level][len bytes]
+static const uint8_t HEADER = 2;
+static const uint8_t REC_MORE = 0x80;   // text line goes on in the next record
+static const char* const LEVEL_PREFIX[] = { "E: ", "W: ", "", "D: " };
+
+static uint8_t s_ring[LOG_RING_SIZE];
+static std::atomic<uint32_t> s_head(0);   // пишет только loop()
+static std::atomic<uint32_t> s_tail(0);   // только задача вывода
+static std::atomic<uint32_t> s_dropped(0);
+static uint32_t s_written = 0;
+static uint32_t s_suppressed = 0;
+static uint16_t s_highWater = 0;
+static LogLevel s_level = LOG_LEVEL;
+static uint32_t s_rateLast[LOG_RATE_SLOTS];
+static LogFormatter s_formatters[LOG_RECORD_TYPES];
+static LogWireWriter s_wire = nullptr;
+static Print* s_out = nullptr;
+static std::atomic<bool> s_hold(false);
+static std::atomic<bool> s_parked(false);   // drain task saw s_hold, off the port
+
+static void ringWrite(uint32_t pos, const uint8_t* src, uint32_t n) {
+  uint32_t at = pos & (LOG_RING_SIZE - 1);
+  uint32_t first = min<uint32_t>(n, LOG_RING_SIZE - at);
+  memcpy(&s_ring[at], src, first);
+  memcpy(&s_ring[0], src + first, n - first);
+}
+
+static void ringRead(uint32_t pos, uint8_t* dst, uint32_t n) {
+  uint32_t at = pos & (LOG_RING_SIZE - 1);
+  uint32_t first = min<uint32_t>(n, LOG_RING_SIZE - at);
+  memcpy(dst, &s_ring[at], first);
+  memcpy(dst + first, &s_ring[0], n - first);
+}
+
+static bool pushRecord(uint8_t type, LogLevel level, uint8_t flags, const void* data, uint8_t len) {
+  if (len > LOG_MAX_RECORD) len = LOG_MAX_RECORD;
+
+  const uint32_t head = s_head.load(std::memory_order_relaxed);
+  const uint32_t used = head - s_tail.load(std::memory_order_acquire);
+  if (used + HEADER + len > LOG_RING_SIZE) {
+    s_dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  const uint8_t hdr[HEADER] = { len, (uint8_t)(flags | (type << 2) | level) };
+  ringWrite(head, hdr, HEADER);
+  ringWrite(head + HEADER, (const uint8_t*)data, len);
+  s_head.store(head + HEADER + len, std::memory_order_release);
+
+  s_written++;
+  if (used + HEADER + len > s_highWater) s_highWater = (uint16_t)(used + HEADER + len);
+  return true;
+}
+
+bool logRecord(uint8_t type, LogLevel level, const void* data, uint8_t len) {
+  if (level > s_level || type >= LOG_RECORD_TYPES) { s_suppressed++; return false; }
+  return pushRecord(type, level, 0, data, len);
+}
+
+bool logText(LogLevel level, const char* text) {
+  return logRecord(LOG_REC_TEXT, level, text, (uint8_t)min<size_t>(strlen(text), LOG_MAX_RECORD));
+}
+
+bool logPrintf(LogLevel level, const char* fmt, ...) {
+  if (level > s_level) { s_suppressed++; return false; }
+  char buf[LOG_MAX_RECORD + 1];
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  if (n < 0) return false;
+  return logRecord(LOG_REC_TEXT, level, buf, (uint8_t)min<int>(n, LOG_MAX_RECORD));
+}
+
+bool logRateOk(uint8_t slot, uint16_t minMs) {
+  if (slot >= LOG_RATE_SLOTS) return true;
+  uint32_t now = millis();
+  if (now - s_rateLast[slot] < minMs) { s_suppressed++; return false; }
+  s_rateLast[slot] = now;
+  return true;
+}
+
+void logSetFormatter(uint8_t type, LogFormatter fmt) {
+  if (type > LOG_REC_TEXT && type < LOG_RECORD_TYPES) s_formatters[type] = fmt;
+}
+
+void logSetLevel(LogLevel level) { s_level = level; }
+
+void logSetWire(LogWireWriter wire) { s_wire = wire; }
+
+LogStats logStats() {
+  LogStats s;
+  s.written = s_written;
+  s.dropped = s_dropped.load(std::memory_order_relaxed);
+  s.suppressed = s_suppressed;
+  s.highWater = s_highWater;
+  return s;
+}
+
+bool logCommand(char c, Print& out) {
+  if (c != 'l') return false;
+  LogStats s = logStats();
+  out.print("LOG: written="); out.print(s.written);
+  out.print(" dropped="); out.print(s.dropped);
+  out.print(" suppressed="); out.print(s.suppressed);
+  out.print(" high="); out.print(s.highWater);
+  out.print("/"); out.println(LOG_RING_SIZE);
+  return true;
+}
+
+// ===== LogPrint =====
+
+void LogPrint::_push(bool more) {
+  if (_level > s_level) s_suppressed++;
+  else pushRecord(LOG_REC_TEXT, _level, more ? REC_MORE : 0, _line, _len);
+  _len = 0;
+}
+
+size_t LogPrint::write(uint8_t c) {
+  if (c == '\r') return 1;
+  if (c == '\n') {
+    _push(false);
+    return 1;
+  }
+  _line[_len++] = (char)c;
+  if (_len == sizeof(_line)) _push(true);
+  return 1;
+}
+
+void logHold(bool hold, uint32_t timeoutMs) {
+  if (!s_out) return;   // до logInit() порт и так свободен
+  if (!hold) {
+    s_hold.store(false, std::memory_order_release);
+    return;
+  }
+  const uint32_t start = millis();
+  while (s_tail.load(std::memory_order_acquire) != s_head.load(std::memory_order_relaxed) &&
+         millis() - start < timeoutMs) {
+    vTaskDelay(1);
+  }
+  s_hold.store(true, std::memory_order_release);
+  while (!s_parked.load(std::memory_order_acquire) && millis() - start < timeoutMs) vTaskDelay(1);
+}
+
+// ===== Drain task =====
+
+static void emit(uint8_t type, uint8_t level, uint8_t flags, const uint8_t* data, uint8_t len) {
+  static bool midLine = false;   // previous text record had REC_MORE
+  Print& out = *s_out;
+  if (s_wire) { s_wire(out, type, level, data, len); return; }
+  if (midLine && type != LOG_REC_TEXT) { out.println(); midLine = false; }
+  if (level <= LOG_DEBUG && !midLine) out.print(LEVEL_PREFIX[level]);
+  if (type == LOG_REC_TEXT) {
+    out.write(data, len);
+    midLine = flags & REC_MORE;
+    if (!midLine) out.println();
+  } else if (s_formatters[type]) {
+    s_formatters[type](out, data, len);
+  }
+}
+
+static void drainTask(void*) {
+  uint8_t buf[LOG_MAX_RECORD];
+  uint32_t reportedDrops = 0;
+  uint32_t lastReport = 0;
+  for (;;) {
+    if (s_hold.load(std::memory_order_acquire)) {
+      s_parked.store(true, std::memory_order_release);
+      vTaskDelay(1);
+      continue;
+    }
+    s_parked.store(false, std::memory_order_release);
+
+    const uint32_t tail = s_tail.load(std::memory_order_relaxed);
+    if (tail == s_head.load(std::memory_order_acquire)) {
+      uint32_t drops = s_dropped.load(std::memory_order_relaxed);
+      if (drops != reportedDrops && millis() - lastReport >= LOG_DROP_REPORT_MS) {
+        int n = snprintf((char*)buf, sizeof(buf), "LOG: dropped %lu total %lu",
+                         (unsigned long)(drops - reportedDrops), (unsigned long)drops);
+        emit(LOG_REC_TEXT, LOG_INFO, 0, buf, (uint8_t)min<int>(n, sizeof(buf)));
+        reportedDrops = drops;
+        lastReport = millis();
+      }
+      vTaskDelay(1);
+      continue;
+    }
+    uint8_t hdr[HEADER];
+    ringRead(tail, hdr, HEADER);
+    ringRead(tail + HEADER, buf, hdr[0]);
+    // Освобождаем место до вывода: UART может ждать, loop() — нет
+    s_tail.store(tail + HEADER + hdr[0], std::memory_order_release);
+    emit((hdr[1] & ~REC_MORE) >> 2, hdr[1] & 0x03, hdr[1] & REC_MORE, buf, hdr[0]);
+  }
+}
+
+void logInit(Print& out) {
+  s_out = &out;
+  xTaskCreate(drainTask, "serial_log", LOG_TASK_STACK, nullptr, LOG_TASK_PRIORITY, nullptr);
+}
+
+#endif // LOG_ENABLED
@@ -1,10 +1,14 @@
 
 #include "stabilizer.h"
 #include "mixer.h"
+#include "autotune.h"
 
-static PID pid_roll;
-static PID pid_pitch;
-static PID pid_yaw_rate;
+static PIDT<ctrl_t> pid_roll;
+static PIDT<ctrl_t> pid_pitch;
+static PIDT<ctrl_t> pid_yaw_rate;
+static PID pid_alt;         // height error (m) -> climb setpoint (m/s)
+static PID pid_climb;       // climb error (m/s) -> throttle PWM around hover
+static StabilizerDebug s_dbg;
 
 // Arming / safety
 static bool s_armed = false;
@@ -14,6 +18,20 @@ static const int16_t STICK_MIN = -900;       // низкий газ
 static const int16_t STICK_EDGE =  900;      // край по рысканию
 static const uint8_t IDLE_PWM = 0;           // 0 => моторы стоят до реального газа
 static const bool THROTTLE_REVERSED = true;  // true = верх стика -> 0, низ -> 255 (инвертируем обратно)
+static const bool AIRMODE = true;            // сдвигать общий газ, чтобы сохранить коррекцию по крену/тангажу
+
+// Altitude hold
+#ifndef ALTHOLD_DEFAULT
+#define ALTHOLD_DEFAULT false
+#endif
+static const float ALTHOLD_DEADBAND_PWM = 15.0f;  // газ ± от точки включения = держать высоту
+static const float ALTHOLD_MAX_CLIMB = 1.0f;      // м/с на краю стика
+static const float ALTHOLD_MIN_TILT_COS = 0.7f;   // компенсация наклона не больше 1/0.7
+static bool  s_altHoldReq = ALTHOLD_DEFAULT;
+static bool  s_altHoldActive = false;
+static float s_altHoldCenter = 0.0f;  // throttle_pwm при включении (≈ газ висения)
+static float s_altHoldTarget = 0.0f;
+static float s_descentRate = 0.0f;    // failsafe, м/с (0 = выкл.)
 
 
 // ===== Sign conventions (поставь -1 где надо развернуть) =====
@@ -21,9 +39,9 @@ static const int ROLL_SIGN  = +1;
 static const int PITCH_SIGN = -1;  // <-- ДЛЯ ТЕБЯ: перевёрнут вперёд => ставим -1
 static const int YAW_SIGN   = +1;
 
-// Helper
-static inline float mapf(float x, float in_min, float in_max, float out_min, float out_max) {
-  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+// Helper: stick -1000..1000 -> ±limit (линейно, без деления в цикле)
+static inline ctrl_t stickToSetpoint(int16_t v, float limit) {
+  return ctrl_t((int)v) * ctrl_t(limit / 1000.0f);
 }
 
 // Deadband
@@ -52,11 +70,70 @@ static inline uint8_t throttleToPwm(int16_t y_left) {
 
 void stabilizerInit() {
   attitudeInit(0.98f);
-  pidInit(pid_roll,  3.0f, 0.0f, 0.08f, -50.0f, 50.0f, -200.0f, 200.0f);
-  pidInit(pid_pitch, 3.0f, 0.0f, 0.08f, -50.0f, 50.0f, -200.0f, 200.0f);
+  // Gyro в deg/s (attitude.cpp): D по гироскопу и угловая скорость рыскания
+  // в тех же единицах, что уставки. Крен/тангаж подобраны по host/sim
+  // (hover/gust/althold/autotune); рыскание 1.2/0.02 — лучшее там же.
+  pidInit(pid_roll,  2.0f, 0.0f, 0.16f, -50.0f, 50.0f, -200.0f, 200.0f);
+  pidInit(pid_pitch, 2.0f, 0.0f, 0.16f, -50.0f, 50.0f, -200.0f, 200.0f);
   pidInit(pid_yaw_rate, 1.2f, 0.0f, 0.02f, -50.0f, 50.0f, -200.0f, 200.0f);
+  pidInit(pid_alt,   1.5f, 0.0f, 0.0f, 0.0f, 0.0f, -ALTHOLD_MAX_CLIMB, ALTHOLD_MAX_CLIMB);
+  pidInit(pid_climb, 40.0f, 25.0f, 0.0f, -60.0f, 60.0f, -100.0f, 100.0f);
+  altitudeInit();
+  s_altHoldActive = false;
+  s_descentRate = 0.0f;
   s_armed = false;
   s_holdStartMs = 0;
+  memset(&s_dbg, 0, sizeof(s_dbg));
+  autotuneInit();
+}
+
+const StabilizerDebug& stabilizerDebug() { return s_dbg; }
+
+static PIDT<ctrl_t>* pidForAxis(uint8_t axis) {
+  switch (axis) {
+    case 0:  return &pid_roll;
+    case 1:  return &pid_pitch;
+    default: return &pid_yaw_rate;
+  }
+}
+
+void stabilizerSetAltHold(bool on) { s_altHoldReq = on; }
+bool stabilizerAltHold() { return s_altHoldReq; }
+
+void stabilizerSetDescent(float rate) { s_descentRate = max(rate, 0.0f); }
+void stabilizerDisarm() { s_armed = false; }
+
+void stabilizerGetGains(uint8_t axis, float* kp, float* ki, float* kd) {
+  const PIDT<ctrl_t>* p = pidForAxis(axis);
+  *kp = ctrlToFloat(p->kp); *ki = ctrlToFloat(p->ki); *kd = ctrlToFloat(p->kd);
+}
+
+void stabilizerSetGains(uint8_t axis, float kp, float ki, float kd) {
+  PIDT<ctrl_t>* p = pidForAxis(axis);
+  pidInit(*p, kp, ki, kd, ctrlToFloat(p->i_min), ctrlToFloat(p->i_max),
+          ctrlToFloat(p->out_min), ctrlToFloat(p->out_max));
+}
+
+static void captureDebug(const Attitude& att, const VerticalState& vs,
+                         ctrl_t sp_roll, ctrl_t sp_pitch, ctrl_t sp_yaw_rate,
+                         const uint8_t* motors, uint8_t mixFlags) {
+  const PIDT<ctrl_t>* pids[3] = { &pid_roll, &pid_pitch, &pid_yaw_rate };
+  s_dbg.att = att;
+  s_dbg.sp_roll = ctrlToFloat(sp_roll);
+  s_dbg.sp_pitch = ctrlToFloat(sp_pitch);
+  s_dbg.sp_yaw_rate = ctrlToFloat(sp_yaw_rate);
+  for (uint8_t k = 0; k < 3; ++k) {
+    s_dbg.p[k] = ctrlToFloat(pids[k]->p_term);
+    s_dbg.i[k] = ctrlToFloat(pids[k]->i_term);
+    s_dbg.d[k] = ctrlToFloat(pids[k]->d_term);
+  }
+  s_dbg.motorCount = mixerMotorCount();
+  memcpy(s_dbg.motors, motors, s_dbg.motorCount);
+  s_dbg.mixFlags = mixFlags;
+  s_dbg.armed = s_armed;
+  s_dbg.vert = vs;
+  s_dbg.altHold = s_altHoldActive;
+  if (!s_altHoldActive) s_dbg.sp_height = s_dbg.sp_climb = 0.0f;
 }
 
 // Handle arm/disarm stick combos (hold STICK_ARM_HOLD ms)
@@ -71,7 +148,10 @@ static void updateArming(const JoystickData& js) {
 
   if (armCombo) {
     if (!lastArmState) { s_holdStartMs = now; }
-    if (now - s_holdStartMs >= (uint32_t)STICK_ARM_HOLD) s_armed = true;
+    if (now - s_holdStartMs >= (uint32_t)STICK_ARM_HOLD) {
+      if (!s_armed) altitudeReset();   // высота от точки взлёта
+      s_armed = true;
+    }
     lastArmState = true;
   } else {
     lastArmState = false;
@@ -87,7 +167,7 @@ static void updateArming(const JoystickData& js) {
 }
 
 void stabilizeMix(const JoystickData& js_raw, const TelemetryData& sens, float dt,
-                  uint8_t* m1, uint8_t* m2, uint8_t* m3, uint8_t* m4)
+                  uint8_t* motors)
 {
   // 0) RC preprocessing
   JoystickData js = js_raw;
@@ -99,45 +179,99 @@ void stabilizeMix(const JoystickData& js_raw, const TelemetryData& sens, float d
   // 1) Update arming state
   updateArming(js);
 
-  // 2) Attitude estimation
-  Attitude att;
-  attitudeUpdate(sens, dt, &att);
+  // 2) Attitude estimation (ctrl_t), float copy for altitude / debug
+  const ctrl_t cdt = ctrl_t(dt);
+  CtrlAttitude att;
+  attitudeUpdate(sens, cdt, &att);
+  const Attitude attF = attitudeToFloat(att);
+  VerticalState vs;
+  altitudeUpdate(sens, attF, dt, &vs);
 
   // Throttle
   uint8_t throttle_pwm = throttleToPwm(js.y_left);
 
   // Safety: if not armed OR throttle stick is near bottom => motors off, reset PIDs
   if (!s_armed || js.y_left <= (STICK_MIN + 50)) {
-    pidInit(pid_roll,  pid_roll.kp,  pid_roll.ki,  pid_roll.kd,  pid_roll.i_min,  pid_roll.i_max,  pid_roll.out_min,  pid_roll.out_max);
-    pidInit(pid_pitch, pid_pitch.kp, pid_pitch.ki, pid_pitch.kd, pid_pitch.i_min, pid_pitch.i_max, pid_pitch.out_min, pid_pitch.out_max);
-    pidInit(pid_yaw_rate, pid_yaw_rate.kp, pid_yaw_rate.ki, pid_yaw_rate.kd, pid_yaw_rate.i_min, pid_yaw_rate.i_max, pid_yaw_rate.out_min, pid_yaw_rate.out_max);
+    pidReset(pid_roll);
+    pidReset(pid_pitch);
+    pidReset(pid_yaw_rate);
 
-    *m1 = *m2 = *m3 = *m4 = 0; // полностью остановить
+    autotuneMotorsOff();
+    s_altHoldActive = false;
+    memset(motors, 0, mixerMotorCount()); // полностью остановить
+    captureDebug(attF, vs, ctrl_t(0), ctrl_t(0), ctrl_t(0), motors, 0);
     return;
   }
 
+  // 2b) Altitude hold: throttle stick -> climb rate, climb PID -> throttle
+  //     (failsafe descent: same loop, fixed sink rate instead of the stick)
+  if (s_altHoldReq || s_descentRate > 0.0f) {
+    float stick = (float)throttle_pwm;
+    if (!s_altHoldActive) {
+      s_altHoldActive = true;
+      s_altHoldCenter = stick;
+      s_altHoldTarget = vs.height;
+      pidReset(pid_alt);
+      pidReset(pid_climb);
+    }
+    float dev = stick - s_altHoldCenter;
+    float sp_climb;
+    if (s_descentRate > 0.0f) {
+      sp_climb = -s_descentRate;
+      s_altHoldTarget = vs.height;
+    } else if (fabsf(dev) <= ALTHOLD_DEADBAND_PWM) {
+      sp_climb = pidStep(pid_alt, s_altHoldTarget, vs.height, dt);
+    } else {
+      // Ход стика до края, не считая зоны отсечки моторов
+      float lo = min(throttleToPwm(STICK_MIN + 51), throttleToPwm(1000));
+      float hi = max(throttleToPwm(STICK_MIN + 51), throttleToPwm(1000));
+      float span = (dev > 0.0f ? hi - s_altHoldCenter : s_altHoldCenter - lo) - ALTHOLD_DEADBAND_PWM;
+      float f = min((fabsf(dev) - ALTHOLD_DEADBAND_PWM) / max(span, 1.0f), 1.0f);
+      sp_climb = (dev > 0.0f ? f : -f) * ALTHOLD_MAX_CLIMB;
+      s_altHoldTarget = vs.height;   // держим высоту, где стик вернули в центр
+    }
+    float thr = (s_altHoldCenter + pidStep(pid_climb, sp_climb, vs.climb, dt))
+              / max(vs.tiltCos, ALTHOLD_MIN_TILT_COS);
+    throttle_pwm = (uint8_t)constrain(thr, 0.0f, 255.0f);
+    s_dbg.sp_height = s_altHoldTarget;
+    s_dbg.sp_climb = sp_climb;
+  } else {
+    s_altHoldActive = false;
+  }
+
   // 3) Setpoints (deg / deg/s)
-float sp_roll      = mapf((float)js.x_right, -1000.0f, 1000.0f, -25.0f, 25.0f);
-float sp_pitch     = mapf((float)js.y_right, -1000.0f, 1000.0f, -25.0f, 25.0f);
-float sp_yaw_rate  = mapf((float)js.x_left,  -1000.0f, 1000.0f, -150.0f, 150.0f);
-
-// 4) Controllers (с учётом знаков и масштабирования газом)
-float throttle_scale = 0.6f + 0.4f * (throttle_pwm / 255.0f);
-float u_roll  = throttle_scale * pidStep(pid_roll,   sp_roll,               ROLL_SIGN  * att.roll,  dt, ROLL_SIGN  * att.gx);
-float u_pitch = throttle_scale * pidStep(pid_pitch,  sp_pitch,              PITCH_SIGN * att.pitch, dt, PITCH_SIGN * att.gy);
-float u_yaw   = throttle_scale * pidStep(pid_yaw_rate, sp_yaw_rate,         YAW_SIGN   * att.gz,    dt);
-
-
-  // 5) Mixer (X)
-  float base = (float)max<uint8_t>(throttle_pwm, IDLE_PWM);
-  float m1f = base + u_roll + u_pitch - u_yaw; // Front Left
-  float m2f = base - u_roll + u_pitch + u_yaw; // Front Right
-  float m3f = base - u_roll - u_pitch - u_yaw; // Rear Right
-  float m4f = base + u_roll - u_pitch + u_yaw; // Rear Left
-
-  auto sat = [](float v){ if (v < 0) v = 0; if (v > 255) v = 255; return (uint8_t)(v + 0.5f); };
-  *m1 = sat(m1f);
-  *m2 = sat(m2f);
-  *m3 = sat(m3f);
-  *m4 = sat(m4f);
+  const ctrl_t sp_roll     = stickToSetpoint(js.x_right, 25.0f);
+  const ctrl_t sp_pitch    = stickToSetpoint(js.y_right, 25.0f);
+  const ctrl_t sp_yaw_rate = stickToSetpoint(js.x_left, 150.0f);
+
+  // 4) Controllers (с учётом знаков и масштабирования газом)
+  const ctrl_t throttle_scale = ctrl_t(0.6f) + ctrl_t((int)throttle_pwm) * ctrl_t(0.4f / 255.0f);
+  const ctrl_t roll  = ROLL_SIGN  > 0 ? att.roll  : -att.roll;
+  const ctrl_t pitch = PITCH_SIGN > 0 ? att.pitch : -att.pitch;
+  const ctrl_t rollRate  = ROLL_SIGN  > 0 ? att.gx : -att.gx;
+  const ctrl_t pitchRate = PITCH_SIGN > 0 ? att.gy : -att.gy;
+  const ctrl_t yawRate   = YAW_SIGN   > 0 ? att.gz : -att.gz;
+  ctrl_t u_roll  = throttle_scale * pidStep(pid_roll,     sp_roll,     roll,    cdt, rollRate);
+  ctrl_t u_pitch = throttle_scale * pidStep(pid_pitch,    sp_pitch,    pitch,   cdt, pitchRate);
+  ctrl_t u_yaw   = throttle_scale * pidStep(pid_yaw_rate, sp_yaw_rate, yawRate, cdt);
+
+  // Autotune: relay replaces the PID output of one axis while sticks are centred
+  // (float: only runs during a tuning flight)
+  if (autotuneState() != AT_IDLE) {
+    bool engaged = (js.x_left == 0 && js.x_right == 0 && js.y_right == 0)
+                && throttle_pwm >= AUTOTUNE_MIN_THROTTLE;
+    const float ts = ctrlToFloat(throttle_scale);
+    float angle[AT_AXIS_COUNT] = { ctrlToFloat(roll), ctrlToFloat(pitch), 0.0f };
+    float rate[AT_AXIS_COUNT]  = { ctrlToFloat(rollRate), ctrlToFloat(pitchRate), ctrlToFloat(yawRate) };
+    float u[AT_AXIS_COUNT]     = { ctrlToFloat(u_roll) / ts, ctrlToFloat(u_pitch) / ts, ctrlToFloat(u_yaw) / ts };
+    autotuneUpdate(engaged, angle, rate, dt, u);
+    u_roll  = ctrl_t(ts * u[AT_ROLL]);
+    u_pitch = ctrl_t(ts * u[AT_PITCH]);
+    u_yaw   = ctrl_t(ts * u[AT_YAW]);
+  }
+
+  // 5) Mixer (таблица геометрии + airmode)
+  const ctrl_t base = ctrl_t((int)max<uint8_t>(throttle_pwm, IDLE_PWM));
+  uint8_t mixFlags = mixerComputeActive(base, u_roll, u_pitch, u_yaw, AIRMODE, motors);
+  captureDebug(attF, vs, sp_roll, sp_pitch, sp_yaw_rate, motors, mixFlags);
 }
@@ -4,12 +4,46 @@
 #include <Arduino.h>
 #include "pid.h"
 #include "attitude.h"
+#include "altitude.h"
 #include "telemetry.h"
 #include "joystick.h" // full definition of JoystickData
+#include "mixer.h"
+
+// Snapshot of the last stabilizeMix() call (for blackbox / debug output)
+struct StabilizerDebug {
+  Attitude att;
+  float sp_roll, sp_pitch, sp_yaw_rate;
+  float p[3], i[3], d[3];     // PID terms: roll, pitch, yaw rate
+  uint8_t motors[MIXER_MAX_MOTORS];
+  uint8_t motorCount;
+  uint8_t mixFlags;           // MIXER_SAT_* / MIXER_*_LIMITED
+  bool armed;
+  VerticalState vert;
+  float sp_height, sp_climb;  // valid while altHold
+  bool altHold;
+};
 
 void stabilizerInit();
 
+// motors[] receives mixerMotorCount() values (up to MIXER_MAX_MOTORS)
 void stabilizeMix(const JoystickData& js, const TelemetryData& sens, float dt,
-                  uint8_t* m1, uint8_t* m2, uint8_t* m3, uint8_t* m4);
+                  uint8_t* motors);
+
+const StabilizerDebug& stabilizerDebug();
+
+// Altitude hold: throttle stick becomes a climb-rate command around the
+// position it had when hold engaged (centre band = hold height).
+// Request persists across disarm; engages on the next armed loop.
+void stabilizerSetAltHold(bool on);
+bool stabilizerAltHold();
+
+// Failsafe hooks: rate > 0 replaces the throttle stick by a climb-rate
+// descent at that rate (m/s) using the altitude-hold loop; 0 = off.
+void stabilizerSetDescent(float rate);
+void stabilizerDisarm();
+
+// PID gains by axis: 0 = roll, 1 = pitch, 2 = yaw rate (autotune, bench tools)
+void stabilizerGetGains(uint8_t axis, float* kp, float* ki, float* kd);
+void stabilizerSetGains(uint8_t axis, float kp, float ki, float kd);
 
 #endif // STABILIZER_H
@@ -2,10 +2,14 @@
 #define TELEMETRY_H
 
 #include <Arduino.h>
+
+// Sensor drivers exist only on the target; host builds (host/) use just TelemetryData
+#ifdef ARDUINO
 #include <Wire.h>
 #include <Adafruit_MPU6050.h>
 #include <Adafruit_Sensor.h>
 #include <Adafruit_BMP280.h>
+#include <Adafruit_VL53L0X.h>
 
 // ====== Pin configuration for ESP32-C6 Supermini ======
 #define SDA_PIN 5
@@ -14,6 +18,12 @@
 // ====== Sensor objects ======
 extern Adafruit_MPU6050 mpu;
 extern Adafruit_BMP280 bmp;
+extern Adafruit_VL53L0X lox;   // optional: RX flies without it
+#endif
+
+#ifndef TOF_PERIOD_MS
+#define TOF_PERIOD_MS 33        // непрерывный режим VL53L0X, ~30 Гц
+#endif
 
 // ====== Telemetry data structure ======
 struct TelemetryData {
@@ -29,12 +39,17 @@ struct TelemetryData {
     
     // BMP280 Pressure (in hPa)
     float pressure;
+
+    // VL53L0X range (mm), -1 = no sensor, out of range or stale
+    int16_t range_mm;
 };
 
 // ====== Function declarations ======
 bool initializeTelemetrySensors();
-void readTelemetryData(TelemetryData* data);
-void formatTelemetryString(const TelemetryData* data, char* output, size_t maxLen);
+// Raw device reads; sampled through sensor_hub.h, not called directly
+void readImuSample(TelemetryData* data);   // accel/gyro, zeros on failure
+float readBaroHpa();                        // 0 on failure
+int16_t pollTofRange();                     // -1 = none / stale
 bool isTelemetryValid(const TelemetryData* data);
 
 #endif // TELEMETRY_H
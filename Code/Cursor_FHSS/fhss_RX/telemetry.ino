@@ -3,6 +3,10 @@
 // ====== Global sensor objects ======
 Adafruit_MPU6050 mpu;
 Adafruit_BMP280 bmp;
+Adafruit_VL53L0X lox;
+static bool tofPresent = false;
+static int16_t tofLastMm = -1;
+static uint32_t tofLastMs = 0;
 
 // ====== Sensor initialization ======
 bool initializeTelemetrySensors() {
@@ -11,33 +15,33 @@ bool initializeTelemetrySensors() {
     
     // Initialize MPU6050
     if (!mpu.begin()) {
-        Serial.println("TELEMETRY: Failed to find MPU6050!");
+        logText(LOG_ERROR, "TELEMETRY: Failed to find MPU6050!");
         return false;
     }
-    Serial.println("TELEMETRY: MPU6050 found!");
+    logText(LOG_INFO, "TELEMETRY: MPU6050 found!");
     
     // Initialize BMP280 (default address 0x76, if different specify 0x77)
     if (!bmp.begin(0x76)) {
-        Serial.println("TELEMETRY: Failed to find BMP280!");
+        logText(LOG_ERROR, "TELEMETRY: Failed to find BMP280!");
         return false;
     }
-    Serial.println("TELEMETRY: BMP280 found!");
-    
+    logText(LOG_INFO, "TELEMETRY: BMP280 found!");
+
+    // VL53L0X is optional (altitude estimator falls back to baro).
+    // Continuous mode: pollTofRange() never waits for a ranging cycle.
+    tofPresent = lox.begin() && lox.startRangeContinuous(TOF_PERIOD_MS);
+    logText(LOG_INFO, tofPresent ? "TELEMETRY: VL53L0X found!" : "TELEMETRY: VL53L0X not found, baro only");
     
-    Serial.println("TELEMETRY: All sensors initialized successfully!");
+    logText(LOG_INFO, tofPresent ? "TELEMETRY: All sensors initialized successfully!"
+                                      : "TELEMETRY: Sensors initialized (baro-only altitude)");
     return true;
 }
 
-// ====== Read data from all sensors ======
-void readTelemetryData(TelemetryData* data) {
-    if (data == nullptr) return;
-    
-    // Initialize with invalid values
+// ====== Per-device reads (sensor_hub.cpp decides when) ======
+void readImuSample(TelemetryData* data) {
     data->accel_x = data->accel_y = data->accel_z = 0.0f;
     data->gyro_x = data->gyro_y = data->gyro_z = 0.0f;
-    data->pressure = 0.0f;
-    
-    // Read MPU6050 data (accelerometer, gyroscope)
+
     sensors_event_t a, g, temp_mpu;
     if (mpu.getEvent(&a, &g, &temp_mpu)) {
         data->accel_x = a.acceleration.x;
@@ -48,40 +52,22 @@ void readTelemetryData(TelemetryData* data) {
         data->gyro_y = g.gyro.y;
         data->gyro_z = g.gyro.z;
     }
-    
-    // Read BMP280 data (pressure)
+}
+
+float readBaroHpa() {
     float pressure_pa = bmp.readPressure();
-    if (pressure_pa > 0) {
-        data->pressure = pressure_pa / 100.0F; // Convert to hPa
-    }
-    
+    return pressure_pa > 0 ? pressure_pa / 100.0F : 0.0f; // Convert to hPa
 }
 
-// ====== Format telemetry data as string ======
-void formatTelemetryString(const TelemetryData* data, char* output, size_t maxLen) {
-    if (data == nullptr || output == nullptr || maxLen == 0) return;
-    
-    // Ultra-compact format to fit in 24 bytes
-    // Format: aX:aY:aZ.gX:gY:gZ.p
-    // Example: 1.2:4.5:7.8.0.1:0.3:0.5.1013
-    
-    int len = snprintf(output, maxLen, "%.1f:%.1f:%.1f.%.1f:%.1f:%.1f.%.0f",
-        data->accel_x, data->accel_y, data->accel_z,
-        data->gyro_x, data->gyro_y, data->gyro_z,
-        data->pressure);
-    
-    // If still too long, use even more compact format
-    if (len >= (int)maxLen - 1) {
-        len = snprintf(output, maxLen, "%.0f:%.0f:%.0f.%.0f:%.0f:%.0f.%.0f",
-            data->accel_x, data->accel_y, data->accel_z,
-            data->gyro_x, data->gyro_y, data->gyro_z,
-            data->pressure);
-    }
-    
-    // Ensure null termination
-    if (len >= (int)maxLen) {
-        output[maxLen - 1] = '\0';
+// VL53L0X result is read only when a new ranging cycle is complete
+int16_t pollTofRange() {
+    if (!tofPresent) return -1;
+    if (lox.isRangeComplete()) {
+        uint16_t mm = lox.readRangeResult();
+        tofLastMm = (lox.readRangeStatus() == 0 && mm < 8000) ? (int16_t)mm : -1;
+        tofLastMs = millis();
     }
+    return millis() - tofLastMs <= 4 * TOF_PERIOD_MS ? tofLastMm : -1;
 }
 
 // ====== Validate telemetry data ======
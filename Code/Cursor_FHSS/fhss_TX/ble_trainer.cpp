@@ -0,0 +1,145 @@
+#include "ble_trainer.h"
+
+#if BLE_TRAINER
+
+#include <BleGamepad.h>
+#include "serial_log.h"
+
+static const uint32_t MIN_INTERVAL_US = 1000000UL / BLE_TRAINER_MAX_HZ;
+static const int16_t  HID_MAX = 32767;
+
+static BleGamepad s_pad(BLE_TRAINER_NAME, "ndtp", 100);
+static TaskHandle_t s_task = nullptr;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// loop() -> task, under s_mux
+static int16_t  s_pending[4];
+static uint32_t s_pendingUs = 0;
+static bool     s_dirty = false;
+static BleTrainerStats s_stats;
+static uint64_t s_latSumUs = 0;
+
+// loop() only
+static int16_t  s_posted[4] = { INT16_MIN, INT16_MIN, INT16_MIN, INT16_MIN };
+static uint32_t s_lastReportMs = 0;
+
+// Same shaping as the aircraft: deadband (stabilizer.cpp), then expo
+static int16_t shape(int16_t v, bool deadband) {
+  if (deadband && abs(v) <= BLE_TRAINER_DEADBAND) return 0;
+#if BLE_TRAINER_EXPO
+  const int32_t cube = (int32_t)v * v / 1000 * v / 1000;
+  v = (int16_t)(((int32_t)v * (100 - BLE_TRAINER_EXPO) + cube * BLE_TRAINER_EXPO) / 100);
+#endif
+  return v;
+}
+
+static int16_t toHid(int16_t v) {
+  return (int16_t)((int32_t)v * HID_MAX / 1000);
+}
+
+static void trainerTask(void*) {
+  uint32_t lastSendUs = micros() - MIN_INTERVAL_US;
+  bool wasConnected = false;
+  for (;;) {
+    // Просыпаемся на изменение; таймаут только чтобы заметить подключение
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+
+    const bool connected = s_pad.isConnected();
+    bool resend = connected && !wasConnected;   // новый хост получает текущее положение
+    wasConnected = connected;
+
+    const uint32_t since = micros() - lastSendUs;
+    if (since < MIN_INTERVAL_US) delay((MIN_INTERVAL_US - since + 999) / 1000);
+
+    int16_t axes[4];
+    uint32_t sampleUs;
+    portENTER_CRITICAL(&s_mux);
+    resend = resend || s_dirty;
+    s_dirty = false;
+    memcpy(axes, s_pending, sizeof(axes));
+    sampleUs = s_pendingUs;
+    s_stats.connected = connected;
+    portEXIT_CRITICAL(&s_mux);
+    if (!resend || !connected) continue;
+
+    s_pad.setX(toHid(axes[0]));
+    s_pad.setY(toHid(axes[1]));
+    s_pad.setZ(toHid(axes[2]));
+    s_pad.setRZ(toHid(axes[3]));
+    const uint32_t t0 = micros();
+    s_pad.sendReport();
+    const uint32_t t1 = micros();
+    lastSendUs = t1;
+
+    const uint32_t lat = t1 - sampleUs;
+    portENTER_CRITICAL(&s_mux);
+    s_stats.reports++;
+    s_latSumUs += lat;
+    if (lat > s_stats.latMaxUs) s_stats.latMaxUs = lat;
+    if (t1 - t0 > s_stats.sendMaxUs) s_stats.sendMaxUs = t1 - t0;
+    portEXIT_CRITICAL(&s_mux);
+  }
+}
+
+void bleTrainerInit() {
+  BleGamepadConfiguration cfg;
+  cfg.setAutoReport(false);   // отчёт шлёт только задача, один на изменение
+  cfg.setControllerType(CONTROLLER_TYPE_GAMEPAD);
+  cfg.setButtonCount(0);
+  cfg.setHatSwitchCount(0);
+  cfg.setWhichAxes(true, true, true, false, false, true, false, false);   // X Y Z RZ
+  cfg.setAxesMin(-HID_MAX);
+  cfg.setAxesMax(HID_MAX);
+  s_pad.begin(&cfg);
+
+  memset(&s_stats, 0, sizeof(s_stats));
+  // Core 0 with the BLE stack; loop() and the radio stay on core 1
+  xTaskCreatePinnedToCore(trainerTask, "ble_trainer", 3072, nullptr, BLE_TRAINER_TASK_PRIORITY, &s_task, 0);
+}
+
+void bleTrainerUpdate(const int16_t axes[4], uint32_t sampleUs) {
+  int16_t v[4];
+  bool changed = false;
+  for (uint8_t i = 0; i < 4; i++) {
+    v[i] = shape(axes[i], i != 1);   // газ без мёртвой зоны, как на RX
+    if (abs(v[i] - s_posted[i]) >= BLE_TRAINER_MIN_STEP || (v[i] != s_posted[i] && v[i] == 0)) changed = true;
+  }
+  if (!changed) return;
+  memcpy(s_posted, v, sizeof(v));
+
+  portENTER_CRITICAL(&s_mux);
+  if (s_dirty) s_stats.coalesced++;
+  memcpy(s_pending, v, sizeof(v));
+  s_pendingUs = sampleUs;
+  s_dirty = true;
+  portEXIT_CRITICAL(&s_mux);
+  if (s_task) xTaskNotifyGive(s_task);
+}
+
+BleTrainerStats bleTrainerStats() {
+  portENTER_CRITICAL(&s_mux);
+  BleTrainerStats st = s_stats;
+  st.latMeanUs = st.reports ? (uint32_t)(s_latSumUs / st.reports) : 0;
+  portEXIT_CRITICAL(&s_mux);
+  return st;
+}
+
+void bleTrainerReport() {
+  if (BLE_TRAINER_REPORT_MS == 0) return;
+  const uint32_t now = millis();
+  if (now - s_lastReportMs < BLE_TRAINER_REPORT_MS) return;
+  s_lastReportMs = now;
+
+  const BleTrainerStats st = bleTrainerStats();
+  logPrintf(LOG_INFO, "BLE: conn=%u reports=%lu coalesced=%lu lat_mean=%luus lat_max=%luus send_max=%luus",
+            st.connected ? 1 : 0, (unsigned long)st.reports, (unsigned long)st.coalesced,
+            (unsigned long)st.latMeanUs, (unsigned long)st.latMaxUs, (unsigned long)st.sendMaxUs);
+
+  // Максимумы за окно отчёта
+  portENTER_CRITICAL(&s_mux);
+  s_stats.latMaxUs = 0;
+  s_stats.sendMaxUs = 0;
+  portEXIT_CRITICAL(&s_mux);
+}
+
+#endif // BLE_TRAINER
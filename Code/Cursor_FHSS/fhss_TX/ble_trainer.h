@@ -0,0 +1,76 @@
+#ifndef BLE_TRAINER_H
+#define BLE_TRAINER_H
+
+#include <Arduino.h>
+
+// ====== BLE trainer output ======
+// Optional: the TX also shows up as a BLE HID gamepad (ESP32-BLE-Gamepad,
+// like Code/ble_gamepad) so a simulator gets the same calibrated sticks
+// the aircraft gets, while the radio link keeps running. loop() posts the
+// -1000..1000 values; a low-priority task on core 0 sends a report only
+// when an axis moved by BLE_TRAINER_MIN_STEP or more, and not more often
+// than BLE_TRAINER_MAX_HZ.
+//
+// Stick shaping is the aircraft's: deadband as in fhss_RX/stabilizer.cpp
+// (not on throttle), expo BLE_TRAINER_EXPO (the RX maps sticks linearly,
+// so 0 = same feel). Latency = stick sample age + sendReport() time; the
+// BLE connection interval (7.5..30 ms, set by the host) comes on top.
+//
+// Axes: X = LX, Y = LY (throttle, +1000 = motors off as on the RX),
+// Z = RX, RZ = RY.
+
+#ifndef BLE_TRAINER
+#define BLE_TRAINER 0               // 1 = нужна библиотека ESP32-BLE-Gamepad
+#endif
+#ifndef BLE_TRAINER_NAME
+#define BLE_TRAINER_NAME "FHSS TX Trainer"
+#endif
+#ifndef BLE_TRAINER_MAX_HZ
+#define BLE_TRAINER_MAX_HZ 125      // не чаще одного отчёта за 8 мс
+#endif
+#ifndef BLE_TRAINER_MIN_STEP
+#define BLE_TRAINER_MIN_STEP 2      // шум фильтра АЦП не шлём (шкала -1000..1000)
+#endif
+#ifndef BLE_TRAINER_DEADBAND
+#define BLE_TRAINER_DEADBAND 50     // = deadband() в stabilizer.cpp
+#endif
+#ifndef BLE_TRAINER_EXPO
+#define BLE_TRAINER_EXPO 0          // %, 0 = линейно как на RX
+#endif
+#ifndef BLE_TRAINER_REPORT_MS
+#define BLE_TRAINER_REPORT_MS 5000  // строка BLE: в лог, 0 = не выводить
+#endif
+#ifndef BLE_TRAINER_TASK_PRIORITY
+#define BLE_TRAINER_TASK_PRIORITY 1
+#endif
+
+struct BleTrainerStats {
+  uint32_t reports;      // sendReport() calls
+  uint32_t coalesced;    // changes merged by the rate limit
+  uint32_t latMeanUs;    // stick sample -> sendReport() returned
+  uint32_t latMaxUs;
+  uint32_t sendMaxUs;    // sendReport() alone
+  bool connected;
+};
+
+#if BLE_TRAINER
+
+void bleTrainerInit();   // after stickAdcInit(); starts advertising
+
+// From loop(): axes LX, LY, RX, RY in -1000..1000, sampleUs = micros()
+// when the ADC sample was taken. Never blocks.
+void bleTrainerUpdate(const int16_t axes[4], uint32_t sampleUs);
+
+BleTrainerStats bleTrainerStats();
+void bleTrainerReport();   // periodic "BLE:" log line, from loop()
+
+#else
+
+inline void bleTrainerInit() {}
+inline void bleTrainerUpdate(const int16_t*, uint32_t) {}
+inline BleTrainerStats bleTrainerStats() { return BleTrainerStats(); }
+inline void bleTrainerReport() {}
+
+#endif // BLE_TRAINER
+
+#endif // BLE_TRAINER_H
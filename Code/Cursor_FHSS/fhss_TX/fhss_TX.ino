@@ -3,11 +3,19 @@
 // - Performs initial sync on a fixed channel, then hops over a pseudo-random list of 10 channels
 // - Sends control data read from Serial to the aircraft
 // - Receives telemetry back via ACK payloads and prints to Serial
+// - TDMA_AIRCRAFT > 1: several receivers share each hop slot
 
 #include <Arduino.h>
 #include <SPI.h>
 #include <RF24.h>
 #include "tft_console.h"
+#include "serial_log.h"
+#include "stick_adc.h"
+#include "gs_stream.h"
+#include "ble_trainer.h"
+#include "rf_survey.h"
+#include "rf24_shadow.h"
+#include "power_idle.h"
 TftConsole gConsole;
 
 // ====== Pin configuration (adjust to your wiring) ======
@@ -29,6 +37,9 @@ TftConsole gConsole;
 #define Y_LEFT_PIN  7
 #define X_RIGHT_PIN 14
 #define Y_RIGHT_PIN 3
+// X_LEFT/X_RIGHT are on ADC2: the sticks are sampled by a 1 kHz analogRead()
+// round. Move all four to GPIO1..10 (ADC1) for DMA sampling (stick_adc.h).
+static const uint8_t STICK_PINS[STICK_AXES] = { X_LEFT_PIN, Y_LEFT_PIN, X_RIGHT_PIN, Y_RIGHT_PIN };
 
 // Joystick calibration structure
 struct JoystickCalibration {
@@ -44,9 +55,11 @@ struct JoystickData {
     int16_t x_right, y_right; // Right joystick (Mode 1: Pitch/Roll)
 }; 
 // ====== Radio setup ======
-static RF24 radio(NRF24_CE_PIN, NRF24_CSN_PIN);
+// repeated setChannel() etc. skipped; TX FIFO empty after every write(): no FLUSH_TX on stopListening()
+static RF24Shadow radio(NRF24_CE_PIN, NRF24_CSN_PIN, true);
 
 // 5-byte addresses for RX/TX pipes (must match on both sides)
+// Aircraft k of a TDMA group uses these with 'A'+k as the last byte
 static const uint8_t txAddress[5] = {'T','X','A','A','A'}; // for TX writing
 static const uint8_t rxAddress[5] = {'R','X','A','A','A'}; // for reading ACK payloads
 
@@ -59,6 +72,84 @@ static const uint8_t NUM_CHANNELS = sizeof(FHSS_CHANNELS) / sizeof(FHSS_CHANNELS
 // Slot timing and retry behavior
 static const uint32_t PACKET_INTERVAL_MS = 2;     // send every 2 ms (500 Hz) - higher frequency
 static const uint32_t MAX_NO_ACK_MS = 100;        // if no ACK telemetry for 200ms, attempt resync
+static const uint32_t SYNC_RETRY_MS = 50;         // sync attempts per unbound aircraft, ~20 Hz
+
+// ====== Multi-aircraft TDMA ======
+// TDMA_AIRCRAFT receivers (fhss_RX AIRCRAFT_ID 0..N-1) share one hop slot:
+// the TX writes to each in turn on the same channel, every aircraft acks
+// with its own telemetry, then the whole group hops. Each aircraft binds
+// on SYNC_CHANNEL on its own, in its sub-slot, while the others keep
+// flying. The slot grows only when N sub-slots no longer fit in
+// PACKET_INTERVAL_MS, so the per-aircraft rate is
+//   1e6 / max(PACKET_INTERVAL_MS * 1000, N * TDMA_SUBSLOT_US)   Hz
+// A sub-slot is the longest write, one that gets no ACK (aircraft gone):
+//   ~100 SPI/CE + 130 TX settle + 153 ControlPacket (30 B at 2 Mbps)
+//   + 500 ARD = ~885 us
+// ARD is 500 us because the ACK carries the 28-byte TelemetryPacket: at
+// 2 Mbps 250 us fits only ACK payloads up to 15 bytes. No retry, each one
+// would add 153 + 500 us to every sub-slot. An acked write is ~660 us
+// (+130 RX turnaround + 145 ACK instead of the ARD).
+// All aircraft get the same sticks (one set of gimbals).
+#ifndef TDMA_AIRCRAFT
+#define TDMA_AIRCRAFT 1            // 1 = один приёмник, как раньше
+#endif
+#ifndef TDMA_SUBSLOT_US
+#define TDMA_SUBSLOT_US 900        // write без ACK: ARD 500 мкс, без повтора
+#endif
+#ifndef TDMA_REPORT_MS
+#define TDMA_REPORT_MS 1000
+#endif
+
+static_assert(TDMA_AIRCRAFT >= 1 && TDMA_AIRCRAFT <= 8, "TDMA_AIRCRAFT: 1..8 (address byte, GsAirTelemetry)");
+
+static const uint32_t SLOT_US = (uint32_t)TDMA_AIRCRAFT * TDMA_SUBSLOT_US > PACKET_INTERVAL_MS * 1000UL
+                                ? (uint32_t)TDMA_AIRCRAFT * TDMA_SUBSLOT_US : PACKET_INTERVAL_MS * 1000UL;
+
+// ====== Background spectrum survey (rf_survey.h) ======
+// In the idle part of each 2 ms slot the radio listens on one channel
+// outside the hop list and samples its RPD. Once per SURVEY_REPORT_MS the
+// levels go to the ground station and the log names the quietest band of
+// the same shape as FHSS_CHANNELS (the link itself keeps its list).
+#ifndef SURVEY_IDLE
+#define SURVEY_IDLE 1
+#endif
+#ifndef SURVEY_GUARD_US
+#define SURVEY_GUARD_US 150        // запас до следующего пакета
+#endif
+#ifndef SURVEY_REPORT_MS
+#define SURVEY_REPORT_MS 1000
+#endif
+
+// ====== Power-aware idle (power_idle.h) ======
+// Every bound RX reports disarmed (TEL_FLAG_ARMED clear in its ACKs, no
+// older than POWER_RX_STATE_MS) and the sticks are still for
+// POWER_IDLE_AFTER_MS: slots stretch to POWER_IDLE_SLOT_MS, the nRF24 is
+// powered down and the ESP32 light-sleeps between them, the display
+// sleeps. The arm is done on the RX by stick combo, so the GPIO19 switch
+// is only a hint: it wakes the chip at once and the next slot is a
+// full-rate one; stick motion (the arm combo starts with it) is seen at
+// the next idle wake-up. An armed report, a stale one or an unbound
+// aircraft keeps full rate. Every packet carries its slot period, so the
+// RX sleeps between idle packets too.
+#ifndef POWER_IDLE_SLOT_MS
+#define POWER_IDLE_SLOT_MS 20        // 50 Гц в простое
+#endif
+#ifndef POWER_IDLE_AFTER_MS
+#define POWER_IDLE_AFTER_MS 3000     // без движения стиков до простоя
+#endif
+#ifndef POWER_RX_STATE_MS
+#define POWER_RX_STATE_MS 200        // отчёт RX о дизарме старее — полная частота
+#endif
+#ifndef POWER_STICK_DEADBAND
+#define POWER_STICK_DEADBAND 50      // из -1000..1000: шум АЦП не будит
+#endif
+#ifndef RADIO_WAKE_US
+#define RADIO_WAKE_US 1500           // nRF24 Tpd2stby (кварц)
+#endif
+
+static_assert(POWER_IDLE_SLOT_MS * 1000UL <= 0xFFFF, "POWER_IDLE_SLOT_MS: ControlPacket.slotUs is 16 bit");
+static_assert(POWER_IDLE_SLOT_MS * 4 <= MAX_NO_ACK_MS, "POWER_IDLE_SLOT_MS: keep several packets inside MAX_NO_ACK_MS");
+static_assert(POWER_IDLE_SLOT_MS * 4 <= POWER_RX_STATE_MS, "POWER_RX_STATE_MS: keep several idle ACKs inside it");
 
 // ====== Simple packet formats ======
 struct ControlPacket {
@@ -66,27 +157,58 @@ struct ControlPacket {
     uint8_t channelIndex;        // current FHSS channel index (for debugging/verification)
     uint8_t payloadLength;       // number of valid bytes in payload[]
     char payload[24];            // control data from Serial (truncated to 24)
+    uint16_t slotUs;             // period of this slot (longer while idle)
 };
 
 struct TelemetryPacket {
     uint16_t sequence;           // mirrors RX's view or its own telemetry sequence
     uint8_t payloadLength;
     char payload[24];
+    uint8_t flags;               // TEL_FLAG_*, 0 from an older RX
+};
+
+static const uint8_t TEL_FLAG_STATE = 0x01;   // flags valid
+static const uint8_t TEL_FLAG_ARMED = 0x02;   // RX stabilizer armed
+
+// Sync beacon on SYNC_CHANNEL; the RX acks with SYNC_MAGIC + its aircraft id.
+// Version 1 ended after seed.
+static const uint32_t SYNC_MAGIC = 0xA5F0C3D2;
+
+struct __attribute__((packed)) SyncFrame {
+    uint32_t magic;
+    uint8_t version;             // 2
+    uint8_t channelCount;
+    uint8_t seed;                // not used here; placeholder for future PRNG-based FHSS
+    uint8_t aircraftId;
+    uint8_t aircraftCount;
+    uint8_t channelIndex;        // FHSS index of the slot after this one
+    uint16_t slotUs;             // hop period, for the RX failsafe
 };
 
 // ====== State ======
-static bool isSynchronized = false;
+struct AircraftLink {
+    bool synced;
+    uint16_t controlSequence;
+    uint32_t lastAckMillis;
+    uint32_t lastSyncAttempt;
+    uint16_t sent, acked, telemetry;   // since the last TDMA report
+    bool rxArmed;                      // from the last ACK with TEL_FLAG_STATE
+    uint32_t rxStateMillis;            // when that ACK came
+};
+
+static AircraftLink aircraft[TDMA_AIRCRAFT] = {};
 static uint8_t currentChannelIndex = 0;
-static uint16_t controlSequence = 0;
-static uint32_t lastPacketMillis = 0;
-static uint32_t lastAckMillis = 0;
+static uint32_t lastPacketUs = 0;      // start of the current slot
+static uint32_t roundMaxUs = 0;        // longest slot round since the last report
 static uint32_t lastSyncWaitOutput = 0;
+static bool txIdle = false;
+static uint32_t lastActiveMillis = 0;  // RX armed, arm switch on or sticks moved
 
 // ====== Joystick state ======
 static JoystickCalibration calibration = {0};
 static JoystickData currentJoystickData = {0};
+static uint32_t currentJoystickSampleUs = 0;   // micros() of the ADC sample behind it
 static bool calibrationComplete = false;
-static uint32_t lastJoystickRead = 0;
 
 // ====== Helpers ======
 static void setRadioChannel(uint8_t channel)
@@ -106,11 +228,14 @@ static void performJoystickCalibration()
     int32_t x_left_sum = 0, y_left_sum = 0, x_right_sum = 0, y_right_sum = 0;
     int32_t sampleCount = 0;
     
+    int16_t raw[STICK_AXES];
     while (millis() - startTime < 3000) {
-        x_left_sum += analogRead(X_LEFT_PIN);
-        y_left_sum += analogRead(Y_LEFT_PIN);
-        x_right_sum += analogRead(X_RIGHT_PIN);
-        y_right_sum += analogRead(Y_RIGHT_PIN);
+        stickAdcPoll();
+        stickAdcRead(raw);
+        x_left_sum += raw[0];
+        y_left_sum += raw[1];
+        x_right_sum += raw[2];
+        y_right_sum += raw[3];
         sampleCount++;
         delay(10);
     }
@@ -137,10 +262,12 @@ static void performJoystickCalibration()
     calibration.y_right_min = calibration.y_right_max = calibration.y_right_center;
     
     while (millis() - startTime < 5000) {
-        int16_t x_left = analogRead(X_LEFT_PIN);
-        int16_t y_left = analogRead(Y_LEFT_PIN);
-        int16_t x_right = analogRead(X_RIGHT_PIN);
-        int16_t y_right = analogRead(Y_RIGHT_PIN);
+        stickAdcPoll();
+        stickAdcRead(raw);
+        int16_t x_left = raw[0];
+        int16_t y_left = raw[1];
+        int16_t x_right = raw[2];
+        int16_t y_right = raw[3];
         
         if (x_left < calibration.x_left_min) calibration.x_left_min = x_left;
         if (x_left > calibration.x_left_max) calibration.x_left_max = x_left;
@@ -168,15 +295,18 @@ static void performJoystickCalibration()
     Serial.println("=== CALIBRATION COMPLETE ===");
 }
 
-static void readJoystickData()
+// forSend: these sticks go on the air (runSlot), their age counts in STICK:
+static void readJoystickData(bool forSend)
 {
     if (!calibrationComplete) return;
     
-    // Read raw values
-    int16_t x_left_raw = analogRead(X_LEFT_PIN);
-    int16_t y_left_raw = analogRead(Y_LEFT_PIN);
-    int16_t x_right_raw = analogRead(X_RIGHT_PIN);
-    int16_t y_right_raw = analogRead(Y_RIGHT_PIN);
+    // Latest filtered values (sampled in the background, no ADC wait here)
+    int16_t raw[STICK_AXES];
+    currentJoystickSampleUs = micros() - stickAdcRead(raw, forSend);
+    int16_t x_left_raw = raw[0];
+    int16_t y_left_raw = raw[1];
+    int16_t x_right_raw = raw[2];
+    int16_t y_right_raw = raw[3];
     
     // Convert to normalized values (-1000 to +1000)
     currentJoystickData.x_left = map(x_left_raw, calibration.x_left_min, calibration.x_left_max, -1000, 1000);
@@ -210,38 +340,51 @@ static void configureRadioCommon()
     radio.setRetries(1, 3); // Reduced retries for faster transmission
 }
 
-static void enterSyncMode()
+static uint32_t currentSlotUs()
 {
-    isSynchronized = false;
-    currentChannelIndex = 0;
-    setRadioChannel(SYNC_CHANNEL);
-    radio.stopListening();
-    radio.openWritingPipe(txAddress);
-    radio.openReadingPipe(1, rxAddress);
-    radio.startListening(); // enable ACK payload reception
+    return txIdle ? POWER_IDLE_SLOT_MS * 1000UL : SLOT_US;
+}
+
+static bool anySynchronized()
+{
+    for (uint8_t k = 0; k < TDMA_AIRCRAFT; k++) {
+        if (aircraft[k].synced) return true;
+    }
+    return false;
 }
 
-static bool trySyncOnce()
+// Point TX_ADDR / pipe 0 (ACKs) at aircraft k; call in standby
+static void selectAircraft(uint8_t k)
+{
+#if TDMA_AIRCRAFT > 1
+    uint8_t address[5];
+    memcpy(address, txAddress, sizeof(address));
+    address[4] = txAddress[4] + k;
+    radio.openWritingPipe(address);
+#else
+    (void)k;   // единственный адрес открыт в setup()
+#endif
+}
+
+static bool trySyncOnce(uint8_t k)
 {
     // Send a small sync beacon; RX should respond with ACK payload confirming sync
-    struct {
-        uint32_t magic;
-        uint8_t version;
-        uint8_t channelCount;
-        uint8_t seed; // not used here; placeholder for future PRNG-based FHSS
-    } syncFrame;
-
-    syncFrame.magic = 0xA5F0C3D2;
-    syncFrame.version = 1;
+    SyncFrame syncFrame;
+    syncFrame.magic = SYNC_MAGIC;
+    syncFrame.version = 2;
     syncFrame.channelCount = NUM_CHANNELS;
     syncFrame.seed = 0x42;
+    syncFrame.aircraftId = k;
+    syncFrame.aircraftCount = TDMA_AIRCRAFT;
+    syncFrame.channelIndex = (currentChannelIndex + 1) % NUM_CHANNELS;
+    syncFrame.slotUs = (uint16_t)SLOT_US;
 
     radio.stopListening();
+    selectAircraft(k);
     setRadioChannel(SYNC_CHANNEL);
     delayMicroseconds(150);
 
     bool writeOk = radio.write(&syncFrame, sizeof(syncFrame));
-    radio.startListening();
 
     if (writeOk) {
         // Check if RX provided an ACK payload confirming sync
@@ -251,11 +394,13 @@ static bool trySyncOnce()
             if (len > 32) len = 32;
             radio.read(buf, len);
 
-            // Minimal validation: expect the same magic back
-            if (len >= 4 && buf[0] == 0xD2 && buf[1] == 0xC3 && buf[2] == 0xF0 && buf[3] == 0xA5) {
-                isSynchronized = true;
-                lastAckMillis = millis();
-                Serial.println("SYNC_OK");
+            // Same magic back; newer RX append their aircraft id
+            bool magicOk = len >= 4 && buf[0] == 0xD2 && buf[1] == 0xC3 && buf[2] == 0xF0 && buf[3] == 0xA5;
+            bool idOk = len >= 5 ? buf[4] == k : k == 0;
+            if (magicOk && idOk) {
+                aircraft[k].synced = true;
+                aircraft[k].lastAckMillis = millis();
+                gsEvent(GS_EV_SYNC_OK, k);
                 return true;
             }
         }
@@ -263,18 +408,15 @@ static bool trySyncOnce()
     return false;
 }
 
-static void sendControlAndReadTelemetry()
+static void sendControlAndReadTelemetry(uint8_t k)
 {
+    AircraftLink& a = aircraft[k];
+
     // Prepare control payload from joystick data
     ControlPacket pkt = {};
-    pkt.sequence = controlSequence++;
+    pkt.sequence = a.controlSequence++;
     pkt.channelIndex = currentChannelIndex;
-
-    // Read joystick data every 20ms for smooth control
-    if (millis() - lastJoystickRead > 20) {
-        readJoystickData();
-        lastJoystickRead = millis();
-    }
+    pkt.slotUs = (uint16_t)currentSlotUs();
 
     // Format joystick data for transmission
     char joystickBuffer[32] = {0};
@@ -286,14 +428,15 @@ static void sendControlAndReadTelemetry()
         memcpy(pkt.payload, joystickBuffer, pkt.payloadLength);
     }
 
-    // Hop channel and transmit
+    // Transmit on this slot's channel
     setRadioChannel(FHSS_CHANNELS[currentChannelIndex]);
     radio.stopListening();
+    selectAircraft(k);
     bool ok = radio.write(&pkt, sizeof(pkt));
-    radio.startListening();
 
+    bool gotTelemetry = false;
     if (ok) {
-        lastPacketMillis = millis();
+        a.acked++;
         // Receive telemetry via ACK payload (if present)
         if (radio.isAckPayloadAvailable()) {
             TelemetryPacket telemetry = {};
@@ -301,27 +444,200 @@ static void sendControlAndReadTelemetry()
             if (len > sizeof(telemetry)) len = sizeof(telemetry);
             radio.read(&telemetry, len);
 
+            if (telemetry.flags & TEL_FLAG_STATE) {
+                a.rxArmed = telemetry.flags & TEL_FLAG_ARMED;
+                a.rxStateMillis = millis();
+            }
             if (telemetry.payloadLength > 0 && telemetry.payloadLength <= sizeof(telemetry.payload)) {
-                Serial.print("TEL:");
-                Serial.write((const uint8_t*)telemetry.payload, telemetry.payloadLength);
-                Serial.println();
-                
-                // (debug prints removed to reduce Serial overhead)
+                gsTelemetry(telemetry.sequence, telemetry.payload, telemetry.payloadLength, k);
+                gotTelemetry = true;
+                a.telemetry++;
             }
-            lastAckMillis = millis();
+            a.lastAckMillis = millis();
         }
+    }
+    a.sent++;
+    gsLinkPacket(ok, gotTelemetry);
+}
 
-        // Advance FHSS index after each attempt
-        currentChannelIndex = (currentChannelIndex + 1) % NUM_CHANNELS;
+// One hop slot: every bound aircraft gets its packet on the same channel,
+// unbound ones a sync attempt in their place, then the group hops. The hop
+// does not wait for ACKs: the RX follows the channel index in the packet,
+// so a lost ACK or packet costs at most one pass over the list.
+static void runSlot()
+{
+    const uint32_t start = micros();
+    lastPacketUs = start;
+
+    // Fresh sticks for every slot
+    readJoystickData(true);
+
+    for (uint8_t k = 0; k < TDMA_AIRCRAFT; k++) {
+        AircraftLink& a = aircraft[k];
+        if (a.synced) {
+            sendControlAndReadTelemetry(k);
+        } else if (millis() - a.lastSyncAttempt > SYNC_RETRY_MS) {
+            a.lastSyncAttempt = millis();
+            if (!trySyncOnce(k) && millis() - lastSyncWaitOutput > 2000) {
+                // Output SYNC_WAIT only once every 2 seconds to avoid spam
+                logText(LOG_INFO, "SYNC_WAIT");
+                lastSyncWaitOutput = millis();
+            }
+        }
     }
+
+    currentChannelIndex = (currentChannelIndex + 1) % NUM_CHANNELS;
+    roundMaxUs = max(roundMaxUs, micros() - start);
+
+    // ACK payloads arrive in TX mode; the radio has to listen only for the
+    // idle survey. One mode change per slot instead of one per write.
+#if SURVEY_IDLE
+    if (!txIdle) radio.startListening();
+#endif
+}
+
+// Per-aircraft control rate and ACK ratio: the measured side of the
+// scaling formula above
+static void reportTdma()
+{
+#if TDMA_AIRCRAFT > 1
+    static uint32_t lastReport = 0;
+    const uint32_t now = millis();
+    const uint32_t periodMs = now - lastReport;
+    if (periodMs < TDMA_REPORT_MS) return;
+
+    logPrintf(LOG_INFO, "TDMA: slot max %lu of %lu us", (unsigned long)roundMaxUs, (unsigned long)SLOT_US);
+    for (uint8_t k = 0; k < TDMA_AIRCRAFT; k++) {
+        AircraftLink& a = aircraft[k];
+        if (a.synced) {
+            logPrintf(LOG_INFO, "TDMA %u: %lu Hz, ack %u%%, tel %u", k,
+                      (unsigned long)a.acked * 1000UL / periodMs, a.sent ? a.acked * 100U / a.sent : 0, a.telemetry);
+        } else {
+            logPrintf(LOG_INFO, "TDMA %u: not bound", k);
+        }
+        a.sent = a.acked = a.telemetry = 0;
+    }
+
+    roundMaxUs = 0;
+    lastReport = now;
+#endif
+}
+
+#if SURVEY_IDLE
+static void runIdleSurvey()
+{
+    const uint32_t now = micros();
+    surveyIdlePoll(now);
+
+    // Start a sample only if it ends before the next packet is due
+    const uint32_t elapsed = now - lastPacketUs;
+    if (!surveyIdleBusy() && elapsed + surveyDwell() + SURVEY_GUARD_US < SLOT_US) {
+        if (surveyIdleStart(now)) radio.forgetChannel();   // retuned past the shadow
+    }
+}
+
+static void reportSurvey()
+{
+    static uint32_t lastReport = 0;
+    static uint32_t lastSweeps = 0;
+    const uint32_t now = millis();
+    if (now - lastReport < SURVEY_REPORT_MS) return;
+
+    uint8_t level[SURVEY_CHANNELS];
+    for (uint8_t ch = 0; ch < SURVEY_CHANNELS; ch++) {
+        level[ch] = surveyIncluded(ch) ? min<uint8_t>(surveyLevel(ch), GS_SPECTRUM_NONE - 1) : GS_SPECTRUM_NONE;
+    }
+    gsSpectrum(level, SURVEY_CHANNELS);
+
+    // Quietest band with our spacing vs the one in use
+    const uint8_t spacing = FHSS_CHANNELS[1] - FHSS_CHANNELS[0];
+    const uint8_t span = spacing * (NUM_CHANNELS - 1);
+    uint8_t bestLevel;
+    const uint8_t best = surveyBestBand(NUM_CHANNELS, spacing, 0, SURVEY_CHANNELS - 1, SYNC_CHANNEL, &bestLevel);
+    const uint8_t curLevel = surveyBandLevel(FHSS_CHANNELS[0], NUM_CHANNELS, spacing);
+    const SurveyStats st = surveyStats();
+    logPrintf(LOG_INFO, "SCAN: band %u..%u busy %u%%, best %u..%u busy %u%%, %lu sweeps",
+              FHSS_CHANNELS[0], FHSS_CHANNELS[0] + span, curLevel * 100 / 255,
+              best, best + span, bestLevel * 100 / 255, (unsigned long)(st.sweeps - lastSweeps));
+
+    lastSweeps = st.sweeps;
+    lastReport = now;
+}
+#endif
+
+static void radioSleep()
+{
+    radio.powerDown();
+    powerRadioOff(true);
+}
+
+static void radioWake(uint32_t settleUs)
+{
+    radio.powerUp(settleUs);   // no SPI if already up
+    powerRadioOff(false);
+}
+
+static bool armSwitchOn()
+{
+    return digitalRead(ARM_SWITCH_PIN) == ARM_ACTIVE_LEVEL;
+}
+
+// Every aircraft bound and reporting disarmed, recently enough
+static bool allAircraftDisarmed()
+{
+    for (uint8_t k = 0; k < TDMA_AIRCRAFT; k++) {
+        const AircraftLink& a = aircraft[k];
+        if (!a.synced || a.rxArmed || millis() - a.rxStateMillis > POWER_RX_STATE_MS) return false;
+    }
+    return true;
+}
+
+static void updatePowerMode()
+{
+#if POWER_IDLE
+    static JoystickData restPosition = {0};
+    readJoystickData(false);
+    const JoystickData& j = currentJoystickData;
+    const bool moved = abs(j.x_left - restPosition.x_left) > POWER_STICK_DEADBAND ||
+                       abs(j.y_left - restPosition.y_left) > POWER_STICK_DEADBAND ||
+                       abs(j.x_right - restPosition.x_right) > POWER_STICK_DEADBAND ||
+                       abs(j.y_right - restPosition.y_right) > POWER_STICK_DEADBAND;
+    const uint32_t now = millis();
+    if (moved || armSwitchOn() || !allAircraftDisarmed() || !calibrationComplete) {
+        restPosition = j;
+        lastActiveMillis = now;
+    }
+
+    const bool idle = now - lastActiveMillis >= POWER_IDLE_AFTER_MS;
+    if (idle == txIdle) return;
+    txIdle = idle;
+    powerSetMode(idle ? PWR_IDLE : PWR_FULL);
+    gConsole.setIdle(idle);
+    if (!idle) radioWake(RADIO_WAKE_US);   // the next slot is due right away
+    logText(LOG_INFO, idle ? "PWR: idle" : "PWR: full rate");
+#endif
+}
+
+// Idle: sleep to RADIO_WAKE_US before the next slot, then start the nRF24
+// oscillator; it is up by the time the slot is due
+static void idleSleep()
+{
+    const uint32_t next = lastPacketUs + POWER_IDLE_SLOT_MS * 1000UL;
+#if !BLE_TRAINER
+    powerSleepUntil(next - RADIO_WAKE_US);   // BLE needs the chip awake: lower rate only
+#endif
+    if ((int32_t)(next - micros()) <= (int32_t)RADIO_WAKE_US) radioWake(0);
 }
 
 static void attemptResyncIfNeeded()
 {
-    if (!isSynchronized) return;
-    if (millis() - lastAckMillis > MAX_NO_ACK_MS) {
-        // Lost link; re-enter sync mode
-        enterSyncMode();
+    for (uint8_t k = 0; k < TDMA_AIRCRAFT; k++) {
+        AircraftLink& a = aircraft[k];
+        if (!a.synced || millis() - a.lastAckMillis <= MAX_NO_ACK_MS) continue;
+        // Lost link; this aircraft goes back to sync attempts, the others keep hopping
+        gsEvent(GS_EV_LINK_LOST, (int32_t)(millis() - a.lastAckMillis));
+        if (TDMA_AIRCRAFT > 1) logPrintf(LOG_WARN, "TDMA: aircraft %u lost", k);
+        a.synced = false;
     }
 }
 
@@ -330,15 +646,17 @@ void setup()
     Serial.begin(115200);
     delay(50);
 
-    // Initialize joystick pins
-    pinMode(X_LEFT_PIN, INPUT);
-    pinMode(Y_LEFT_PIN, INPUT);
-    pinMode(X_RIGHT_PIN, INPUT);
-    pinMode(Y_RIGHT_PIN, INPUT);
+    // Start continuous stick sampling (configures the pins)
+    stickAdcInit(STICK_PINS);
 
     // Perform joystick calibration
     performJoystickCalibration();
 
+    // From here on Serial output goes through the log ring
+    logInit(Serial);
+    gsStreamInit();
+    bleTrainerInit();
+
     // Initialize SPI explicitly as requested
     SPI.begin(SCK_PIN, MISO_PIN, MOSI_PIN, NRF24_CSN_PIN);
 
@@ -348,51 +666,85 @@ void setup()
     }
 
     configureRadioCommon();
+#if TDMA_AIRCRAFT > 1
+    // ARD 500 us (28-byte ACK payload), no retry: TDMA_SUBSLOT_US above
+    radio.setRetries(1, 0);
+#endif
 
     // Enable ACK payloads
     radio.enableAckPayload();
     radio.openWritingPipe(txAddress);
     radio.openReadingPipe(1, rxAddress);
+    radio.startListening();
+    radio.sync();
 
-    enterSyncMode();
+    // Survey everything except our own channels
+    surveyInit(radio, NRF24_CE_PIN);
+    surveyExclude(SYNC_CHANNEL);
+    for (uint8_t i = 0; i < NUM_CHANNELS; i++) surveyExclude(FHSS_CHANNELS[i]);
 
     gConsole.begin();
     gConsole.println(F("TX booting..."));
 
+    // S3 at 240 MHz; the radio listens for the survey most of a slot
+    static const PowerModel model = { 45000, 250, SURVEY_IDLE ? 13500 : 900, 1, 0 };
+    powerInit(model);
+    powerWakeOnPin(ARM_SWITCH_PIN, ARM_ACTIVE_LEVEL);
+    lastActiveMillis = millis();
+
+}
+
+#if BLE_TRAINER
+static void updateBleTrainer()
+{
+    readJoystickData(false);
+    const int16_t axes[4] = {
+        currentJoystickData.x_left, currentJoystickData.y_left,
+        currentJoystickData.x_right, currentJoystickData.y_right
+    };
+    bleTrainerUpdate(axes, currentJoystickSampleUs);
+    bleTrainerReport();
 }
+#endif
 
 void loop()
 {
-    if (!isSynchronized) {
-        // Try to sync at ~20 Hz (every 50ms) - faster sync attempts
-        static uint32_t lastSyncAttempt = 0;
-        if (millis() - lastSyncAttempt > 50) {
-            lastSyncAttempt = millis();
-            bool synced = trySyncOnce();
-            if (!synced) {
-                // Output SYNC_WAIT only once every 2 seconds to avoid spam
-                if (millis() - lastSyncWaitOutput > 2000) {
-                    Serial.println("SYNC_WAIT");
-                    lastSyncWaitOutput = millis();
-                }
-            }
-        }
-        delay(1);
-        return;
-    }
+#if BLE_TRAINER
+    // Simulator output runs with or without the radio link
+    stickAdcPoll();
+    updateBleTrainer();
+#endif
+
+    updatePowerMode();
 
-    // Maintain FHSS and send packets on a fixed interval
-    if (millis() - lastPacketMillis >= PACKET_INTERVAL_MS) {
-        sendControlAndReadTelemetry();
+    // Maintain FHSS and serve every aircraft once per slot
+    if (micros() - lastPacketUs >= currentSlotUs()) {
+        surveyIdleAbort();
+        radioWake(RADIO_WAKE_US);
+        runSlot();
+        if (txIdle) radioSleep();
     }
+#if SURVEY_IDLE
+    if (!txIdle) runIdleSurvey();
+    reportSurvey();
+#endif
 
+    stickAdcPoll();
+    stickAdcReport();
+    gsLinkUpdate(currentChannelIndex, anySynchronized());
+    reportTdma();
+    radio.report();
+    powerReport();
     attemptResyncIfNeeded();
-    
-    // Minimal delay for high frequency operation
-    delayMicroseconds(100);
 
-    gConsole.updateArmingBanner();     // читает GPIO19 и пишет Armed/Disarmed
-    gConsole.updateFromSerial(Serial);
+    if (txIdle) {
+        idleSleep();
+    } else {
+        // Minimal delay for high frequency operation
+        delayMicroseconds(100);
+    }
+
+    // Display (banner on GPIO19, Serial console) is drawn by its own task: tft_console.h
 }
 
 
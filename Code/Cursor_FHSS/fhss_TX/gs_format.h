@@ -0,0 +1,140 @@
+#ifndef GS_FORMAT_H
+#define GS_FORMAT_H
+
+// Ground-station stream layout: TX USB serial -> host/gs_tool.cpp.
+// Shared by the firmware (gs_stream.cpp) and the host tool, so no Arduino
+// dependencies here. Same file in nrf_scan/ (binary survey output).
+//
+// Frame on the wire: COBS(body) 0x00
+// body: type:u8 level:u8 seq:u8 timeMs:u32 payload[len] crc:u16
+// (little-endian; crc = CRC-16/CCITT-FALSE over type..payload; seq counts
+// frames so the host sees wire losses; timeMs is TX millis() when framed)
+//
+// A decoder resynchronises on every 0x00, so text printed before the
+// stream starts (calibration) only shows up as rejected frames.
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define GS_MAX_PAYLOAD  64                              // = LOG_MAX_RECORD
+#define GS_HEADER       7
+#define GS_MAX_BODY     (GS_HEADER + GS_MAX_PAYLOAD + 2)
+#define GS_MAX_ENCODED  (GS_MAX_BODY + GS_MAX_BODY / 254 + 1)
+
+// Record types (= serial_log record types on the TX)
+enum GsRecord : uint8_t {
+  GS_REC_TEXT      = 0,  // log line, payload = text
+  GS_REC_TELEMETRY = 1,  // GsTelemetry: one ACK payload from the RX
+  GS_REC_LINK      = 2,  // GsLink, every GS_LINK_PERIOD_MS
+  GS_REC_EVENT     = 3,  // GsEventRec
+  GS_REC_SPECTRUM  = 4,  // GsSpectrum: rf_survey levels, one sweep in chunks
+  GS_REC_AIR_TELEMETRY = 5,  // GsAirTelemetry: ACK payload from TDMA aircraft 1..7
+};
+
+enum GsEvent : uint8_t {
+  GS_EV_SYNC_OK   = 1,   // arg: aircraft (0 without TDMA)
+  GS_EV_LINK_LOST = 2,   // arg: ms since last ACK
+};
+
+#pragma pack(push, 1)
+struct GsTelemetry {
+  uint16_t rxSequence;   // TelemetryPacket.sequence
+  char text[24];         // "A:..", "G:..", ...; length = payload - 2
+};
+
+// Aircraft 0 keeps GS_REC_TELEMETRY, so single-aircraft streams don't change
+struct GsAirTelemetry {
+  uint8_t  aircraft;
+  uint16_t rxSequence;
+  char text[24];         // length = payload - 3
+};
+
+struct GsLink {
+  uint16_t periodMs;
+  uint16_t sent;         // control packets in the period
+  uint16_t acked;
+  uint16_t telemetry;    // ACKs that carried telemetry
+  uint16_t logDropped;   // serial_log records dropped in the period
+  uint8_t  channel;      // FHSS index
+  uint8_t  synced;
+};
+
+struct GsEventRec {
+  uint8_t code;
+  int32_t arg;
+};
+
+#define GS_SPECTRUM_CHUNK   61
+#define GS_SPECTRUM_LAST    0x01   // flags: last chunk of the sweep
+#define GS_SPECTRUM_NONE    0xFF   // level of a channel that isn't surveyed
+
+struct GsSpectrum {
+  uint8_t first;         // channel of level[0]
+  uint8_t count;         // channels in this chunk; length = 3 + count
+  uint8_t flags;
+  uint8_t level[GS_SPECTRUM_CHUNK];   // RPD occupancy 0..254 (exp. average)
+};
+#pragma pack(pop)
+
+static_assert(sizeof(GsSpectrum) <= GS_MAX_PAYLOAD, "spectrum chunk must fit a frame");
+
+static inline uint16_t gsCrc16(const uint8_t* p, size_t n, uint16_t crc = 0xFFFF)
+{
+  while (n--) {
+    crc ^= (uint16_t)(*p++) << 8;
+    for (uint8_t b = 0; b < 8; b++) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  }
+  return crc;
+}
+
+// COBS: out must hold n + n/254 + 1 bytes; returns encoded length (no 0x00)
+static inline size_t gsCobsEncode(const uint8_t* in, size_t n, uint8_t* out)
+{
+  size_t codeAt = 0, o = 1;
+  uint8_t code = 1;
+  for (size_t i = 0; i < n; i++) {
+    if (in[i] == 0) {
+      out[codeAt] = code; codeAt = o++; code = 1;
+    } else {
+      out[o++] = in[i];
+      if (++code == 0xFF) { out[codeAt] = code; codeAt = o++; code = 1; }
+    }
+  }
+  out[codeAt] = code;
+  return o;
+}
+
+// In-place safe (out may equal in); returns decoded length, 0 = malformed
+static inline size_t gsCobsDecode(const uint8_t* in, size_t n, uint8_t* out)
+{
+  size_t i = 0, o = 0;
+  while (i < n) {
+    uint8_t code = in[i++];
+    if (code == 0 || i + code - 1 > n) return 0;
+    for (uint8_t k = 1; k < code; k++) out[o++] = in[i++];
+    if (code != 0xFF && i < n) out[o++] = 0;
+  }
+  return o;
+}
+
+// Whole frame including the trailing 0x00; out holds GS_MAX_ENCODED + 1.
+// len <= GS_MAX_PAYLOAD. Returns bytes to send.
+static inline size_t gsBuildFrame(uint8_t type, uint8_t level, uint8_t seq, uint32_t timeMs,
+                                  const void* payload, uint8_t len, uint8_t* out)
+{
+  uint8_t body[GS_MAX_BODY];
+  body[0] = type;
+  body[1] = level;
+  body[2] = seq;
+  for (uint8_t i = 0; i < 4; i++) body[3 + i] = (uint8_t)(timeMs >> (8 * i));
+  const uint8_t* p = (const uint8_t*)payload;
+  for (uint8_t i = 0; i < len; i++) body[GS_HEADER + i] = p[i];
+  const uint16_t crc = gsCrc16(body, GS_HEADER + len);
+  body[GS_HEADER + len] = (uint8_t)crc;
+  body[GS_HEADER + len + 1] = (uint8_t)(crc >> 8);
+  size_t n = gsCobsEncode(body, GS_HEADER + len + 2, out);
+  out[n++] = 0;
+  return n;
+}
+
+#endif // GS_FORMAT_H
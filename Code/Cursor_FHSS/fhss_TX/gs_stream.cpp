@@ -0,0 +1,135 @@
+#include "gs_stream.h"
+
+static uint16_t s_sent = 0, s_acked = 0, s_telemetry = 0;
+static uint32_t s_linkStartMs = 0;
+static uint32_t s_droppedAtStart = 0;
+
+// ===== Text formatters (GS_STREAM 0) =====
+
+static void formatTelemetry(Print& out, const uint8_t* data, uint8_t len) {
+  if (len < 2) return;
+  out.print("TEL:");
+  out.write(data + 2, len - 2);
+  out.println();
+}
+
+static void formatAirTelemetry(Print& out, const uint8_t* data, uint8_t len) {
+  if (len < 3) return;
+  out.printf("TEL%u:", data[0]);
+  out.write(data + 3, len - 3);
+  out.println();
+}
+
+static void formatLink(Print& out, const uint8_t* data, uint8_t len) {
+  if (len != sizeof(GsLink)) return;
+  GsLink l;
+  memcpy(&l, data, sizeof(l));
+  out.printf("LINK: sent=%u acked=%u tel=%u ch=%u synced=%u log_dropped=%u\n",
+             l.sent, l.acked, l.telemetry, l.channel, l.synced, l.logDropped);
+}
+
+static void formatEvent(Print& out, const uint8_t* data, uint8_t len) {
+  if (len != sizeof(GsEventRec)) return;
+  GsEventRec e;
+  memcpy(&e, data, sizeof(e));
+  if (e.code == GS_EV_SYNC_OK) out.println("SYNC_OK");
+  else if (e.code == GS_EV_LINK_LOST) out.printf("LINK_LOST %ld\n", (long)e.arg);
+  else out.printf("EVENT %u %ld\n", e.code, (long)e.arg);
+}
+
+static void formatSpectrum(Print& out, const uint8_t* data, uint8_t len) {
+  if (len < 3 || len < 3 + data[1]) return;
+  out.printf("SPECTRUM %3u: ", data[0]);
+  for (uint8_t i = 0; i < data[1]; i++) {
+    const uint8_t l = data[3 + i];
+    out.write(l == GS_SPECTRUM_NONE ? '-' : "0123456789abcdef"[l >> 4]);
+  }
+  out.println();
+}
+
+// ===== Binary frames (GS_STREAM 1), runs in the log drain task =====
+
+static void writeFrame(Print& out, uint8_t type, uint8_t level, const uint8_t* data, uint8_t len) {
+  static uint8_t seq = 0;
+  static bool first = true;
+  if (first) {
+    out.write((uint8_t)0);   // отделить кадры от текста калибровки
+    first = false;
+  }
+  uint8_t frame[GS_MAX_ENCODED + 1];
+  size_t n = gsBuildFrame(type, level, seq++, millis(), data, len, frame);
+  out.write(frame, n);   // один write на кадр
+}
+
+void gsStreamInit() {
+  logSetFormatter(GS_REC_TELEMETRY, formatTelemetry);
+  logSetFormatter(GS_REC_AIR_TELEMETRY, formatAirTelemetry);
+  logSetFormatter(GS_REC_LINK, formatLink);
+  logSetFormatter(GS_REC_EVENT, formatEvent);
+  logSetFormatter(GS_REC_SPECTRUM, formatSpectrum);
+#if GS_STREAM
+  logSetWire(writeFrame);
+#endif
+  s_linkStartMs = millis();
+  s_droppedAtStart = logStats().dropped;
+}
+
+void gsTelemetry(uint16_t rxSequence, const char* text, uint8_t len, uint8_t aircraft) {
+  // No rate limit: every ACK is telemetry; a full ring is counted, not waited on
+  if (aircraft > 0) {
+    GsAirTelemetry t;
+    if (len > sizeof(t.text)) len = sizeof(t.text);
+    t.aircraft = aircraft;
+    t.rxSequence = rxSequence;
+    memcpy(t.text, text, len);
+    logRecord(GS_REC_AIR_TELEMETRY, LOG_INFO, &t, (uint8_t)(3 + len));
+    return;
+  }
+  GsTelemetry t;
+  if (len > sizeof(t.text)) len = sizeof(t.text);
+  t.rxSequence = rxSequence;
+  memcpy(t.text, text, len);
+  logRecord(GS_REC_TELEMETRY, LOG_INFO, &t, (uint8_t)(2 + len));
+}
+
+void gsEvent(GsEvent code, int32_t arg) {
+  GsEventRec e = { code, arg };
+  logRecord(GS_REC_EVENT, LOG_INFO, &e, sizeof(e));
+}
+
+void gsSpectrum(const uint8_t* level, uint8_t count) {
+  for (uint8_t first = 0; first < count; first += GS_SPECTRUM_CHUNK) {
+    GsSpectrum s;
+    s.first = first;
+    s.count = (uint8_t)min<int>(count - first, GS_SPECTRUM_CHUNK);
+    s.flags = first + s.count >= count ? GS_SPECTRUM_LAST : 0;
+    memcpy(s.level, level + first, s.count);
+    logRecord(GS_REC_SPECTRUM, LOG_INFO, &s, (uint8_t)(3 + s.count));
+  }
+}
+
+void gsLinkPacket(bool acked, bool telemetry) {
+  s_sent++;
+  if (acked) s_acked++;
+  if (telemetry) s_telemetry++;
+}
+
+void gsLinkUpdate(uint8_t channel, bool synced) {
+  const uint32_t now = millis();
+  if (now - s_linkStartMs < GS_LINK_PERIOD_MS) return;
+  const uint32_t dropped = logStats().dropped;
+
+  GsLink l;
+  l.periodMs = (uint16_t)(now - s_linkStartMs);
+  l.sent = s_sent;
+  l.acked = s_acked;
+  l.telemetry = s_telemetry;
+  l.logDropped = (uint16_t)min<uint32_t>(dropped - s_droppedAtStart, 0xFFFF);
+  l.channel = channel;
+  l.synced = synced ? 1 : 0;
+  logRecord(GS_REC_LINK, LOG_INFO, &l, sizeof(l));
+
+  s_sent = s_acked = s_telemetry = 0;
+  s_linkStartMs = now;
+  s_droppedAtStart = dropped;
+}
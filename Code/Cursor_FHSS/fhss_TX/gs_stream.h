@@ -0,0 +1,37 @@
+#ifndef GS_STREAM_H
+#define GS_STREAM_H
+
+#include <Arduino.h>
+#include "gs_format.h"
+#include "serial_log.h"
+
+// ====== Ground-station output ======
+// Telemetry, link statistics and events go into the serial_log ring as
+// binary records (gs_format.h). With GS_STREAM 1 the log drain task sends
+// every record, text lines included, as a COBS frame with CRC for
+// host/gs_tool; with 0 the same records print as the old text lines
+// (TEL:..., SYNC_OK, LINK: ...) for a plain Serial monitor.
+
+#ifndef GS_STREAM
+#define GS_STREAM 1
+#endif
+#ifndef GS_LINK_PERIOD_MS
+#define GS_LINK_PERIOD_MS 200
+#endif
+
+static_assert(GS_MAX_PAYLOAD == LOG_MAX_RECORD, "frame payload must fit a log record");
+
+void gsStreamInit();   // after logInit()
+
+void gsTelemetry(uint16_t rxSequence, const char* text, uint8_t len, uint8_t aircraft = 0);
+void gsEvent(GsEvent code, int32_t arg);
+
+// Survey levels of channels 0..count-1 as GsSpectrum chunks
+// (GS_SPECTRUM_NONE = not surveyed)
+void gsSpectrum(const uint8_t* level, uint8_t count);
+
+// Per control packet sent; gsLinkUpdate() emits GsLink every GS_LINK_PERIOD_MS
+void gsLinkPacket(bool acked, bool telemetry);
+void gsLinkUpdate(uint8_t channel, bool synced);
+
+#endif // GS_STREAM_H
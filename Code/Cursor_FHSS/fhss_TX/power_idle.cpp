@@ -0,0 +1,118 @@
+#include "power_idle.h"
+#include "serial_log.h"
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+
+static const char* const MODE_NAMES[PWR_MODES] = { "full", "idle" };
+
+struct PowerTimes {
+  uint64_t totalUs;
+  uint64_t sleepUs;
+  uint64_t radioOffUs;
+};
+
+static PowerModel s_model = {};
+static PowerMode s_mode = PWR_FULL;
+static bool s_radioOff = false;
+static uint32_t s_markUs = 0;
+static PowerTimes s_times[PWR_MODES];
+
+// Time since the last mark goes to the current mode
+static void account(uint32_t nowUs) {
+  const uint32_t dt = nowUs - s_markUs;
+  s_times[s_mode].totalUs += dt;
+  if (s_radioOff) s_times[s_mode].radioOffUs += dt;
+  s_markUs = nowUs;
+}
+
+void powerInit(const PowerModel& model) {
+  s_model = model;
+  s_mode = PWR_FULL;
+  s_radioOff = false;
+  memset(s_times, 0, sizeof(s_times));
+  s_markUs = micros();
+}
+
+void powerSetMode(PowerMode mode) {
+  if (mode == s_mode) return;
+  account(micros());
+  s_mode = mode;
+}
+
+PowerMode powerMode() { return s_mode; }
+
+void powerRadioOff(bool off) {
+  if (off == s_radioOff) return;
+  account(micros());
+  s_radioOff = off;
+}
+
+void powerWakeOnPin(uint8_t pin, uint8_t level) {
+#if POWER_LIGHT_SLEEP
+  gpio_wakeup_enable((gpio_num_t)pin, level == LOW ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+  esp_sleep_enable_gpio_wakeup();
+#else
+  (void)pin;
+  (void)level;
+#endif
+}
+
+uint32_t powerSleepUntil(uint32_t deadlineUs) {
+  const uint32_t start = micros();
+  const int32_t left = (int32_t)(deadlineUs - start);
+  if (left < POWER_SLEEP_MIN_US) return 0;
+
+#if POWER_LIGHT_SLEEP
+  esp_sleep_enable_timer_wakeup((uint64_t)(left - POWER_WAKE_LATENCY_US));
+  esp_light_sleep_start();
+#else
+  vTaskDelay(pdMS_TO_TICKS(left / 1000));
+#endif
+
+  const uint32_t now = micros();
+  const uint32_t slept = now - start;
+  account(now);
+  s_times[s_mode].sleepUs += slept;
+  return slept;
+}
+
+// uA * share of the mode's time, share in 1/1000
+static uint32_t estimateUa(const PowerTimes& t) {
+  const uint32_t sleep = (uint32_t)(t.sleepUs * 1000 / t.totalUs);
+  const uint32_t off = (uint32_t)(t.radioOffUs * 1000 / t.totalUs);
+  const uint64_t ua = (uint64_t)s_model.cpuActiveUa * (1000 - sleep) + (uint64_t)s_model.cpuSleepUa * sleep +
+                      (uint64_t)s_model.radioOnUa * (1000 - off) + (uint64_t)s_model.radioOffUa * off;
+  return (uint32_t)(ua / 1000) + s_model.otherUa;
+}
+
+void powerReport() {
+#if POWER_REPORT_MS > 0
+  static uint32_t lastMs = 0;
+  static PowerTimes last[PWR_MODES] = {};
+  const uint32_t nowMs = millis();
+  if (nowMs - lastMs < POWER_REPORT_MS) return;
+  account(micros());
+
+  uint64_t periodUs = 0;
+  PowerTimes d[PWR_MODES];
+  for (uint8_t m = 0; m < PWR_MODES; m++) {
+    d[m].totalUs = s_times[m].totalUs - last[m].totalUs;
+    d[m].sleepUs = s_times[m].sleepUs - last[m].sleepUs;
+    d[m].radioOffUs = s_times[m].radioOffUs - last[m].radioOffUs;
+    periodUs += d[m].totalUs;
+    last[m] = s_times[m];
+  }
+  lastMs = nowMs;
+  if (periodUs == 0) return;
+
+  // One line per mode that ran in this period; current is an estimate
+  for (uint8_t m = 0; m < PWR_MODES; m++) {
+    if (d[m].totalUs == 0) continue;
+    const uint32_t ua = estimateUa(d[m]);
+    logPrintf(LOG_INFO, "PWR %s: %u%% of time, sleep %u%%, radio off %u%%, ~%lu.%lu mA",
+              MODE_NAMES[m], (unsigned)(d[m].totalUs * 100 / periodUs),
+              (unsigned)(d[m].sleepUs * 100 / d[m].totalUs), (unsigned)(d[m].radioOffUs * 100 / d[m].totalUs),
+              (unsigned long)(ua / 1000), (unsigned long)(ua % 1000 / 100));
+  }
+#endif
+}
@@ -0,0 +1,240 @@
+#include "rf24_shadow.h"
+#include "serial_log.h"
+
+// RF24 1.4 transactions per call, for RF24ShadowStats.saved
+static const uint8_t COST_SET_CHANNEL = 1;
+static const uint8_t COST_START_LISTENING = 4;   // CONFIG, STATUS, EN_RXADDR r+w
+static const uint8_t COST_STOP_LISTENING = 4;    // FLUSH_TX, CONFIG, EN_RXADDR r+w
+static const uint8_t COST_WRITING_PIPE = 2;      // RX_ADDR_P0, TX_ADDR
+static const uint8_t COST_READING_PIPE = 3;      // RX_ADDR_Pn, EN_RXADDR r+w
+static const uint8_t COST_RF_SETUP = 2;          // read-modify-write
+static const uint8_t COST_POWER = 1;
+
+static const uint8_t STATUS_FLAGS = _BV(RX_DR) | _BV(TX_DS) | _BV(MAX_RT);
+
+static volatile uint32_t s_csnFalls = 0;
+
+#if RF24_SHADOW_COUNT
+static void ARDUINO_ISR_ATTR onCsnFall() {
+  s_csnFalls++;
+}
+#endif
+
+uint8_t RF24Shadow::writeRegister(uint8_t reg, uint8_t value) {
+  SPI.beginTransaction(SPISettings(RF24_SHADOW_SPI_HZ, MSBFIRST, SPI_MODE0));
+  digitalWrite(csn, LOW);
+  const uint8_t status = SPI.transfer(W_REGISTER | (REGISTER_MASK & reg));
+  SPI.transfer(value);
+  digitalWrite(csn, HIGH);
+  SPI.endTransaction();
+  counters.own++;
+  return status;
+}
+
+void RF24Shadow::command(uint8_t cmd) {
+  SPI.beginTransaction(SPISettings(RF24_SHADOW_SPI_HZ, MSBFIRST, SPI_MODE0));
+  digitalWrite(csn, LOW);
+  SPI.transfer(cmd);
+  digitalWrite(csn, HIGH);
+  SPI.endTransaction();
+  counters.own++;
+}
+
+void RF24Shadow::readRegister(uint8_t reg, uint8_t* buf, uint8_t len) {
+  SPI.beginTransaction(SPISettings(RF24_SHADOW_SPI_HZ, MSBFIRST, SPI_MODE0));
+  digitalWrite(csn, LOW);
+  SPI.transfer(R_REGISTER | (REGISTER_MASK & reg));
+  while (len--) *buf++ = SPI.transfer(0xFF);
+  digitalWrite(csn, HIGH);
+  SPI.endTransaction();
+  counters.own++;
+}
+
+uint8_t RF24Shadow::writeConfig(uint8_t value) {
+  config = value;
+  return writeRegister(NRF_CONFIG, value);
+}
+
+void RF24Shadow::sync() {
+  readRegister(NRF_CONFIG, &config, 1);
+  readRegister(RF_CH, &channel, 1);
+  readRegister(RF_SETUP, &rfSetup, 1);
+  readRegister(EN_RXADDR, &enRxAddr, 1);
+  readRegister(TX_ADDR, txAddr, 5);
+  readRegister(RX_ADDR_P0, rxAddr[0], 5);
+  readRegister(RX_ADDR_P1, rxAddr[1], 5);
+  for (uint8_t pipe = 2; pipe < 6; pipe++) readRegister(RX_ADDR_P0 + pipe, rxAddr[pipe], 1);
+
+#if RF24_SHADOW_COUNT
+  if (!valid) attachInterrupt(digitalPinToInterrupt(csn), onCsnFall, FALLING);
+#endif
+  valid = true;
+  channelKnown = true;
+}
+
+void RF24Shadow::setChannel(uint8_t ch) {
+  if (!valid) {
+    RF24::setChannel(ch);
+    return;
+  }
+  ch = min<uint8_t>(ch, 125);
+  if (channelKnown && ch == channel) {
+    counters.elided++;
+    counters.saved += COST_SET_CHANNEL;
+    return;
+  }
+  writeRegister(RF_CH, ch);
+  channel = ch;
+  channelKnown = true;
+}
+
+void RF24Shadow::startListening() {
+  if (!valid) {
+    RF24::startListening();
+    return;
+  }
+  if (config & _BV(PRIM_RX)) {
+    counters.elided++;
+    counters.saved += COST_START_LISTENING;
+    return;
+  }
+  const uint32_t before = counters.own;
+  const uint8_t status = writeConfig(config | _BV(PRIM_RX));
+  if (enRxAddr & _BV(ERX_P0)) {
+    enRxAddr &= ~_BV(ERX_P0);   // pipe 0 = TX address: не принимать чужие пакеты
+    writeRegister(EN_RXADDR, enRxAddr);
+  }
+  if (status & STATUS_FLAGS) writeRegister(NRF_STATUS, STATUS_FLAGS);
+  digitalWrite(ce, HIGH);
+  counters.saved += COST_START_LISTENING - (counters.own - before);
+}
+
+void RF24Shadow::stopListening() {
+  if (!valid) {
+    RF24::stopListening();
+    return;
+  }
+  if (!(config & _BV(PRIM_RX))) {
+    counters.elided++;
+    counters.saved += COST_STOP_LISTENING;
+    return;
+  }
+  // No txDelay wait: CE low ends RX at once. FLUSH_TX drops a loaded ACK
+  // payload, skipped only where the FIFO is known empty (keepTxFifo)
+  const uint32_t before = counters.own;
+  digitalWrite(ce, LOW);
+  if (!keepTxFifo) command(FLUSH_TX);
+  writeConfig(config & ~_BV(PRIM_RX));
+  if (!(enRxAddr & _BV(ERX_P0))) {
+    enRxAddr |= _BV(ERX_P0);   // ACKs come in on pipe 0
+    writeRegister(EN_RXADDR, enRxAddr);
+  }
+  counters.saved += COST_STOP_LISTENING - (counters.own - before);
+}
+
+void RF24Shadow::powerUp(uint32_t settleUs) {
+  if (!valid) {
+    RF24::powerUp();
+    return;
+  }
+  if (config & _BV(PWR_UP)) {
+    counters.elided++;
+    counters.saved += COST_POWER;
+    return;
+  }
+  writeConfig(config | _BV(PWR_UP));
+  if (config & _BV(PRIM_RX)) digitalWrite(ce, HIGH);   // powerDown() dropped it
+  if (settleUs) delayMicroseconds(settleUs);
+}
+
+void RF24Shadow::powerDown() {
+  if (!valid) {
+    RF24::powerDown();
+    return;
+  }
+  digitalWrite(ce, LOW);
+  if (!(config & _BV(PWR_UP))) {
+    counters.elided++;
+    counters.saved += COST_POWER;
+    return;
+  }
+  writeConfig(config & ~_BV(PWR_UP));
+}
+
+void RF24Shadow::openWritingPipe(const uint8_t* address) {
+  if (valid && memcmp(address, txAddr, 5) == 0 && memcmp(address, rxAddr[0], 5) == 0) {
+    counters.elided++;
+    counters.saved += COST_WRITING_PIPE;
+    return;
+  }
+  RF24::openWritingPipe(address);
+  memcpy(txAddr, address, 5);
+  memcpy(rxAddr[0], address, 5);
+}
+
+void RF24Shadow::openReadingPipe(uint8_t pipe, const uint8_t* address) {
+  if (pipe == 0 || pipe > 5) {
+    // Pipe 0 as a reading pipe changes RF24's own listening logic
+    RF24::openReadingPipe(pipe, address);
+    valid = false;
+    return;
+  }
+  const uint8_t len = pipe == 1 ? 5 : 1;
+  if (valid && (enRxAddr & _BV(pipe)) && memcmp(address, rxAddr[pipe], len) == 0) {
+    counters.elided++;
+    counters.saved += COST_READING_PIPE;
+    return;
+  }
+  RF24::openReadingPipe(pipe, address);
+  memcpy(rxAddr[pipe], address, len);
+  enRxAddr |= _BV(pipe);
+}
+
+bool RF24Shadow::setDataRate(rf24_datarate_e rate) {
+  const uint8_t bits = rate == RF24_250KBPS ? _BV(RF_DR_LOW) : rate == RF24_2MBPS ? _BV(RF_DR_HIGH) : 0;
+  if (valid && (rfSetup & (_BV(RF_DR_LOW) | _BV(RF_DR_HIGH))) == bits) {
+    counters.elided++;
+    counters.saved += COST_RF_SETUP;
+    return true;
+  }
+  const bool ok = RF24::setDataRate(rate);
+  if (valid) readRegister(RF_SETUP, &rfSetup, 1);
+  return ok;
+}
+
+void RF24Shadow::setPALevel(uint8_t level, bool lnaEnable) {
+  const uint8_t bits = (uint8_t)((min<uint8_t>(level, RF24_PA_MAX) << 1) | (lnaEnable ? 1 : 0));
+  if (valid && (rfSetup & 0x07) == bits) {
+    counters.elided++;
+    counters.saved += COST_RF_SETUP;
+    return;
+  }
+  RF24::setPALevel(level, lnaEnable);
+  if (valid) readRegister(RF_SETUP, &rfSetup, 1);
+}
+
+RF24ShadowStats RF24Shadow::stats() const {
+  RF24ShadowStats s = counters;
+  s.spi = s_csnFalls;
+  return s;
+}
+
+void RF24Shadow::report() {
+#if RF24_SHADOW_REPORT_MS > 0
+  static uint32_t lastMs = 0;
+  static RF24ShadowStats last = {};
+  const uint32_t now = millis();
+  const uint32_t periodMs = now - lastMs;
+  if (periodMs < RF24_SHADOW_REPORT_MS) return;
+
+  const RF24ShadowStats s = stats();
+  // Per second; spi stays 0 with RF24_SHADOW_COUNT 0
+  logPrintf(LOG_INFO, "RF: spi %lu/s (shadow %lu), elided %lu calls/s, saved %lu spi/s",
+            (unsigned long)((s.spi - last.spi) * 1000ULL / periodMs),
+            (unsigned long)((s.own - last.own) * 1000ULL / periodMs),
+            (unsigned long)((s.elided - last.elided) * 1000ULL / periodMs),
+            (unsigned long)((s.saved - last.saved) * 1000ULL / periodMs));
+  last = s;
+  lastMs = now;
+#endif
+}
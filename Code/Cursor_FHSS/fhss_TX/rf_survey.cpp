@@ -0,0 +1,167 @@
+#include "rf_survey.h"
+
+static const uint16_t MIN_DWELL_US = 170;
+
+static RF24*    s_radio = nullptr;
+static uint8_t  s_ce = 0;
+static uint16_t s_dwellUs = SURVEY_DWELL_US;
+static uint8_t  s_shift = SURVEY_EMA_SHIFT;
+static uint8_t  s_mask[(SURVEY_CHANNELS + 7) / 8];
+static uint8_t  s_firstCh = 0, s_lastCh = 0;   // bounds of the subset
+static uint16_t s_level[SURVEY_CHANNELS];       // Q8.8
+static uint8_t  s_cursor = 0;
+static bool     s_busy = false;
+static uint8_t  s_tunedCh = 0;
+static uint32_t s_tunedUs = 0;
+static uint32_t s_sweepStartUs = 0;
+static SurveyStats s_stats;
+
+static void updateBounds() {
+  s_firstCh = SURVEY_CHANNELS;
+  s_lastCh = 0;
+  for (uint8_t ch = 0; ch < SURVEY_CHANNELS; ch++) {
+    if (!surveyIncluded(ch)) continue;
+    if (s_firstCh == SURVEY_CHANNELS) s_firstCh = ch;
+    s_lastCh = ch;
+  }
+}
+
+// Next channel of the subset from the cursor, cyclic; -1 = empty subset
+static int nextChannel() {
+  for (uint8_t k = 0; k < SURVEY_CHANNELS; k++) {
+    const uint8_t ch = s_cursor;
+    s_cursor = (uint8_t)((s_cursor + 1) % SURVEY_CHANNELS);
+    if (surveyIncluded(ch)) return ch;
+  }
+  return -1;
+}
+
+// Standby-I -> RX on ch; RPD is valid 170 us later
+static void tune(uint8_t ch) {
+  digitalWrite(s_ce, LOW);
+  s_radio->setChannel(ch);
+  digitalWrite(s_ce, HIGH);
+  s_tunedCh = ch;
+}
+
+static void sample(uint32_t nowUs) {
+  const int32_t target = s_radio->testRPD() ? 0xFF00 : 0;
+  uint16_t& l = s_level[s_tunedCh];
+  l = (uint16_t)(l + ((target - (int32_t)l) >> s_shift));
+  s_stats.samples++;
+
+  if (s_tunedCh == s_firstCh) s_sweepStartUs = nowUs;
+  if (s_tunedCh == s_lastCh) {
+    s_stats.sweeps++;
+    s_stats.sweepUs = nowUs - s_sweepStartUs;
+  }
+}
+
+void surveyInit(RF24& radio, uint8_t cePin) {
+  s_radio = &radio;
+  s_ce = cePin;
+  memset(s_level, 0, sizeof(s_level));
+  memset(&s_stats, 0, sizeof(s_stats));
+  s_busy = false;
+  surveySetRange(0, SURVEY_CHANNELS - 1);
+}
+
+void surveySetDwell(uint16_t us) {
+  s_dwellUs = max(us, MIN_DWELL_US);
+}
+
+uint16_t surveyDwell() {
+  return s_dwellUs;
+}
+
+void surveySetEmaShift(uint8_t shift) {
+  s_shift = min<uint8_t>(shift, 8);
+}
+
+void surveySetRange(uint8_t lo, uint8_t hi, uint8_t step) {
+  memset(s_mask, 0, sizeof(s_mask));
+  if (step == 0) step = 1;
+  for (uint16_t ch = lo; ch <= hi && ch < SURVEY_CHANNELS; ch += step) s_mask[ch / 8] |= 1 << (ch % 8);
+  updateBounds();
+  s_cursor = s_firstCh % SURVEY_CHANNELS;
+}
+
+void surveyExclude(uint8_t ch) {
+  if (ch >= SURVEY_CHANNELS) return;
+  s_mask[ch / 8] &= ~(1 << (ch % 8));
+  updateBounds();
+}
+
+bool surveyIncluded(uint8_t ch) {
+  return ch < SURVEY_CHANNELS && (s_mask[ch / 8] & (1 << (ch % 8)));
+}
+
+void surveySweep() {
+  if (!s_radio || s_firstCh == SURVEY_CHANNELS) return;
+  for (uint8_t ch = s_firstCh; ch <= s_lastCh; ch++) {
+    if (!surveyIncluded(ch)) continue;
+    tune(ch);
+    delayMicroseconds(s_dwellUs);
+    sample(micros());
+  }
+}
+
+bool surveyIdleStart(uint32_t nowUs) {
+  if (!s_radio) return false;
+  const int ch = nextChannel();
+  if (ch < 0) return false;
+  tune((uint8_t)ch);
+  s_tunedUs = nowUs;
+  s_busy = true;
+  return true;
+}
+
+bool surveyIdlePoll(uint32_t nowUs) {
+  if (!s_busy || nowUs - s_tunedUs < s_dwellUs) return false;
+  sample(nowUs);
+  s_busy = false;
+  return true;
+}
+
+void surveyIdleAbort() {
+  if (!s_busy) return;
+  s_busy = false;
+  s_cursor = s_tunedCh;   // этот канал — первым в следующем окне
+  s_stats.aborted++;
+}
+
+bool surveyIdleBusy() {
+  return s_busy;
+}
+
+uint8_t surveyLevel(uint8_t ch) {
+  return ch < SURVEY_CHANNELS ? (uint8_t)(s_level[ch] >> 8) : 0;
+}
+
+uint8_t surveyBandLevel(uint8_t first, uint8_t count, uint8_t spacing) {
+  const uint16_t last = first + (uint16_t)spacing * (count - 1) + 1;
+  uint32_t sum = 0, n = 0;
+  for (uint16_t ch = first; ch <= last && ch < SURVEY_CHANNELS; ch++) {
+    if (!surveyIncluded((uint8_t)ch)) continue;
+    sum += surveyLevel((uint8_t)ch);
+    n++;
+  }
+  return n ? (uint8_t)(sum / n) : 255;   // ни одного измеренного канала
+}
+
+uint8_t surveyBestBand(uint8_t count, uint8_t spacing, uint8_t lo, uint8_t hi,
+                       uint8_t avoid, uint8_t* level) {
+  const uint16_t span = (uint16_t)spacing * (count - 1);
+  uint8_t best = lo, bestLevel = 255;
+  for (uint16_t base = lo; base + span <= hi && base + span < SURVEY_CHANNELS; base++) {
+    if (avoid != 0xFF && avoid >= base && avoid <= base + span) continue;
+    const uint8_t l = surveyBandLevel((uint8_t)base, count, spacing);
+    if (l < bestLevel) { bestLevel = l; best = (uint8_t)base; }
+  }
+  if (level) *level = bestLevel;
+  return best;
+}
+
+SurveyStats surveyStats() {
+  return s_stats;
+}
@@ -0,0 +1,71 @@
+#ifndef RF_SURVEY_H
+#define RF_SURVEY_H
+
+#include <Arduino.h>
+#include <RF24.h>
+
+// ====== nRF24 spectrum survey ======
+// Per-channel occupancy from the nRF24L01+ Received Power Detector (RPD:
+// > -64 dBm for 40 us while in RX). Each sample retunes with CE low ->
+// RF_CH -> CE high (no stopListening()/startListening(), which cost
+// hundreds of us), waits the dwell and reads RPD; the level per channel is
+// an exponential average of the hits, 0..255.
+//
+// Two ways to drive it:
+// - surveySweep(): one blocking pass over the channel subset (nrf_scan);
+// - surveyIdleStart()/surveyIdlePoll(): one channel at a time in the idle
+//   part of a hop slot of a live link (fhss_TX), the caller keeps the
+//   packet timing.
+// The radio must already be in RX (startListening()).
+//
+// Same file in nrf_scan/ and fhss_TX/ (sketches can't share sources).
+
+#define SURVEY_CHANNELS 126         // nRF24: 0..125 = 2400..2525 МГц
+
+#ifndef SURVEY_DWELL_US
+#define SURVEY_DWELL_US 200         // >= 170: 130 мкс вход в RX + 40 мкс RPD
+#endif
+#ifndef SURVEY_EMA_SHIFT
+#define SURVEY_EMA_SHIFT 3          // вес нового отсчёта 1/8
+#endif
+
+struct SurveyStats {
+  uint32_t samples;
+  uint32_t sweeps;       // passes over the whole subset
+  uint32_t aborted;      // idle samples cut short by the next packet
+  uint32_t sweepUs;      // duration of the last full pass
+};
+
+void surveyInit(RF24& radio, uint8_t cePin);
+
+void surveySetDwell(uint16_t us);          // clamped to >= 170
+uint16_t surveyDwell();
+void surveySetEmaShift(uint8_t shift);     // 0 = last sample only
+
+// Subset: lo..hi every step-th channel; surveyExclude() removes single
+// channels (the live FHSS list, the sync channel)
+void surveySetRange(uint8_t lo, uint8_t hi, uint8_t step = 1);
+void surveyExclude(uint8_t ch);
+bool surveyIncluded(uint8_t ch);
+
+void surveySweep();
+
+bool surveyIdleStart(uint32_t nowUs);      // false = empty subset
+bool surveyIdlePoll(uint32_t nowUs);       // true = sample taken, idle again
+void surveyIdleAbort();
+bool surveyIdleBusy();
+
+uint8_t surveyLevel(uint8_t ch);           // 0 = quiet, 255 = always busy
+
+// Mean level (0..255) over the channels the band's signal covers: first
+// .. last + 1 (2 Mbps = 2 MHz). Channels outside the subset are skipped.
+uint8_t surveyBandLevel(uint8_t first, uint8_t count, uint8_t spacing);
+
+// Quietest band of count channels spacing apart inside lo..hi that doesn't
+// contain avoid (0xFF = none); returns its first channel
+uint8_t surveyBestBand(uint8_t count, uint8_t spacing, uint8_t lo, uint8_t hi,
+                       uint8_t avoid, uint8_t* level);
+
+SurveyStats surveyStats();
+
+#endif // RF_SURVEY_H
@@ -0,0 +1,134 @@
+#ifndef SERIAL_LOG_H
+#define SERIAL_LOG_H
+
+#include <Arduino.h>
+
+// ====== Buffered, non-blocking Serial log ======
+// The radio / control loop only copies a small record (binary where it
+// can) into a single-producer ring. A FreeRTOS task formats the records
+// and writes them to Serial, so a full UART never stalls the loop. It runs
+// at loop() priority, round-robin with it: loop() never blocks, so a lower
+// priority would never get the CPU; the task itself mostly waits on the
+// UART. A full ring drops the record and counts it; the drain task prints
+// "LOG: dropped N" at most once per LOG_DROP_REPORT_MS.
+//
+// Once logInit() ran, nothing else may write to Serial: command replies
+// and dumps go through LogPrint. A command that has to stream straight to
+// the port (blackbox dump) brackets it with logHold(): stop-the-world,
+// bench only.
+//
+// Producer side (log*, LogPrint) must be called from one task only: loop().
+// Same file in fhss_RX/ and fhss_TX/ (sketches can't share sources).
+
+#ifndef LOG_ENABLED
+#define LOG_ENABLED 1
+#endif
+#ifndef LOG_RING_SIZE
+#define LOG_RING_SIZE 2048          // байт, степень двойки
+#endif
+#ifndef LOG_MAX_RECORD
+#define LOG_MAX_RECORD 64           // полезная нагрузка одной записи
+#endif
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_INFO          // уровень по умолчанию, logSetLevel() меняет
+#endif
+#ifndef LOG_DROP_REPORT_MS
+#define LOG_DROP_REPORT_MS 1000
+#endif
+#ifndef LOG_TASK_PRIORITY
+#define LOG_TASK_PRIORITY 1         // = loop(): ниже не получит CPU, loop() не блокируется
+#endif
+#ifndef LOG_TASK_STACK
+#define LOG_TASK_STACK 3072
+#endif
+
+#define LOG_RATE_SLOTS 8
+#define LOG_RECORD_TYPES 8
+
+enum LogLevel : uint8_t {
+  LOG_ERROR = 0,
+  LOG_WARN,
+  LOG_INFO,
+  LOG_DEBUG
+};
+
+// Record type 0 is plain text; 1..LOG_RECORD_TYPES-1 are binary records
+// whose layout is known only to the formatter the sketch registers.
+#define LOG_REC_TEXT 0
+
+typedef void (*LogFormatter)(Print& out, const uint8_t* data, uint8_t len);
+
+// Replaces the text output for every record (e.g. a binary framed stream)
+typedef void (*LogWireWriter)(Print& out, uint8_t type, uint8_t level, const uint8_t* data, uint8_t len);
+
+struct LogStats {
+  uint32_t written;     // records queued
+  uint32_t dropped;     // ring full
+  uint32_t suppressed;  // rate limit or level
+  uint16_t highWater;   // max bytes in the ring
+};
+
+#if LOG_ENABLED
+
+void logInit(Print& out);   // after Serial.begin(); starts the drain task
+void logSetFormatter(uint8_t type, LogFormatter fmt);
+void logSetLevel(LogLevel level);
+void logSetWire(LogWireWriter wire);   // nullptr = text (default)
+
+// true if at least minMs passed since the last true for this slot
+// (0..LOG_RATE_SLOTS-1); a false counts as suppressed
+bool logRateOk(uint8_t slot, uint16_t minMs);
+
+// Copy one record into the ring; false = filtered or dropped
+bool logRecord(uint8_t type, LogLevel level, const void* data, uint8_t len);
+bool logText(LogLevel level, const char* text);
+bool logPrintf(LogLevel level, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+LogStats logStats();
+
+// Serial command handler: 'l' prints LogStats. Returns true if handled.
+bool logCommand(char c, Print& out);
+
+// Waits (up to timeoutMs) for the ring to drain, then keeps the drain task
+// off the port until logHold(false): the caller writes to Serial directly
+void logHold(bool hold, uint32_t timeoutMs = 500);
+
+// Print that queues every line as a text record; a line longer than
+// LOG_MAX_RECORD goes on in the next record and is printed unbroken
+class LogPrint : public Print {
+public:
+  explicit LogPrint(LogLevel level = LOG_INFO) : _level(level) {}
+  size_t write(uint8_t c) override;
+  using Print::write;
+private:
+  void _push(bool more);
+  LogLevel _level;
+  uint8_t _len = 0;
+  char _line[LOG_MAX_RECORD];
+};
+
+#else
+
+inline void logInit(Print&) {}
+inline void logSetFormatter(uint8_t, LogFormatter) {}
+inline void logSetLevel(LogLevel) {}
+inline void logSetWire(LogWireWriter) {}
+inline bool logRateOk(uint8_t, uint16_t) { return false; }
+inline bool logRecord(uint8_t, LogLevel, const void*, uint8_t) { return false; }
+inline bool logText(LogLevel, const char*) { return false; }
+inline bool logPrintf(LogLevel, const char*, ...) { return false; }
+inline LogStats logStats() { LogStats s = {}; return s; }
+inline bool logCommand(char, Print&) { return false; }
+inline void logHold(bool, uint32_t = 500) {}
+
+// No ring: straight to Serial
+class LogPrint : public Print {
+public:
+  explicit LogPrint(LogLevel = LOG_INFO) {}
+  size_t write(uint8_t c) override { return Serial.write(c); }
+  using Print::write;
+};
+
+#endif // LOG_ENABLED
+
+#endif // SERIAL_LOG_H
@@ -0,0 +1,123 @@
+#include "stick_adc.h"
+#include "serial_log.h"
+
+static const uint8_t FILTER_FRAC = 4;   // состояние фильтра в Q4 от отсчёта АЦП
+
+static uint8_t  s_pins[STICK_AXES];
+static int32_t  s_state[STICK_AXES];    // Q4
+static bool     s_primed = false;
+static bool     s_dma = false;
+static volatile bool s_frameReady = false;
+static uint32_t s_sampleUs = 0;
+static uint32_t s_lastPollUs = 0;
+static StickAdcStats s_stats;
+static uint64_t s_ageSumUs = 0;
+static uint32_t s_ageCount = 0;
+static uint32_t s_lastReportMs = 0;
+
+// ESP32-S3: ADC1 = GPIO1..10; ADC2 has no continuous mode
+static bool isAdc1Pin(uint8_t pin) {
+#if CONFIG_IDF_TARGET_ESP32S3
+  return pin >= 1 && pin <= 10;
+#else
+  return false;
+#endif
+}
+
+static void ARDUINO_ISR_ATTR onFrame() {
+  s_frameReady = true;
+}
+
+static void feed(const int32_t raw[STICK_AXES], uint32_t nowUs) {
+  for (uint8_t i = 0; i < STICK_AXES; i++) {
+    int32_t x = raw[i] << FILTER_FRAC;
+    if (!s_primed) s_state[i] = x;
+    else s_state[i] += (x - s_state[i]) >> STICK_FILTER_SHIFT;
+  }
+  s_primed = true;
+  s_sampleUs = nowUs;
+  s_stats.frames++;
+}
+
+void stickAdcInit(const uint8_t pins[STICK_AXES]) {
+  memcpy(s_pins, pins, sizeof(s_pins));
+  memset(&s_stats, 0, sizeof(s_stats));
+  s_primed = false;
+
+  bool allAdc1 = true;
+  for (uint8_t i = 0; i < STICK_AXES; i++) allAdc1 = allAdc1 && isAdc1Pin(pins[i]);
+
+  s_dma = allAdc1
+       && analogContinuous(s_pins, STICK_AXES, STICK_OVERSAMPLE, STICK_ADC_SAMPLE_HZ, &onFrame)
+       && analogContinuousStart();
+  if (!s_dma) {
+    for (uint8_t i = 0; i < STICK_AXES; i++) pinMode(pins[i], INPUT);
+  }
+  s_stats.dma = s_dma;
+
+  // Первое значение сразу: stickAdcRead() никогда не отдаёт пустой фильтр
+  while (!s_primed) {
+    stickAdcPoll();
+    if (!s_primed) delayMicroseconds(100);
+  }
+}
+
+void stickAdcPoll() {
+  const uint32_t now = micros();
+  int32_t raw[STICK_AXES];
+
+  if (s_dma) {
+    if (!s_frameReady) return;
+    s_frameReady = false;
+    adc_continuous_data_t* res = nullptr;
+    if (!analogContinuousRead(&res, 0)) return;
+    for (uint8_t i = 0; i < STICK_AXES; i++) {
+      raw[i] = s_state[i] >> FILTER_FRAC;
+      // Results come in pin order, matched by pin to be safe
+      for (uint8_t j = 0; j < STICK_AXES; j++) {
+        if (res[j].pin == s_pins[i]) { raw[i] = res[j].avg_read_raw; break; }
+      }
+    }
+    feed(raw, now);
+    return;
+  }
+
+  if (s_primed && now - s_lastPollUs < STICK_POLL_US) return;
+  s_lastPollUs = now;
+  for (uint8_t i = 0; i < STICK_AXES; i++) raw[i] = analogRead(s_pins[i]);
+  feed(raw, now);
+}
+
+uint32_t stickAdcRead(int16_t raw[STICK_AXES], bool recordAge) {
+  for (uint8_t i = 0; i < STICK_AXES; i++) {
+    raw[i] = (int16_t)((s_state[i] + (1 << (FILTER_FRAC - 1))) >> FILTER_FRAC);
+  }
+  uint32_t age = micros() - s_sampleUs;
+  if (!recordAge) return age;
+  s_ageSumUs += age;
+  s_ageCount++;
+  s_stats.ageMeanUs = (uint32_t)(s_ageSumUs / s_ageCount);
+  if (age > s_stats.ageMaxUs) s_stats.ageMaxUs = age;
+  return age;
+}
+
+StickAdcStats stickAdcStats() {
+  return s_stats;
+}
+
+void stickAdcReport() {
+  if (STICK_REPORT_MS == 0) return;
+  if (s_lastReportMs != 0 && millis() - s_lastReportMs < STICK_REPORT_MS) return;
+  const bool first = s_lastReportMs == 0;   // окно начинается после калибровки
+  s_lastReportMs = millis();
+  if (!first) {
+    logPrintf(LOG_INFO, "STICK: %s frames=%lu age_mean_us=%lu age_max_us=%lu",
+              s_dma ? "dma" : "poll", (unsigned long)s_stats.frames,
+              (unsigned long)s_stats.ageMeanUs, (unsigned long)s_stats.ageMaxUs);
+  }
+  // Окно статистики = период отчёта
+  s_stats.frames = 0;
+  s_stats.ageMaxUs = 0;
+  s_ageSumUs = 0;
+  s_ageCount = 0;
+}
@@ -0,0 +1,55 @@
+#ifndef STICK_ADC_H
+#define STICK_ADC_H
+
+#include <Arduino.h>
+
+// ====== Continuous stick sampling ======
+// The four stick ADCs run all the time instead of four blocking
+// analogRead() calls every 20 ms. With all pins on ADC1 the ESP32 ADC
+// continuous (DMA) mode converts STICK_OVERSAMPLE samples per pin and
+// averages them in hardware; each finished frame is fed through a
+// fixed-point one-pole filter per axis. ADC2 pins can't use DMA on the
+// ESP32-S3, so with such wiring the same filter is fed from one
+// analogRead() round every STICK_POLL_US instead.
+//
+// stickAdcPoll() is cheap and called every loop() pass; stickAdcRead()
+// returns the latest filtered values and their age at any moment.
+
+#define STICK_AXES 4
+
+#ifndef STICK_ADC_SAMPLE_HZ
+#define STICK_ADC_SAMPLE_HZ 40000   // всего по 4 пинам (S3: 611..83333)
+#endif
+#ifndef STICK_OVERSAMPLE
+#define STICK_OVERSAMPLE 8          // отсчётов на пин в кадре DMA -> кадр 0.8 мс
+#endif
+#ifndef STICK_FILTER_SHIFT
+#define STICK_FILTER_SHIFT 2        // a = 1/4 на кадр, ~3 мс постоянная времени
+#endif
+#ifndef STICK_POLL_US
+#define STICK_POLL_US 1000          // без DMA: один круг analogRead() в 1 мс
+#endif
+#ifndef STICK_REPORT_MS
+#define STICK_REPORT_MS 5000        // строка STICK: в лог, 0 = не выводить
+#endif
+
+struct StickAdcStats {
+  uint32_t frames;       // filter updates
+  uint32_t ageMaxUs;     // sample age of the reads that went on the air
+  uint32_t ageMeanUs;
+  bool dma;
+};
+
+// pins: LX, LY, RX, RY. Uses DMA if every pin is on ADC1.
+void stickAdcInit(const uint8_t pins[STICK_AXES]);
+void stickAdcPoll();
+
+// Filtered raw ADC values (same scale as analogRead); returns age of the
+// newest sample in us. recordAge: count it in StickAdcStats — only the
+// read whose sticks are sent (runSlot), not idle/BLE checks in between
+uint32_t stickAdcRead(int16_t raw[STICK_AXES], bool recordAge = false);
+
+StickAdcStats stickAdcStats();
+void stickAdcReport();   // periodic "STICK:" log line (STICK_REPORT_MS)
+
+#endif // STICK_ADC_H
@@ -3,90 +3,139 @@
 void TftConsole::begin() {
   if (_inited) return;
 
+#if TFT_HW_SPI
+  // Второй SPI-хост: шина nRF24 (SPI/FSPI) дисплеем не занимается
+  static SPIClass tftSpi(HSPI);
+  tftSpi.begin(TFT_SCLK_PIN, -1, TFT_MOSI_PIN, TFT_CS_PIN);
+  _tft = new Adafruit_ST7735(&tftSpi, TFT_CS_PIN, TFT_DC_PIN, TFT_RST_PIN);
+#else
   // Конструктор на 5 пинов: CS, DC, MOSI, SCLK, RST
   _tft = new Adafruit_ST7735(TFT_CS_PIN, TFT_DC_PIN, TFT_MOSI_PIN, TFT_SCLK_PIN, TFT_RST_PIN);
+#endif
 
   _tft->initR(INITR_BLACKTAB);  // ST7735S (BLACKTAB — самая частая ревизия)
+#if TFT_HW_SPI
+  _tft->setSPISpeed(TFT_SPI_HZ);
+#endif
   _tft->setRotation(1);         // повернуть при необходимости: 0/1/2/3
   _tft->fillScreen(COL_BG);
   _tft->setTextWrap(false);
   _tft->setTextSize(1);         // базовый шрифт 5x7; высота строки ~8 px
-  _tft->setTextColor(COL_TEXT, COL_BG);
 
   pinMode(ARM_SWITCH_PIN, INPUT_PULLUP);
-  _drawBanner(false);
   clearConsole();
 
   _inited = true;
+  xTaskCreatePinnedToCore(_taskEntry, "tft", TFT_TASK_STACK, this,
+                          TFT_TASK_PRIORITY, nullptr, TFT_TASK_CORE);
 }
 
-void TftConsole::_drawBanner(bool armed) {
-  _tft->fillRect(0, 0, _tft->width(), BANNER_H, armed ? COL_ARMED_BG : COL_DIS_BG);
-  _tft->setCursor(2, 3);
-  _tft->setTextColor(armed ? COL_ARMED_TXT : COL_DIS_TXT, armed ? COL_ARMED_BG : COL_DIS_BG);
-  _tft->print(armed ? F("ARMED") : F("DISARMED"));
-  _tft->setTextColor(COL_TEXT, COL_BG);
-}
-
-void TftConsole::updateArmingBanner() {
-  bool pinState = digitalRead(ARM_SWITCH_PIN);
-  bool armed = (pinState == ARM_ACTIVE_LEVEL);
-  _drawBanner(armed);
+void TftConsole::_clearRow(uint8_t screenRow) {
+  char* r = _rows[(_top + screenRow) % ROWS];
+  memset(r, ' ', COLS);
+  r[COLS] = '\0';
+  _dirty |= 1UL << screenRow;
 }
 
 void TftConsole::clearConsole() {
-  // Очистить область ниже баннера
-  _tft->fillRect(0, BANNER_H, _tft->width(), _tft->height() - BANNER_H, COL_BG);
-  for (uint8_t i=0; i<MAX_LINES; ++i) _lines[i] = "";
-  _current = "";
-  _lineCount = 0;
-  _redrawAll();
-}
-
-void TftConsole::_redrawAll() {
-  int16_t y = BANNER_H + 1;
-  _tft->setTextColor(COL_TEXT, COL_BG);
-
-  for (uint8_t i=0; i<_lineCount; i++) {
-    _tft->setCursor(0, y);
-    _tft->print(_lines[i]);
-    y += 8;
-  }
-  if (_current.length()) {
-    _tft->setCursor(0, y);
-    _tft->print(_current);
-  }
+  portENTER_CRITICAL(&_lock);
+  _top = _row = _col = 0;
+  for (uint8_t i = 0; i < ROWS; i++) _clearRow(i);
+  portEXIT_CRITICAL(&_lock);
 }
 
 void TftConsole::_appendChar(char c) {
   if (c == '\r') return;
   if (c == '\n') {
-    // перенос строки
-    if (_lineCount < MAX_LINES) {
-      _lines[_lineCount++] = _current;
+    if (_row < ROWS - 1) {
+      _row++;
     } else {
-      // прокрутка вверх
-      for (uint8_t i=1; i<MAX_LINES; i++) _lines[i-1] = _lines[i];
-      _lines[MAX_LINES-1] = _current;
+      // прокрутка вверх: сдвигается только индекс, перерисовка всех строк
+      _top = (_top + 1) % ROWS;
+      _dirty = (1UL << ROWS) - 1;
     }
-    _current = "";
-  } else {
-    _current += c;
+    _col = 0;
+    _clearRow(_row);
+    return;
   }
+  if (_col >= COLS) return;   // за краем экрана не видно (setTextWrap(false))
+  _rows[(_top + _row) % ROWS][_col++] = c;
+  _dirty |= 1UL << _row;
 }
 
-void TftConsole::println(const String& s) {
-  for (size_t i=0; i<s.length(); ++i) _appendChar(s[i]);
+void TftConsole::println(const char* s) {
+  portENTER_CRITICAL(&_lock);
+  while (*s) _appendChar(*s++);
   _appendChar('\n');
-  _redrawAll();
+  portEXIT_CRITICAL(&_lock);
+}
+
+void TftConsole::_pollSerial(HardwareSerial& ser) {
+  char buf[32];
+  size_t n = 0;
+  while (n < sizeof(buf) && ser.available()) buf[n++] = (char)ser.read();
+  if (n == 0) return;
+  portENTER_CRITICAL(&_lock);
+  for (size_t i = 0; i < n; i++) _appendChar(buf[i]);
+  portEXIT_CRITICAL(&_lock);
 }
 
-void TftConsole::updateFromSerial(HardwareSerial &ser) {
-  bool changed = false;
-  while (ser.available()) {
-    char c = (char)ser.read();
-    _appendChar(c);
-    changed = true;
+void TftConsole::_updateBanner() {
+  bool armed = (digitalRead(ARM_SWITCH_PIN) == ARM_ACTIVE_LEVEL);
+  if ((int8_t)armed == _bannerArmed) return;
+  _bannerArmed = armed;
+  _tft->fillRect(0, 0, _tft->width(), BANNER_H, armed ? COL_ARMED_BG : COL_DIS_BG);
+  _tft->setCursor(2, 3);
+  _tft->setTextColor(armed ? COL_ARMED_TXT : COL_DIS_TXT, armed ? COL_ARMED_BG : COL_DIS_BG);
+  _tft->print(armed ? F("ARMED") : F("DISARMED"));
+}
+
+void TftConsole::_updateSleep() {
+  const bool idle = _idle;
+  if (idle == _asleep) return;
+  _tft->enableSleep(idle);
+  _asleep = idle;
+  if (idle) return;
+  // После SLPOUT — весь экран заново
+  _bannerArmed = -1;
+  portENTER_CRITICAL(&_lock);
+  _dirty = (1UL << ROWS) - 1;
+  portEXIT_CRITICAL(&_lock);
+}
+
+void TftConsole::_render() {
+  // Копия изменившихся строк под блокировкой, рисование без неё
+  char rows[ROWS][COLS + 1];
+  portENTER_CRITICAL(&_lock);
+  uint32_t dirty = _dirty;
+  _dirty = 0;
+  for (uint8_t i = 0; i < ROWS; i++) {
+    if (dirty & (1UL << i)) memcpy(rows[i], _rows[(_top + i) % ROWS], COLS + 1);
+  }
+  portEXIT_CRITICAL(&_lock);
+  if (!dirty) return;
+
+  _tft->setTextColor(COL_TEXT, COL_BG);
+  for (uint8_t i = 0; i < ROWS; i++) {
+    if (!(dirty & (1UL << i))) continue;
+    _tft->setCursor(0, BANNER_H + 1 + i * 8);
+    _tft->print(rows[i]);
+  }
+}
+
+void TftConsole::_taskEntry(void* self) {
+  static_cast<TftConsole*>(self)->_task();
+}
+
+void TftConsole::_task() {
+  TickType_t wake = xTaskGetTickCount();
+  for (;;) {
+    _pollSerial(Serial);
+    _updateSleep();
+    if (!_asleep) {
+      _updateBanner();
+      _render();
+    }
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(TFT_REFRESH_MS));
   }
-  if (changed) _redrawAll();
 }
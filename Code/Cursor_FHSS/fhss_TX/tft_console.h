@@ -5,6 +5,8 @@
 #include <SPI.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_ST7735.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
 // ====== Пины дисплея (5-проводное SPI: CS, DC, RST, MOSI, SCLK) ======
 #ifndef TFT_CS_PIN
@@ -44,40 +46,75 @@
 #define BANNER_H 14
 #endif
 
+// ====== Отрисовка ======
+// Дисплей рисует своя задача FreeRTOS на другом ядре, не чаще
+// TFT_REFRESH_MS, и только изменившиеся строки: цикл радио TX от
+// дисплея не зависит. TFT_HW_SPI — аппаратный SPI (второй хост, nRF24
+// остаётся на своём), 0 — программный на тех же пинах.
+#ifndef TFT_HW_SPI
+#define TFT_HW_SPI 1
+#endif
+#ifndef TFT_SPI_HZ
+#define TFT_SPI_HZ 27000000
+#endif
+#ifndef TFT_REFRESH_MS
+#define TFT_REFRESH_MS 50
+#endif
+#ifndef TFT_TASK_CORE
+#define TFT_TASK_CORE 0       // loop() на ядре 1
+#endif
+#ifndef TFT_TASK_PRIORITY
+#define TFT_TASK_PRIORITY 1
+#endif
+#ifndef TFT_TASK_STACK
+#define TFT_TASK_STACK 3072
+#endif
+
 class TftConsole {
 public:
-  // Инициализация (использует 5-пиновый конструктор Adafruit_ST7735)
+  // Инициализация дисплея и запуск задачи отрисовки
   void begin();
 
-  // Обновить баннер Armed/Disarmed по состоянию пина ARM_SWITCH_PIN
-  void updateArmingBanner();
-
-  // Считать байты из Serial и вывести в консоль
-  void updateFromSerial(HardwareSerial &ser = Serial);
-
-  // Напечатать строку программно (без Serial)
-  void println(const String& s);
+  // Добавить строку (из любой задачи; рисует задача дисплея)
+  void println(const char* s);
+  void println(const String& s) { println(s.c_str()); }
 
   // Очистить консольную область (без баннера)
   void clearConsole();
 
-  // Доступ к драйверу (если нужно)
-  Adafruit_ST7735& tft() { return *_tft; }
+  // Простой TX (power_idle.h): панель в SLPIN, отрисовки нет; строки
+  // копятся и выводятся целиком после выхода
+  void setIdle(bool idle) { _idle = idle; }
 
 private:
-  // Вариант с динамическим конструктором "на 5 пинов"
   Adafruit_ST7735* _tft = nullptr;
 
-  // Для 128x160 при шрифте 5x7 и межстрочном ~8px
-  static const uint8_t MAX_LINES = 18;
-  String _lines[MAX_LINES];
-  String _current;
-  uint8_t _lineCount = 0;
+  // 160x128 (rotation 1), шрифт 5x7 с шагом 6x8 px
+  static const uint8_t ROWS = 14;
+  static const uint8_t COLS = 26;
+
+  // Экран — кольцо строк фиксированной длины, дополненных пробелами:
+  // печать строки целиком затирает старый текст без fillRect.
+  char _rows[ROWS][COLS + 1];
+  uint8_t _top = 0;           // индекс в _rows верхней строки экрана
+  uint8_t _row = 0;           // строка экрана с курсором
+  uint8_t _col = 0;
+  uint32_t _dirty = 0;        // бит на строку экрана
+  portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+
+  int8_t _bannerArmed = -1;   // -1 = ещё не рисовали
   bool _inited = false;
+  volatile bool _idle = false;
+  bool _asleep = false;       // панель в SLPIN (меняет только задача)
 
-  void _drawBanner(bool armed);
-  void _redrawAll();
-  void _appendChar(char c);
+  static void _taskEntry(void* self);
+  void _task();
+  void _pollSerial(HardwareSerial& ser);
+  void _appendChar(char c);   // под _lock
+  void _clearRow(uint8_t screenRow);
+  void _updateBanner();
+  void _updateSleep();
+  void _render();
 };
 
 #endif // TFT_CONSOLE_H
@@ -0,0 +1,187 @@
+// Microbenchmarks of the link and control hot paths (host side)
+//
+// Build (from host/):
+//   g++ -O2 -std=c++17 -Ishim -I../fhss_RX -I../../NRFFHSS-main/Slave -o bench bench.cpp
+//       shim/arduino_host.cpp shim/frame_timer_host.cpp ../fhss_RX/bench.cpp
+//       ../fhss_RX/link_format.cpp ../fhss_RX/attitude.cpp ../fhss_RX/mixer.cpp
+//       ../../NRFFHSS-main/Slave/RadioSlave.cpp
+// Usage: bench [--rounds N] [--filter S] [--save FILE] [--compare FILE] [--max-regress PCT]
+//
+// Kernels come from fhss_RX/bench.cpp (the same ones the RX runs with
+// -DBENCH_KERNELS=1 and reports in cycles) plus the RadioSlave packet
+// templates: one 15-byte payload packed with AddNextPacketValue<> and
+// unpacked with GetNextPacketValue<>, per call. The whole suite runs
+// --rounds times (5). Per kernel: "best" is the median over rounds of the
+// fastest sample, "median" and "p90" the same for those statistics, and
+// "spread" how far apart the rounds' fastest samples were. On a shared or
+// frequency-scaling machine whole rounds run slower, which moves medians
+// by tens of percent; the fastest of 101 batches hardly moves, so "best" is
+// what --save writes ("name ns" lines) and --compare checks against a file
+// saved e.g. on the parent commit. Exit code 1 if a kernel is more than
+// --max-regress percent (10) slower than in the compared file.
+
+#include <time.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include "bench.h"
+#include "mixer.h"
+#include "RadioSlave.h"
+
+static uint32_t clockNs()
+{
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec);
+}
+
+// ===== RadioSlave packet kernels =====
+
+#define SLAVE_PACKET_SIZE 16   // as Slave.ino: id byte + 15 payload bytes
+
+static RadioSlave s_slave;
+
+// 2+2+2+2 + 4 + 1+1+1 = 15 bytes: sticks, a float, three flags
+static void opSlavePack(uint32_t i)
+{
+  s_slave.ClearSendPackets();
+  s_slave.AddNextPacketValue<int16_t>(PACKET1, (int16_t)i);
+  s_slave.AddNextPacketValue<int16_t>(PACKET1, (int16_t)(i >> 1));
+  s_slave.AddNextPacketValue<int16_t>(PACKET1, (int16_t)(i >> 2));
+  s_slave.AddNextPacketValue<int16_t>(PACKET1, (int16_t)(i >> 3));
+  s_slave.AddNextPacketValue<float>(PACKET1, (float)i);
+  s_slave.AddNextPacketValue<uint8_t>(PACKET1, (uint8_t)i);
+  s_slave.AddNextPacketValue<uint8_t>(PACKET1, (uint8_t)(i >> 8));
+  s_slave.AddNextPacketValue<uint8_t>(PACKET1, (uint8_t)(i >> 16));
+}
+
+static void opSlaveUnpack(uint32_t)
+{
+  s_slave.ClearReceivePackets();
+  uint32_t sum = 0;
+  sum += (uint16_t)s_slave.GetNextPacketValue<int16_t>(PACKET1);
+  sum += (uint16_t)s_slave.GetNextPacketValue<int16_t>(PACKET1);
+  sum += (uint16_t)s_slave.GetNextPacketValue<int16_t>(PACKET1);
+  sum += (uint16_t)s_slave.GetNextPacketValue<int16_t>(PACKET1);
+  sum += s_slave.GetNextPacketValue<float>(PACKET1) > 0.0f;
+  sum += s_slave.GetNextPacketValue<uint8_t>(PACKET1);
+  sum += s_slave.GetNextPacketValue<uint8_t>(PACKET1);
+  sum += s_slave.GetNextPacketValue<uint8_t>(PACKET1);
+  benchSink += sum;
+}
+
+// ===== Rounds =====
+
+static std::string s_filter;
+static std::vector<std::string> s_order;
+static std::map<std::string, std::vector<BenchStats>> s_rounds;
+
+static void collect(const BenchStats& s)
+{
+  if (!s_filter.empty() && std::string(s.name).find(s_filter) == std::string::npos) return;
+  if (!s_rounds.count(s.name)) s_order.push_back(s.name);
+  s_rounds[s.name].push_back(s);
+}
+
+static void runRound()
+{
+  benchRunKernels(clockNs, collect);
+  collect(benchMeasure("slave_pack", opSlavePack, clockNs));
+  collect(benchMeasure("slave_unpack", opSlaveUnpack, clockNs));
+}
+
+static float median(std::vector<float> v)
+{
+  std::sort(v.begin(), v.end());
+  const size_t n = v.size();
+  return n % 2 ? v[n / 2] : 0.5f * (v[n / 2 - 1] + v[n / 2]);
+}
+
+static bool loadBaseline(const std::string& path, std::map<std::string, float>* out)
+{
+  std::ifstream f(path);
+  if (!f) return false;
+  std::string name;
+  float ns;
+  while (f >> name >> ns) (*out)[name] = ns;
+  return true;
+}
+
+static void usage(const char* argv0)
+{
+  printf("usage: %s [options]\n"
+         "  --rounds N        suite repetitions (default 5)\n"
+         "  --filter S        only kernels whose name contains S\n"
+         "  --save FILE       write \"name best_ns\" per kernel\n"
+         "  --compare FILE    show the change against a saved file\n"
+         "  --max-regress P   fail if a kernel is P%% slower than FILE (default 10)\n", argv0);
+}
+
+int main(int argc, char** argv)
+{
+  int rounds = 5;
+  float maxRegress = 10.0f;
+  std::string savePath, comparePath;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (a == "--rounds" && hasValue) rounds = std::max(1, atoi(argv[++i]));
+    else if (a == "--filter" && hasValue) s_filter = argv[++i];
+    else if (a == "--save" && hasValue) savePath = argv[++i];
+    else if (a == "--compare" && hasValue) comparePath = argv[++i];
+    else if (a == "--max-regress" && hasValue) maxRegress = (float)atof(argv[++i]);
+    else { usage(argv[0]); return 2; }
+  }
+
+  std::map<std::string, float> baseline;
+  if (!comparePath.empty() && !loadBaseline(comparePath, &baseline)) {
+    fprintf(stderr, "%s: cannot open\n", comparePath.c_str());
+    return 2;
+  }
+
+  mixerInit(MIXER_GEOMETRY);
+  benchInit();
+  s_slave.InitPackets(SLAVE_PACKET_SIZE, 1, 1);
+  for (int r = 0; r < rounds; ++r) runRound();
+
+  printf("%-16s %9s %9s %9s %7s", "kernel", "best", "median", "p90", "spread");
+  if (!baseline.empty()) printf(" %9s %7s", "before", "change");
+  printf("   ns/call, %d rounds x %d samples x %d calls\n", rounds, BENCH_SAMPLES, BENCH_BATCH);
+
+  FILE* save = savePath.empty() ? nullptr : fopen(savePath.c_str(), "w");
+  if (!savePath.empty() && !save) {
+    fprintf(stderr, "%s: cannot write\n", savePath.c_str());
+    return 2;
+  }
+
+  bool regressed = false;
+  for (const std::string& name : s_order) {
+    std::vector<float> mins, meds, p90s;
+    for (const BenchStats& s : s_rounds[name]) {
+      mins.push_back(s.minT);
+      meds.push_back(s.medianT);
+      p90s.push_back(s.p90T);
+    }
+    const float best = median(mins);
+    const float lo = *std::min_element(mins.begin(), mins.end());
+    const float hi = *std::max_element(mins.begin(), mins.end());
+    printf("%-16s %9.2f %9.2f %9.2f %6.1f%%", name.c_str(), best, median(meds), median(p90s),
+           best > 0.0f ? 100.0f * (hi - lo) / best : 0.0f);
+
+    auto b = baseline.find(name);
+    if (b != baseline.end() && b->second > 0.0f) {
+      const float change = 100.0f * (best - b->second) / b->second;
+      const bool slow = change > maxRegress;
+      regressed |= slow;
+      printf(" %9.2f %+6.1f%%%s", b->second, change, slow ? "  SLOWER" : "");
+    }
+    printf("\n");
+    if (save) fprintf(save, "%s %.3f\n", name.c_str(), best);
+  }
+  if (save && fclose(save) != 0) {
+    fprintf(stderr, "%s: write failed\n", savePath.c_str());
+    return 2;
+  }
+  return regressed ? 1 : 0;
+}
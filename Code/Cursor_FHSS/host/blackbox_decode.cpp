@@ -0,0 +1,160 @@
+// Blackbox log -> CSV converter (host side, Linux)
+//
+// Build: g++ -O2 -std=c++17 -o blackbox_decode blackbox_decode.cpp
+// Usage: blackbox_decode <log.bbx> [frames.csv] [events.csv]
+//
+// Accepts either the raw LittleFS file or a Serial capture of the 'b'
+// dump command (text around the binary data is skipped).
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "../fhss_RX/blackbox_format.h"
+
+static const char* FIXED_NAMES[BBX_F_FIXED_COUNT] = {
+  "gyro_x", "gyro_y", "gyro_z",
+  "acc_x", "acc_y", "acc_z",
+  "roll", "pitch",
+  "sp_roll", "sp_pitch", "sp_yaw",
+  "p_roll", "i_roll", "d_roll",
+  "p_pitch", "i_pitch", "d_pitch",
+  "p_yaw", "i_yaw", "d_yaw",
+};
+
+static const float FIXED_SCALES[BBX_F_FIXED_COUNT] = {
+  BBX_SCALE_GYRO, BBX_SCALE_GYRO, BBX_SCALE_GYRO,
+  BBX_SCALE_ACCEL, BBX_SCALE_ACCEL, BBX_SCALE_ACCEL,
+  BBX_SCALE_ANGLE, BBX_SCALE_ANGLE,
+  BBX_SCALE_SETPOINT, BBX_SCALE_SETPOINT, BBX_SCALE_SETPOINT,
+  BBX_SCALE_PID, BBX_SCALE_PID, BBX_SCALE_PID,
+  BBX_SCALE_PID, BBX_SCALE_PID, BBX_SCALE_PID,
+  BBX_SCALE_PID, BBX_SCALE_PID, BBX_SCALE_PID,
+};
+
+static const char* eventName(uint8_t code)
+{
+  switch (code) {
+    case BBX_EV_SYNC_OK:   return "SYNC_OK";
+    case BBX_EV_LINK_LOST: return "LINK_LOST";
+    case BBX_EV_ARMED:     return "ARMED";
+    case BBX_EV_DISARMED:  return "DISARMED";
+    case BBX_EV_DROPPED:   return "DROPPED";
+    case BBX_EV_FAILSAFE:  return "FAILSAFE";
+    default:               return "UNKNOWN";
+  }
+}
+
+static size_t findMagic(const std::vector<uint8_t>& d, size_t from)
+{
+  for (size_t i = from; i + 6 <= d.size(); ++i) {
+    if (memcmp(&d[i], BBX_MAGIC, 4) == 0 && d[i + 4] == BBX_VERSION && d[i + 5] <= BBX_MAX_MOTORS) {
+      return i;
+    }
+  }
+  return d.size();
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <log.bbx> [frames.csv] [events.csv]\n", argv[0]);
+    return 1;
+  }
+
+  FILE* in = fopen(argv[1], "rb");
+  if (!in) { perror(argv[1]); return 1; }
+  std::vector<uint8_t> d;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0) d.insert(d.end(), chunk, chunk + n);
+  fclose(in);
+
+  FILE* out = argc > 2 ? fopen(argv[2], "w") : stdout;
+  FILE* ev  = argc > 3 ? fopen(argv[3], "w") : stderr;
+  if (!out || !ev) { perror("output"); return 1; }
+
+  fprintf(ev, "session,time_us,event,arg\n");
+
+  int session = -1;
+  size_t frames = 0, events = 0, resyncs = 0;
+  size_t pos = findMagic(d, 0);
+
+  while (pos < d.size()) {
+    // Session header
+    uint8_t motors = d[pos + 5];
+    uint8_t fieldCount = BBX_F_FIXED_COUNT + motors + 1;
+    pos += 6;
+    session++;
+
+    fprintf(out, "session,time_us");
+    for (int i = 0; i < BBX_F_FIXED_COUNT; ++i) fprintf(out, ",%s", FIXED_NAMES[i]);
+    for (int m = 0; m < motors; ++m) fprintf(out, ",motor%d", m + 1);
+    fprintf(out, ",mix_flags\n");
+
+    int32_t prev[BBX_MAX_FIELDS] = {0};
+    uint32_t timeUs = 0;
+    bool haveIntra = false;
+
+    while (pos < d.size()) {
+      uint8_t tag = d[pos];
+      if (tag == BBX_MAGIC[0] && findMagic(d, pos) == pos) break;   // next session
+
+      size_t p = pos + 1;
+      uint32_t u = 0;
+      size_t k = bbxGetVarint(&d[0] + p, d.size() - p, &u);
+      bool ok = (k != 0);
+      p += k;
+
+      if (ok && tag == BBX_TAG_EVENT) {
+        uint32_t t = u, arg = 0;
+        ok = p < d.size();
+        if (ok) {
+          uint8_t code = d[p++];
+          k = bbxGetVarint(&d[0] + p, d.size() - p, &arg);
+          ok = (k != 0);
+          p += k;
+          if (ok) {
+            fprintf(ev, "%d,%u,%s,%d\n", session, t, eventName(code), bbxUnzigzag(arg));
+            events++;
+          }
+        }
+      } else if (ok && (tag == BBX_TAG_INTRA || (tag == BBX_TAG_INTER && haveIntra))) {
+        int32_t v[BBX_MAX_FIELDS];
+        for (uint8_t i = 0; i < fieldCount && ok; ++i) {
+          uint32_t z = 0;
+          k = bbxGetVarint(&d[0] + p, d.size() - p, &z);
+          ok = (k != 0);
+          p += k;
+          v[i] = (tag == BBX_TAG_INTRA) ? bbxUnzigzag(z) : prev[i] + bbxUnzigzag(z);
+        }
+        if (ok) {
+          timeUs = (tag == BBX_TAG_INTRA) ? u : timeUs + u;
+          haveIntra = true;
+          memcpy(prev, v, sizeof(prev));
+          fprintf(out, "%d,%u", session, timeUs);
+          for (int i = 0; i < BBX_F_FIXED_COUNT; ++i) fprintf(out, ",%.2f", v[i] / FIXED_SCALES[i]);
+          for (uint8_t i = BBX_F_FIXED_COUNT; i < fieldCount; ++i) fprintf(out, ",%d", v[i]);
+          fprintf(out, "\n");
+          frames++;
+        }
+      } else {
+        ok = false;
+      }
+
+      if (!ok) {
+        // Corrupt or truncated: skip to the next intra frame or session
+        resyncs++;
+        haveIntra = false;
+        do { pos++; } while (pos < d.size() && d[pos] != BBX_TAG_INTRA && d[pos] != BBX_MAGIC[0]);
+        continue;
+      }
+      pos = p;
+    }
+  }
+
+  if (out != stdout) fclose(out);
+  if (ev != stderr) fclose(ev);
+  fprintf(stderr, "decoded %d session(s), %zu frames, %zu events, %zu resyncs\n",
+          session + 1, frames, events, resyncs);
+  return session < 0 ? 2 : 0;
+}
@@ -0,0 +1,211 @@
+// Fixed-point vs float accuracy check for the RX control cores (host side)
+//
+// Build (from host/):
+//   g++ -O2 -std=c++17 -Ishim -I../fhss_RX -o fixed_check fixed_check.cpp
+//       shim/arduino_host.cpp ../fhss_RX/mixer.cpp
+// Usage: fixed_check [seed]
+//
+// Runs the same templates from fhss_RX (ctrl_scalar.h, attitude.h, pid.h,
+// mixer.h) instantiated with float and with q16_t on identical inputs and
+// reports the worst and RMS difference per stage. Exit code 1 if a stage
+// is outside its tolerance.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+#include "ctrl_scalar.h"
+#include "attitude.h"
+#include "pid.h"
+#include "mixer.h"
+
+// Motor outputs: same inputs to the mixer, at most rounding apart
+static const double MOTOR_TOL = 1.0;
+static const double PID_TOL = 2.5;   // dt=1 ms is 65.5 LSB: +-0.8% on D/I
+
+struct ErrStat {
+  double maxAbs = 0.0;
+  double sumSq = 0.0;
+  long n = 0;
+  void add(double e) {
+    e = fabs(e);
+    if (e > maxAbs) maxAbs = e;
+    sumSq += e * e;
+    ++n;
+  }
+  double rms() const { return n ? sqrt(sumSq / n) : 0.0; }
+};
+
+static bool s_fail = false;
+
+static void report(const char* name, const ErrStat& s, double tol, const char* unit) {
+  bool ok = s.maxAbs <= tol;
+  if (!ok) s_fail = true;
+  printf("%-22s max=%10.5f rms=%10.5f %-6s tol=%g  %s\n",
+         name, s.maxAbs, s.rms(), unit, tol, ok ? "ok" : "FAIL");
+}
+
+// Largest motor change per unit of PID output on this frame
+template <typename T>
+static double mixerGain(const MixerCoeffs<T>& c) {
+  double g = 0.0;
+  for (uint8_t i = 0; i < c.count; ++i) {
+    g = fmax(g, fabs(ctrlToFloat(c.roll[i])) + fabs(ctrlToFloat(c.pitch[i])) + fabs(ctrlToFloat(c.yaw[i])));
+  }
+  return g;
+}
+
+static void checkMath() {
+  ErrStat atan2Err, sqrtErr;
+  for (int i = -200; i <= 200; ++i) {
+    for (int j = -200; j <= 200; ++j) {
+      float y = i * 0.1f, x = j * 0.1f;
+      float ref = atan2f(y, x) * 57.2957795f;
+      float q = ctrlToFloat(ctrlAtan2Deg(q16_t(y), q16_t(x)));
+      float e = q - ref;
+      if (e > 180.0f) e -= 360.0f;     // ±180 — один и тот же угол
+      if (e < -180.0f) e += 360.0f;
+      atan2Err.add(e);
+    }
+  }
+  for (int i = 0; i <= 100000; ++i) {
+    float v = i * 0.01f;   // 0..1000 (ay^2 + az^2 at up to ~3 g)
+    sqrtErr.add(ctrlToFloat(ctrlSqrt(q16_t(v))) - sqrtf(v));
+  }
+  report("atan2 (deg)", atan2Err, 0.005, "deg");
+  report("sqrt", sqrtErr, 0.0005, "");
+}
+
+// Synthetic flight: roll/pitch/yaw sweeps, noisy IMU, jittered 1 kHz loop
+struct ImuSample {
+  float ax, ay, az, gx, gy, gz, dt;
+  float sp_roll, sp_pitch, sp_yaw;
+  float throttle;
+};
+
+static ImuSample makeSample(std::mt19937& rng, float t) {
+  std::normal_distribution<float> accN(0.0f, 0.4f), gyroN(0.0f, 0.02f);
+  std::uniform_real_distribution<float> jitter(-50e-6f, 50e-6f);
+  const float D2R = 0.0174532925f;
+  float roll = 30.0f * sinf(1.3f * t), pitch = 20.0f * sinf(0.7f * t + 1.0f);
+  float droll = 30.0f * 1.3f * cosf(1.3f * t), dpitch = 20.0f * 0.7f * cosf(0.7f * t + 1.0f);
+  float r = roll * D2R, p = pitch * D2R;
+  ImuSample s;
+  s.ax = -9.80665f * sinf(p) + accN(rng);
+  s.ay = 9.80665f * sinf(r) * cosf(p) + accN(rng);
+  s.az = 9.80665f * cosf(r) * cosf(p) + accN(rng);
+  s.gx = droll * D2R + gyroN(rng);
+  s.gy = dpitch * D2R + gyroN(rng);
+  s.gz = 90.0f * sinf(0.4f * t) * D2R + gyroN(rng);
+  s.dt = 0.001f + jitter(rng);
+  // Ступеньки уставок каждые 0.5 с
+  int k = (int)(t * 2.0f);
+  s.sp_roll = (float)((k * 7919) % 51 - 25);
+  s.sp_pitch = (float)((k * 104729) % 51 - 25);
+  s.sp_yaw = (float)((k * 1299709) % 301 - 150);
+  s.throttle = 128.0f + 100.0f * sinf(0.2f * t);
+  return s;
+}
+
+template <typename T>
+struct Pipeline {
+  AttitudeFilter<T> att;
+  PIDT<T> roll, pitch, yaw;
+  MixerCoeffs<T> mix;
+
+  void init(const MixerTable& table) {
+    attitudeFilterInit(att, 0.98f);
+    pidInit(roll,  3.0f, 0.5f, 0.08f, -50.0f, 50.0f, -200.0f, 200.0f);
+    pidInit(pitch, 3.0f, 0.5f, 0.08f, -50.0f, 50.0f, -200.0f, 200.0f);
+    pidInit(yaw,   1.2f, 0.5f, 0.02f, -50.0f, 50.0f, -200.0f, 200.0f);
+    mixerLoadCoeffs(table, &mix);
+  }
+
+  // Same order as stabilizeMix()
+  void step(const ImuSample& s, AttitudeT<T>* a, T u[3], uint8_t* motors) {
+    T dt = T(s.dt);
+    attitudeFilterStep(att, T(s.ax), T(s.ay), T(s.az), T(s.gx), T(s.gy), T(s.gz), dt, a);
+    u[0] = pidStep(roll, T(s.sp_roll), a->roll, dt, a->gx);
+    u[1] = pidStep(pitch, T(s.sp_pitch), a->pitch, dt, a->gy);
+    u[2] = pidStep(yaw, T(s.sp_yaw), a->gz, dt);
+    mixerComputeT(mix, T(s.throttle), u[0], u[1], u[2], true, motors);
+  }
+};
+
+static void checkPipeline(uint32_t seed, MixerGeometry g, const char* name) {
+  std::mt19937 rng(seed);
+  Pipeline<float> pf;
+  Pipeline<q16_t> pq;
+  pf.init(mixerTableFor(g));
+  pq.init(mixerTableFor(g));
+
+  ErrStat angErr, rateErr, pidErr, motorErr, mixErr;
+  float t = 0.0f;
+  for (long i = 0; i < 120000; ++i) {   // 2 мин полёта
+    ImuSample s = makeSample(rng, t);
+    t += s.dt;
+    AttitudeT<float> af; AttitudeT<q16_t> aq;
+    float uf[3]; q16_t uq[3];
+    uint8_t mf[MIXER_MAX_MOTORS], mq[MIXER_MAX_MOTORS];
+    pf.step(s, &af, uf, mf);
+    pq.step(s, &aq, uq, mq);
+
+    angErr.add(ctrlToFloat(aq.roll) - af.roll);
+    angErr.add(ctrlToFloat(aq.pitch) - af.pitch);
+    rateErr.add(ctrlToFloat(aq.gz) - af.gz);
+    for (int k = 0; k < 3; ++k) pidErr.add(ctrlToFloat(uq[k]) - uf[k]);
+    for (uint8_t k = 0; k < pf.mix.count; ++k) motorErr.add((int)mq[k] - (int)mf[k]);
+
+    // The fixed PID outputs through the float mixer: the mixer's own share
+    uint8_t mx[MIXER_MAX_MOTORS];
+    mixerComputeT(pf.mix, s.throttle, ctrlToFloat(uq[0]), ctrlToFloat(uq[1]), ctrlToFloat(uq[2]), true, mx);
+    for (uint8_t k = 0; k < pf.mix.count; ++k) mixErr.add((int)mq[k] - (int)mx[k]);
+  }
+
+  printf("-- attitude -> PID -> mixer, %s\n", name);
+  report("attitude roll/pitch", angErr, 0.05, "deg");
+  report("gyro rate", rateErr, 0.001, "deg/s");
+  report("PID output", pidErr, PID_TOL, "PWM");
+  report("motor PWM, same PID", mixErr, MOTOR_TOL, "count");
+  // End to end: the PID difference through the mixer, plus rounding.
+  // Collective shift in saturation moves every motor by the same amount
+  // again, hence 2x.
+  report("motor PWM", motorErr, MOTOR_TOL + 2.0 * PID_TOL * mixerGain(pf.mix), "count");
+}
+
+static void checkMixer(uint32_t seed, MixerGeometry g, const char* name) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> thr(0.0f, 255.0f), cmd(-200.0f, 200.0f);
+  MixerCoeffs<float> cf; MixerCoeffs<q16_t> cq;
+  mixerLoadCoeffs(mixerTableFor(g), &cf);
+  mixerLoadCoeffs(mixerTableFor(g), &cq);
+
+  ErrStat err;
+  long flagDiff = 0;
+  const long N = 200000;
+  for (long i = 0; i < N; ++i) {
+    float t = thr(rng), r = cmd(rng), p = cmd(rng), y = cmd(rng);
+    bool air = (i & 1) != 0;
+    uint8_t of[MIXER_MAX_MOTORS], oq[MIXER_MAX_MOTORS];
+    uint8_t ff = mixerComputeT(cf, t, r, p, y, air, of);
+    uint8_t fq = mixerComputeT(cq, q16_t(t), q16_t(r), q16_t(p), q16_t(y), air, oq);
+    if (ff != fq) ++flagDiff;
+    for (uint8_t k = 0; k < cf.count; ++k) err.add((int)oq[k] - (int)of[k]);
+  }
+  char label[48];
+  snprintf(label, sizeof(label), "mixer %s", name);
+  report(label, err, MOTOR_TOL, "count");
+  printf("%-22s flags differ in %.3f%% of calls (boundary cases)\n", "", 100.0 * flagDiff / N);
+}
+
+int main(int argc, char** argv) {
+  uint32_t seed = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : 1;
+  printf("q16_t = Q15.16, resolution %.2e\n", 1.0 / q16_t::ONE);
+  checkMath();
+  checkMixer(seed, MIXER_QUAD_X, "quadx");
+  checkMixer(seed, MIXER_QUAD_PLUS, "quadplus");
+  checkMixer(seed, MIXER_HEXA_X, "hexa");
+  checkPipeline(seed, MIXER_QUAD_X, "quadx");
+  checkPipeline(seed, MIXER_HEXA_X, "hexa");
+  return s_fail ? 1 : 0;
+}
@@ -0,0 +1,572 @@
+// Ground-station recorder / decoder for the TX binary stream (Linux)
+//
+// Build: g++ -O2 -std=c++17 -o gs_tool gs_tool.cpp
+// Usage: gs_tool record <tty|file|-> <out.gs> [baud]   record raw bytes, show text lines
+//        gs_tool dump <in.gs>                           print every frame
+//        gs_tool csv <in.gs> <prefix>                   prefix_{telemetry,link,events,spectrum}.csv + prefix_log.txt
+//        gs_tool waterfall <tty|file|-> [baud]          spectrum rows (TX survey, nrf_scan binary mode)
+//        gs_tool selftest [seed]                        parser against generated streams
+//
+// A recording is the raw byte stream exactly as it came from the TX, so it
+// can be decoded again with any later version of this tool. Frames are
+// decoded in place (COBS shrinks), the callbacks get views into the
+// buffer: csv/dump run straight over a private mmap of the file.
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <random>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+#include "../fhss_TX/gs_format.h"
+
+struct GsFrameView {
+  uint8_t type, level, seq;
+  uint32_t timeMs;
+  const uint8_t* payload;
+  uint8_t len;
+};
+
+struct GsParseStats {
+  uint64_t frames = 0;
+  uint64_t rejected = 0;     // bad COBS, too short/long, CRC
+  uint64_t rejectedBytes = 0;
+  uint64_t lost = 0;         // seq gaps
+};
+
+class GsParser {
+public:
+  GsParseStats stats;
+
+  // Decodes every complete frame in buf[0..n) in place; returns bytes
+  // consumed (through the last 0x00). The caller keeps the rest.
+  template <class F>
+  size_t parse(uint8_t* buf, size_t n, F&& onFrame)
+  {
+    size_t start = 0;
+    for (size_t i = 0; i < n; ++i) {
+      if (buf[i] != 0) continue;
+      frame(buf + start, i - start, onFrame);
+      start = i + 1;
+    }
+    return start;
+  }
+
+private:
+  int lastSeq_ = -1;
+
+  template <class F>
+  void frame(uint8_t* seg, size_t len, F& onFrame)
+  {
+    if (len == 0) return;
+    size_t n = len <= GS_MAX_ENCODED ? gsCobsDecode(seg, len, seg) : 0;
+    if (n < GS_HEADER + 2 || n > GS_MAX_BODY
+        || gsCrc16(seg, n - 2) != (uint16_t)(seg[n - 2] | seg[n - 1] << 8)) {
+      stats.rejected++;
+      stats.rejectedBytes += len + 1;
+      return;
+    }
+    GsFrameView v;
+    v.type = seg[0];
+    v.level = seg[1];
+    v.seq = seg[2];
+    v.timeMs = (uint32_t)seg[3] | (uint32_t)seg[4] << 8 | (uint32_t)seg[5] << 16 | (uint32_t)seg[6] << 24;
+    v.payload = seg + GS_HEADER;
+    v.len = (uint8_t)(n - GS_HEADER - 2);
+    if (lastSeq_ >= 0) stats.lost += (uint8_t)(v.seq - lastSeq_ - 1);
+    lastSeq_ = v.seq;
+    stats.frames++;
+    onFrame(v);
+  }
+};
+
+// ===== Frame printing / CSV =====
+
+static const char* levelName(uint8_t l)
+{
+  static const char* const names[] = { "E", "W", "I", "D" };
+  return l < 4 ? names[l] : "?";
+}
+
+static const char* eventName(uint8_t code)
+{
+  switch (code) {
+    case GS_EV_SYNC_OK:   return "SYNC_OK";
+    case GS_EV_LINK_LOST: return "LINK_LOST";
+    default:              return "UNKNOWN";
+  }
+}
+
+// GsSpectrum chunks -> one row of levels per sweep (-1 = not in the stream)
+struct SpectrumRow {
+  int level[256];
+  SpectrumRow() { clear(); }
+  void clear() { std::fill(level, level + 256, -1); }
+
+  // true when f completed a sweep
+  bool add(const GsFrameView& f)
+  {
+    if (f.len < 3 || f.len < 3 + f.payload[1]) return false;
+    const uint8_t first = f.payload[0], count = f.payload[1];
+    for (uint8_t i = 0; i < count && first + i < 256; ++i) {
+      uint8_t l = f.payload[3 + i];
+      level[first + i] = l == GS_SPECTRUM_NONE ? -1 : l;
+    }
+    return (f.payload[2] & GS_SPECTRUM_LAST) != 0;
+  }
+
+  int channels() const
+  {
+    int n = 0;
+    for (int ch = 0; ch < 256; ++ch) if (level[ch] >= 0) n = ch + 1;
+    return n;
+  }
+};
+
+template <class T>
+static bool payloadAs(const GsFrameView& f, T* out)
+{
+  if (f.len != sizeof(T)) return false;
+  memcpy(out, f.payload, sizeof(T));
+  return true;
+}
+
+static void printFrame(FILE* out, const GsFrameView& f)
+{
+  fprintf(out, "%10u ", f.timeMs);
+  switch (f.type) {
+    case GS_REC_TEXT:
+      fprintf(out, "%s %.*s\n", levelName(f.level), (int)f.len, (const char*)f.payload);
+      break;
+    case GS_REC_TELEMETRY:
+      if (f.len >= 2) {
+        uint16_t seq = (uint16_t)(f.payload[0] | f.payload[1] << 8);
+        fprintf(out, "TEL %5u %.*s\n", seq, (int)f.len - 2, (const char*)f.payload + 2);
+      }
+      break;
+    case GS_REC_AIR_TELEMETRY:
+      if (f.len >= 3) {
+        uint16_t seq = (uint16_t)(f.payload[1] | f.payload[2] << 8);
+        fprintf(out, "TEL%u %5u %.*s\n", f.payload[0], seq, (int)f.len - 3, (const char*)f.payload + 3);
+      }
+      break;
+    case GS_REC_LINK: {
+      GsLink l;
+      if (payloadAs(f, &l)) {
+        fprintf(out, "LINK sent=%u acked=%u tel=%u ch=%u synced=%u log_dropped=%u (%u ms)\n",
+                l.sent, l.acked, l.telemetry, l.channel, l.synced, l.logDropped, l.periodMs);
+      }
+      break;
+    }
+    case GS_REC_EVENT: {
+      GsEventRec e;
+      if (payloadAs(f, &e)) fprintf(out, "EVENT %s %d\n", eventName(e.code), (int)e.arg);
+      break;
+    }
+    case GS_REC_SPECTRUM:
+      if (f.len >= 3 && f.len >= 3 + f.payload[1]) {
+        fprintf(out, "SPECTRUM %3u..%3u%s", f.payload[0], f.payload[0] + f.payload[1] - 1,
+                f.payload[2] & GS_SPECTRUM_LAST ? " last:" : ":");
+        for (uint8_t i = 0; i < f.payload[1]; ++i) fprintf(out, " %u", f.payload[3 + i]);
+        fprintf(out, "\n");
+      }
+      break;
+    default:
+      fprintf(out, "type %u, %u bytes\n", f.type, f.len);
+  }
+}
+
+struct CsvOut {
+  FILE* tel = nullptr;
+  FILE* link = nullptr;
+  FILE* events = nullptr;
+  FILE* log = nullptr;
+  FILE* spectrum = nullptr;
+  SpectrumRow row;
+};
+
+static void writeTelemetryCsv(CsvOut& o, uint32_t timeMs, unsigned aircraft, uint16_t seq,
+                              const uint8_t* data, size_t len)
+{
+  // "A:1.2:3.4:5.6" -> kind A, up to three values
+  std::string text((const char*)data, len);
+  std::string vals[3];
+  size_t pos = text.find(':');
+  for (int i = 0; i < 3 && pos != std::string::npos; ++i) {
+    size_t next = text.find(':', pos + 1);
+    vals[i] = text.substr(pos + 1, next == std::string::npos ? std::string::npos : next - pos - 1);
+    pos = next;
+  }
+  fprintf(o.tel, "%u,%u,%c,%s,%s,%s,%u\n", timeMs, seq, text.empty() ? '?' : text[0],
+          vals[0].c_str(), vals[1].c_str(), vals[2].c_str(), aircraft);
+}
+
+static void writeCsv(CsvOut& o, const GsFrameView& f)
+{
+  switch (f.type) {
+    case GS_REC_TEXT:
+      fprintf(o.log, "%u %s %.*s\n", f.timeMs, levelName(f.level), (int)f.len, (const char*)f.payload);
+      break;
+    case GS_REC_TELEMETRY:
+      if (f.len >= 2) {
+        writeTelemetryCsv(o, f.timeMs, 0, (uint16_t)(f.payload[0] | f.payload[1] << 8), f.payload + 2, f.len - 2);
+      }
+      break;
+    case GS_REC_AIR_TELEMETRY:
+      if (f.len >= 3) {
+        writeTelemetryCsv(o, f.timeMs, f.payload[0], (uint16_t)(f.payload[1] | f.payload[2] << 8),
+                          f.payload + 3, f.len - 3);
+      }
+      break;
+    case GS_REC_LINK: {
+      GsLink l;
+      if (payloadAs(f, &l)) {
+        fprintf(o.link, "%u,%u,%u,%u,%u,%u,%u,%u\n", f.timeMs, l.periodMs, l.sent, l.acked,
+                l.telemetry, l.logDropped, l.channel, l.synced);
+      }
+      break;
+    }
+    case GS_REC_EVENT: {
+      GsEventRec e;
+      if (payloadAs(f, &e)) fprintf(o.events, "%u,%s,%d\n", f.timeMs, eventName(e.code), (int)e.arg);
+      break;
+    }
+    case GS_REC_SPECTRUM:
+      // time_ms, then one column per channel (empty = not surveyed)
+      if (o.row.add(f)) {
+        fprintf(o.spectrum, "%u", f.timeMs);
+        for (int ch = 0; ch < 126; ++ch) {
+          if (o.row.level[ch] >= 0) fprintf(o.spectrum, ",%d", o.row.level[ch]);
+          else fprintf(o.spectrum, ",");
+        }
+        fprintf(o.spectrum, "\n");
+        o.row.clear();
+      }
+      break;
+  }
+}
+
+static void printStats(const GsParseStats& s)
+{
+  fprintf(stderr, "frames %llu, rejected %llu (%llu bytes), lost %llu\n",
+          (unsigned long long)s.frames, (unsigned long long)s.rejected,
+          (unsigned long long)s.rejectedBytes, (unsigned long long)s.lost);
+}
+
+// ===== Private, writable mapping of a recording (COW: file stays intact) =====
+
+struct Mapped {
+  uint8_t* data = nullptr;
+  size_t size = 0;
+};
+
+static bool mapPrivate(const char* path, Mapped* m)
+{
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) { perror(path); return false; }
+  struct stat st;
+  fstat(fd, &st);
+  m->size = (size_t)st.st_size;
+  if (m->size > 0) {
+    void* p = mmap(nullptr, m->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) { perror("mmap"); close(fd); return false; }
+    m->data = (uint8_t*)p;
+  }
+  close(fd);
+  return true;
+}
+
+static int cmdDump(const char* path)
+{
+  Mapped m;
+  if (!mapPrivate(path, &m)) return 1;
+  GsParser p;
+  p.parse(m.data, m.size, [](const GsFrameView& f) { printFrame(stdout, f); });
+  printStats(p.stats);
+  return 0;
+}
+
+static int cmdCsv(const char* path, const std::string& prefix)
+{
+  Mapped m;
+  if (!mapPrivate(path, &m)) return 1;
+  CsvOut o;
+  o.tel = fopen((prefix + "_telemetry.csv").c_str(), "w");
+  o.link = fopen((prefix + "_link.csv").c_str(), "w");
+  o.events = fopen((prefix + "_events.csv").c_str(), "w");
+  o.log = fopen((prefix + "_log.txt").c_str(), "w");
+  o.spectrum = fopen((prefix + "_spectrum.csv").c_str(), "w");
+  if (!o.tel || !o.link || !o.events || !o.log || !o.spectrum) { perror(prefix.c_str()); return 1; }
+  fprintf(o.tel, "time_ms,rx_seq,kind,v1,v2,v3,aircraft\n");
+  fprintf(o.link, "time_ms,period_ms,sent,acked,telemetry,log_dropped,channel,synced\n");
+  fprintf(o.events, "time_ms,event,arg\n");
+  fprintf(o.spectrum, "time_ms");
+  for (int ch = 0; ch < 126; ++ch) fprintf(o.spectrum, ",ch%d", ch);
+  fprintf(o.spectrum, "\n");
+
+  GsParser p;
+  p.parse(m.data, m.size, [&](const GsFrameView& f) { writeCsv(o, f); });
+  fclose(o.tel); fclose(o.link); fclose(o.events); fclose(o.log); fclose(o.spectrum);
+  printStats(p.stats);
+  return 0;
+}
+
+// ===== Recording: read() straight into a growing shared mapping =====
+
+static volatile sig_atomic_t g_stop = 0;
+static void onSigint(int) { g_stop = 1; }
+
+static speed_t baudFlag(long baud)
+{
+  switch (baud) {
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    default:     return B115200;
+  }
+}
+
+// tty (raw, baud), file or "-" = stdin; -1 on error
+static int openSource(const char* src, long baud)
+{
+  int in = strcmp(src, "-") == 0 ? 0 : open(src, O_RDONLY | O_NOCTTY);
+  if (in < 0) { perror(src); return -1; }
+  struct termios tio;
+  if (tcgetattr(in, &tio) == 0) {   // not a tty (file, pipe): as is
+    cfmakeraw(&tio);
+    cfsetspeed(&tio, baudFlag(baud));
+    tcsetattr(in, TCSANOW, &tio);
+  }
+  return in;
+}
+
+static int cmdRecord(const char* src, const char* dst, long baud)
+{
+  int in = openSource(src, baud);
+  if (in < 0) return 1;
+  int out = open(dst, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (out < 0) { perror(dst); return 1; }
+
+  const size_t CHUNK = 1 << 20;
+  size_t cap = 0, used = 0;
+  uint8_t* map = nullptr;
+  std::vector<uint8_t> pending;   // copy for the live view only
+  GsParser p;
+  signal(SIGINT, onSigint);
+
+  while (!g_stop) {
+    if (used + 4096 > cap) {
+      if (map) munmap(map, cap);
+      cap += CHUNK;
+      if (ftruncate(out, (off_t)cap) != 0) { perror("ftruncate"); break; }
+      map = (uint8_t*)mmap(nullptr, cap, PROT_READ | PROT_WRITE, MAP_SHARED, out, 0);
+      if (map == MAP_FAILED) { perror("mmap"); map = nullptr; break; }
+    }
+    struct pollfd pfd = { in, POLLIN, 0 };
+    if (poll(&pfd, 1, 200) <= 0) continue;
+    ssize_t n = read(in, map + used, cap - used);
+    if (n == 0) break;                       // EOF (file or pipe)
+    if (n < 0) { if (errno == EINTR) continue; perror("read"); break; }
+
+    pending.insert(pending.end(), map + used, map + used + n);
+    used += (size_t)n;
+    size_t done = p.parse(pending.data(), pending.size(), [](const GsFrameView& f) {
+      if (f.type == GS_REC_TEXT || f.type == GS_REC_EVENT) printFrame(stderr, f);
+    });
+    pending.erase(pending.begin(), pending.begin() + done);
+    if (pending.size() > 4 * GS_MAX_ENCODED) pending.clear();   // нет 0x00: не наш поток
+  }
+
+  if (map) munmap(map, cap);
+  if (ftruncate(out, (off_t)used) != 0) perror("ftruncate");
+  close(out);
+  if (in != 0) close(in);
+  fprintf(stderr, "%zu bytes -> %s\n", used, dst);
+  printStats(p.stats);
+  return 0;
+}
+
+// ===== Live waterfall: one text row per spectrum sweep =====
+
+static void printChannelHeader(int channels)
+{
+  fprintf(stdout, "%10s ", "");
+  for (int ch = 0; ch < channels; ++ch) fputc(ch % 10 == 0 ? '0' + ch / 10 % 10 : ' ', stdout);
+  fprintf(stdout, "\n%10s ", "");
+  for (int ch = 0; ch < channels; ++ch) fputc('0' + ch % 10, stdout);
+  fputc('\n', stdout);
+}
+
+static int cmdWaterfall(const char* src, long baud)
+{
+  static const char SHADES[] = " .:-=+*#%@";   // 0 .. 255
+  int in = openSource(src, baud);
+  if (in < 0) return 1;
+  GsParser p;
+  SpectrumRow row;
+  std::vector<uint8_t> pending;
+  uint8_t buf[4096];
+  unsigned rows = 0;
+  signal(SIGINT, onSigint);
+
+  auto onFrame = [&](const GsFrameView& f) {
+    if (f.type == GS_REC_TEXT || f.type == GS_REC_EVENT) printFrame(stderr, f);
+    if (f.type != GS_REC_SPECTRUM || !row.add(f)) return;
+    const int channels = row.channels();
+    if (rows++ % 40 == 0) printChannelHeader(channels);
+    fprintf(stdout, "%10u ", f.timeMs);
+    for (int ch = 0; ch < channels; ++ch) {
+      const int l = row.level[ch];
+      fputc(l < 0 ? '?' : SHADES[l * (sizeof(SHADES) - 2) / 255], stdout);
+    }
+    fputc('\n', stdout);
+    fflush(stdout);
+    row.clear();
+  };
+
+  while (!g_stop) {
+    struct pollfd pfd = { in, POLLIN, 0 };
+    if (poll(&pfd, 1, 200) <= 0) continue;
+    ssize_t n = read(in, buf, sizeof(buf));
+    if (n == 0) break;
+    if (n < 0) { if (errno == EINTR) continue; perror("read"); break; }
+    pending.insert(pending.end(), buf, buf + n);
+    size_t done = p.parse(pending.data(), pending.size(), onFrame);
+    pending.erase(pending.begin(), pending.begin() + done);
+    if (pending.size() > 4 * GS_MAX_ENCODED) pending.clear();
+  }
+  if (in != 0) close(in);
+  printStats(p.stats);
+  return 0;
+}
+
+// ===== Self-test against generated byte streams =====
+
+struct Expected {
+  uint8_t type, seq;
+  uint32_t timeMs;
+  std::vector<uint8_t> payload;
+};
+
+static bool sameFrame(const GsFrameView& f, const Expected& e)
+{
+  return f.type == e.type && f.seq == e.seq && f.timeMs == e.timeMs && f.len == e.payload.size()
+      && memcmp(f.payload, e.payload.data(), f.len) == 0;
+}
+
+static int cmdSelftest(unsigned seed)
+{
+  std::mt19937 rng(seed);
+  int failures = 0;
+
+  // COBS round trip incl. runs longer than 254 non-zero bytes
+  for (int t = 0; t < 200; ++t) {
+    std::vector<uint8_t> in(rng() % 700), enc(in.size() + in.size() / 254 + 2), dec(in.size() + 1);
+    bool zeros = t % 2;
+    for (auto& b : in) b = zeros ? (uint8_t)(rng() % 4) : (uint8_t)(1 + rng() % 255);
+    size_t n = gsCobsEncode(in.data(), in.size(), enc.data());
+    bool ok = memchr(enc.data(), 0, n) == nullptr;
+    size_t m = gsCobsDecode(enc.data(), n, dec.data());
+    ok = ok && m == in.size() && memcmp(in.data(), dec.data(), m) == 0;
+    if (!ok) { fprintf(stderr, "FAIL cobs round trip, %zu bytes\n", in.size()); failures++; }
+  }
+
+  // Stream: boot text, frames, a corrupted frame, a lost frame
+  std::vector<uint8_t> stream;
+  std::vector<Expected> expected;
+  const char* boot = "=== JOYSTICK CALIBRATION ===\r\nCenter calibration - 3 seconds\r\n";
+  stream.insert(stream.end(), boot, boot + strlen(boot));
+  stream.push_back(0);   // gs_stream.cpp opens the stream with a delimiter
+  uint8_t seq = 0;
+  int corrupted = 0, lost = 0;
+  for (int i = 0; i < 2000; ++i) {
+    Expected e;
+    e.type = (uint8_t)(rng() % 4);
+    e.seq = seq++;
+    e.timeMs = (uint32_t)(i * 2 + (rng() % 2));
+    e.payload.resize(rng() % (GS_MAX_PAYLOAD + 1));
+    for (auto& b : e.payload) b = (uint8_t)(rng() % 3 ? rng() : 0);
+    uint8_t frame[GS_MAX_ENCODED + 1];
+    size_t n = gsBuildFrame(e.type, 2, e.seq, e.timeMs, e.payload.data(), (uint8_t)e.payload.size(), frame);
+    if (i % 97 == 50) { lost++; continue; }              // never sent
+    if (i % 89 == 40 && n > 3) {                          // bit error on the wire
+      frame[1 + rng() % (n - 2)] ^= (uint8_t)(1 + rng() % 255);
+      if (std::find(frame, frame + n - 1, 0) == frame + n - 1) {
+        corrupted++;
+        stream.insert(stream.end(), frame, frame + n);
+        continue;
+      }
+      n = gsBuildFrame(e.type, 2, e.seq, e.timeMs, e.payload.data(), (uint8_t)e.payload.size(), frame);
+    }
+    stream.insert(stream.end(), frame, frame + n);
+    expected.push_back(e);
+  }
+
+  // One shot (file) and random chunks (serial) must give the same frames
+  for (int mode = 0; mode < 2; ++mode) {
+    GsParser p;
+    size_t next = 0;
+    bool match = true;
+    auto check = [&](const GsFrameView& f) {
+      if (next >= expected.size() || !sameFrame(f, expected[next])) match = false;
+      next++;
+    };
+    if (mode == 0) {
+      std::vector<uint8_t> buf = stream;
+      p.parse(buf.data(), buf.size(), check);
+    } else {
+      std::vector<uint8_t> pending;
+      for (size_t at = 0; at < stream.size();) {
+        size_t n = std::min(stream.size() - at, (size_t)(1 + rng() % 100));
+        pending.insert(pending.end(), stream.begin() + at, stream.begin() + at + n);
+        at += n;
+        size_t done = p.parse(pending.data(), pending.size(), check);
+        pending.erase(pending.begin(), pending.begin() + done);
+      }
+    }
+    const char* name = mode == 0 ? "one shot" : "chunked";
+    if (!match || next != expected.size()) {
+      fprintf(stderr, "FAIL %s: %zu of %zu frames matched\n", name, next, expected.size());
+      failures++;
+    }
+    // boot text = 1 rejected segment, each corrupted frame 1
+    if (p.stats.rejected != (uint64_t)(1 + corrupted) || p.stats.lost != (uint64_t)(lost + corrupted)) {
+      fprintf(stderr, "FAIL %s stats: rejected %llu (want %d), lost %llu (want %d)\n", name,
+              (unsigned long long)p.stats.rejected, 1 + corrupted,
+              (unsigned long long)p.stats.lost, lost + corrupted);
+      failures++;
+    }
+  }
+
+  printf("selftest: %zu frames, %d corrupted, %d lost: %s\n", expected.size(), corrupted, lost,
+         failures ? "FAIL" : "ok");
+  return failures ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+  std::string cmd = argc > 1 ? argv[1] : "";
+  if (cmd == "record" && argc >= 4) return cmdRecord(argv[2], argv[3], argc > 4 ? atol(argv[4]) : 115200);
+  if (cmd == "dump" && argc >= 3) return cmdDump(argv[2]);
+  if (cmd == "csv" && argc >= 4) return cmdCsv(argv[2], argv[3]);
+  if (cmd == "waterfall" && argc >= 3) return cmdWaterfall(argv[2], argc > 3 ? atol(argv[3]) : 115200);
+  if (cmd == "selftest") return cmdSelftest(argc > 2 ? (unsigned)atoi(argv[2]) : 1);
+
+  fprintf(stderr,
+          "usage: %s record <tty|file|-> <out.gs> [baud]\n"
+          "       %s dump <in.gs>\n"
+          "       %s csv <in.gs> <prefix>\n"
+          "       %s waterfall <tty|file|-> [baud]\n"
+          "       %s selftest [seed]\n", argv[0], argv[0], argv[0], argv[0], argv[0]);
+  return 2;
+}
@@ -0,0 +1,210 @@
+// StreamMux back-to-back check (host side)
+//
+// Build (from host/):
+//   g++ -O2 -std=c++17 -Ishim -I../../NRFFHSS-main/Master -o mux_check mux_check.cpp
+//       shim/arduino_host.cpp ../../NRFFHSS-main/Master/StreamMux.cpp
+// Usage: mux_check [seed]
+//
+// Two StreamMux instances joined by a fake radio with the slot layout of
+// the NRFFHSS example (2 send packets of 15 payload bytes per frame).
+// Every message carries its sequence number and a pattern derived from
+// it, so the receiver sees any message that comes out spliced or short.
+//  - mixed: control (latest only, written every frame right before
+//    FillFrame), telemetry and 200-byte bulk, at 0% and 5% packet loss;
+//    control latency in frames, delivered vs sent, corrupted messages;
+//  - burst: bulk only, 8 packets in a row lost at every offset of a
+//    message: the fragment counter wraps exactly, nothing may be delivered
+//    corrupted.
+// Exit code 1 on a corrupted message, a lost message without packet loss
+// or control latency above 0 frames.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include "StreamMux.h"
+
+static const uint8_t LINK_PACKETS = 2;
+static const uint8_t LINK_PAYLOAD = 15;
+
+// Packet slots of one direction: what RadioMaster sends, RadioSlave gets
+struct HostLink {
+  uint8_t packets[LINK_PACKETS][LINK_PAYLOAD];
+  uint8_t used[LINK_PACKETS];
+  bool isNew[LINK_PACKETS];
+
+  uint8_t GetNumberOfSendPackets() { return LINK_PACKETS; }
+  uint8_t GetNumberOfReceivePackets() { return LINK_PACKETS; }
+  uint8_t GetPacketPayloadSize() { return LINK_PAYLOAD; }
+
+  void AddNextPacketBytes(uint8_t i, const uint8_t* data, uint8_t length) {
+    memcpy(&packets[i][used[i]], data, length);
+    used[i] += length;
+  }
+  bool IsNewPacket(uint8_t i) { return isNew[i]; }
+  void GetNextPacketBytes(uint8_t i, uint8_t* data, uint8_t length) { memcpy(data, packets[i], length); }
+
+  void startFrame() {
+    memset(packets, 0, sizeof(packets));
+    memset(used, 0, sizeof(used));
+  }
+  // Slot on the air unless dropped; returns packets lost
+  int transmit(std::mt19937& rng, double loss, const bool* forceDrop = nullptr) {
+    int lost = 0;
+    for (uint8_t i = 0; i < LINK_PACKETS; ++i) {
+      bool drop = forceDrop ? forceDrop[i] : std::uniform_real_distribution<double>(0, 1)(rng) < loss;
+      isNew[i] = used[i] > 0 && !drop;
+      if (used[i] > 0 && drop) ++lost;
+    }
+    return lost;
+  }
+};
+
+// ===== Messages: [seq lo][seq hi][pattern(seq, stream, i)...] =====
+
+static uint8_t patternByte(uint8_t stream, uint16_t seq, uint16_t i) {
+  return (uint8_t)(seq * 31u + i * 7u + stream * 101u + (i >> 3));
+}
+
+static uint16_t makeMessage(uint8_t* out, uint8_t stream, uint16_t seq, uint16_t length) {
+  out[0] = seq & 0xFF;
+  out[1] = seq >> 8;
+  for (uint16_t i = 2; i < length; ++i) out[i] = patternByte(stream, seq, i);
+  return length;
+}
+
+struct StreamCheck {
+  uint16_t maxLength = 0;
+  uint32_t sent = 0;
+  uint32_t received = 0;
+  uint32_t corrupted = 0;
+  uint16_t lengths[65536];   // by seq
+  uint32_t frameWritten[65536];
+  uint32_t maxLatency = 0;
+};
+
+static StreamCheck s_checks[MUX_STREAMS];
+static uint32_t s_frame = 0;
+
+static void onMessage(uint8_t streamId, const uint8_t* data, uint16_t length) {
+  StreamCheck& c = s_checks[streamId];
+  bool ok = length >= 2;
+  uint16_t seq = ok ? (uint16_t)(data[0] | (data[1] << 8)) : 0;
+  ok = ok && seq < c.sent && c.lengths[seq] == length;
+  for (uint16_t i = 2; ok && i < length; ++i) ok = data[i] == patternByte(streamId, seq, i);
+  if (!ok) {
+    ++c.corrupted;
+    return;
+  }
+  ++c.received;
+  uint32_t latency = s_frame - c.frameWritten[seq];
+  if (latency > c.maxLatency) c.maxLatency = latency;
+}
+
+static bool writeMessage(StreamMux& mux, uint8_t stream, uint16_t length) {
+  StreamCheck& c = s_checks[stream];
+  uint8_t buf[256];
+  makeMessage(buf, stream, (uint16_t)c.sent, length);
+  if (!mux.Write(stream, buf, length)) return false;
+  c.lengths[c.sent] = length;
+  c.frameWritten[c.sent] = s_frame;
+  ++c.sent;
+  return true;
+}
+
+static void resetChecks() {
+  for (StreamCheck& c : s_checks) {
+    c.sent = c.received = c.corrupted = c.maxLatency = 0;
+  }
+  s_frame = 0;
+}
+
+static const uint8_t STREAM_CONTROL = 0;
+static const uint8_t STREAM_TELEMETRY = 3;
+static const uint8_t STREAM_BULK = 5;
+
+static bool s_fail = false;
+
+static void runMixed(unsigned seed, double loss, uint32_t frames) {
+  StreamMux tx, rx;
+  tx.OpenStream(STREAM_CONTROL, 0, 8, 32, true);
+  tx.OpenStream(STREAM_TELEMETRY, 2, 40, 128);
+  tx.OpenStream(STREAM_BULK, 3, 200, 1024);
+  rx.OpenStream(STREAM_CONTROL, 0, 8, 32, true);
+  rx.OpenStream(STREAM_TELEMETRY, 2, 40, 128);
+  rx.OpenStream(STREAM_BULK, 3, 200, 1024);
+  rx.SetHandler(onMessage);
+  resetChecks();
+
+  std::mt19937 rng(seed);
+  HostLink link;
+  uint32_t packets = 0, lostPackets = 0;
+  for (s_frame = 0; s_frame < frames; ++s_frame) {
+    if (s_frame % 5 == 0) writeMessage(tx, STREAM_TELEMETRY, 8 + rng() % 33);
+    while (writeMessage(tx, STREAM_BULK, 2 + rng() % 199)) {}
+    writeMessage(tx, STREAM_CONTROL, 8);   // right before sending, as in Master.ino
+
+    link.startFrame();
+    tx.FillFrame(link);
+    lostPackets += link.transmit(rng, loss);
+    packets += LINK_PACKETS;
+    rx.ReadFrame(link);
+  }
+
+  printf("mixed loss=%4.1f%%  packets lost %u/%u\n", loss * 100.0, lostPackets, packets);
+  const uint8_t ids[] = { STREAM_CONTROL, STREAM_TELEMETRY, STREAM_BULK };
+  const char* names[] = { "control", "telemetry", "bulk" };
+  for (int k = 0; k < 3; ++k) {
+    const StreamCheck& c = s_checks[ids[k]];
+    StreamStats st = rx.GetStats(ids[k]);
+    StreamStats ts = tx.GetStats(ids[k]);
+    // Sent but replaced in the latest-only queue never leave the TX
+    uint32_t onAir = ts.sentMessages;
+    bool ok = c.corrupted == 0 && (loss > 0.0 || c.received == onAir) &&
+              (ids[k] != STREAM_CONTROL || c.maxLatency == 0);
+    if (!ok) s_fail = true;
+    printf("  %-10s sent=%6u received=%6u lost=%5u corrupted=%u max_latency=%u frames  %s\n", names[k],
+           onAir, c.received, st.lostMessages, c.corrupted, c.maxLatency, ok ? "ok" : "FAIL");
+  }
+}
+
+// 8 lost packets = 8 lost bulk segments: the 3-bit counter comes round
+static void runBurst(unsigned seed) {
+  uint32_t corrupted = 0, received = 0, lost = 0, runs = 0;
+  for (uint32_t offset = 0; offset < 64; ++offset) {
+    StreamMux tx, rx;
+    tx.OpenStream(STREAM_BULK, 3, 200, 1024);
+    rx.OpenStream(STREAM_BULK, 3, 200, 1024);
+    rx.SetHandler(onMessage);
+    resetChecks();
+
+    std::mt19937 rng(seed + offset);
+    HostLink link;
+    uint32_t packet = 0;
+    for (s_frame = 0; s_frame < 200; ++s_frame) {
+      while (writeMessage(tx, STREAM_BULK, 100 + rng() % 101)) {}
+      link.startFrame();
+      tx.FillFrame(link);
+      bool drop[LINK_PACKETS];
+      for (uint8_t i = 0; i < LINK_PACKETS; ++i, ++packet) drop[i] = packet >= 40 + offset && packet < 48 + offset;
+      link.transmit(rng, 0.0, drop);
+      rx.ReadFrame(link);
+    }
+    corrupted += s_checks[STREAM_BULK].corrupted;
+    received += s_checks[STREAM_BULK].received;
+    lost += rx.GetStats(STREAM_BULK).lostMessages;
+    ++runs;
+  }
+  bool ok = corrupted == 0;
+  if (!ok) s_fail = true;
+  printf("burst 8 packets x %u offsets  received=%u lost=%u corrupted=%u  %s\n", runs, received, lost,
+         corrupted, ok ? "ok" : "FAIL");
+}
+
+int main(int argc, char** argv) {
+  unsigned seed = argc > 1 ? (unsigned)atoi(argv[1]) : 1;
+  runMixed(seed, 0.0, 20000);
+  runMixed(seed, 0.05, 20000);
+  runBurst(seed);
+  return s_fail ? 1 : 0;
+}
@@ -0,0 +1,304 @@
+// Golden-trace replay for the RX stabilizer pipeline (host side)
+//
+// Build (from host/):
+//   g++ -O2 -std=c++17 -Ishim -I../fhss_RX -o replay replay.cpp shim/arduino_host.cpp
+//       ../fhss_RX/stabilizer.cpp ../fhss_RX/attitude.cpp ../fhss_RX/altitude.cpp
+//       ../fhss_RX/mixer.cpp ../fhss_RX/autotune.cpp ../fhss_RX/failsafe.cpp
+// Usage: replay [--bless] [--tol N] [--max-over N] [--reps N] [--max-ns N] trace...
+//
+// A trace (recorded with `sil --record`) is the JoystickData, TelemetryData,
+// dt and micros() of every stabilizeMix() call of one run, followed on each
+// line by the motor outputs that call is expected to give. Replay feeds the
+// inputs through stabilizeMix() open loop and compares the outputs: a
+// change to attitude.cpp, pid.h, stabilizer.cpp or mixer.cpp that alters
+// behaviour shows up as motors outside --tol on some step. Then the same
+// steps run --reps more times for ns per step and heap allocations per
+// step (malloc is counted while stabilizeMix() runs; the loop must not
+// allocate). --bless rewrites the expected outputs from the current code.
+// Exit code 1 if any trace differs or is slower than --max-ns.
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include "stabilizer.h"
+#include "mixer.h"
+#include "failsafe.h"
+
+// ===== Heap accounting (glibc: wrap the allocator entry points) =====
+
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+
+static bool s_counting = false;
+static uint64_t s_allocs = 0;
+static uint64_t s_allocBytes = 0;
+
+extern "C" void* malloc(size_t n)
+{
+  if (s_counting) { s_allocs++; s_allocBytes += n; }
+  return __libc_malloc(n);
+}
+
+extern "C" void* calloc(size_t n, size_t size)
+{
+  if (s_counting) { s_allocs++; s_allocBytes += n * size; }
+  return __libc_calloc(n, size);
+}
+
+extern "C" void* realloc(void* p, size_t n)
+{
+  if (s_counting) { s_allocs++; s_allocBytes += n; }
+  return __libc_realloc(p, n);
+}
+
+// ===== Trace =====
+
+struct Step {
+  uint32_t us;
+  float dt;
+  JoystickData js;
+  TelemetryData sens;
+  uint8_t expected[MIXER_MAX_MOTORS];
+  bool hasExpected;
+};
+
+struct Trace {
+  std::string path;
+  std::vector<std::string> header;   // comment / geometry lines, kept by --bless
+  std::vector<std::string> inputs;   // input part of each step line, kept verbatim
+  MixerGeometry geometry = MIXER_QUAD_X;
+  std::vector<Step> steps;
+};
+
+static bool parseGeometry(const std::string& g, MixerGeometry* out)
+{
+  if (g == "quadx") *out = MIXER_QUAD_X;
+  else if (g == "quadplus") *out = MIXER_QUAD_PLUS;
+  else if (g == "hexa") *out = MIXER_HEXA_X;
+  else return false;
+  return true;
+}
+
+static bool loadTrace(const std::string& path, Trace* tr, std::string* err)
+{
+  std::ifstream f(path);
+  if (!f) {
+    *err = "cannot open";
+    return false;
+  }
+  tr->path = path;
+  std::string line;
+  int lineNo = 0;
+  while (std::getline(f, line)) {
+    lineNo++;
+    if (line.empty() || line[0] == '#') {
+      tr->header.push_back(line);
+      continue;
+    }
+    if (line.compare(0, 9, "geometry ") == 0) {
+      if (!parseGeometry(line.substr(9), &tr->geometry)) {
+        *err = "line " + std::to_string(lineNo) + ": unknown geometry";
+        return false;
+      }
+      tr->header.push_back(line);
+      continue;
+    }
+
+    const size_t bar = line.find('|');
+    const std::string in = line.substr(0, bar == std::string::npos ? line.size() : bar);
+    Step s = {};
+    int lx, ly, rx, ry, range;
+    if (sscanf(in.c_str(), "%u %f %d %d %d %d %f %f %f %f %f %f %f %d", &s.us, &s.dt, &lx, &ly, &rx, &ry,
+               &s.sens.accel_x, &s.sens.accel_y, &s.sens.accel_z, &s.sens.gyro_x, &s.sens.gyro_y,
+               &s.sens.gyro_z, &s.sens.pressure, &range) != 14) {
+      *err = "line " + std::to_string(lineNo) + ": bad step";
+      return false;
+    }
+    s.js.x_left = (int16_t)lx;
+    s.js.y_left = (int16_t)ly;
+    s.js.x_right = (int16_t)rx;
+    s.js.y_right = (int16_t)ry;
+    s.sens.range_mm = (int16_t)range;
+
+    if (bar != std::string::npos) {
+      std::istringstream out(line.substr(bar + 1));
+      unsigned m;
+      uint8_t n = 0;
+      while (n < MIXER_MAX_MOTORS && out >> m) s.expected[n++] = (uint8_t)m;
+      s.hasExpected = n > 0;
+    }
+    // Trailing spaces before '|' are not part of the input
+    tr->inputs.push_back(in.substr(0, in.find_last_not_of(' ') + 1));
+    tr->steps.push_back(s);
+  }
+  return true;
+}
+
+static bool saveTrace(const Trace& tr, const std::vector<uint8_t>& motors, uint8_t motorCount)
+{
+  FILE* f = fopen(tr.path.c_str(), "w");
+  if (!f) return false;
+  for (const std::string& h : tr.header) fprintf(f, "%s\n", h.c_str());
+  for (size_t i = 0; i < tr.steps.size(); ++i) {
+    fprintf(f, "%s |", tr.inputs[i].c_str());
+    for (uint8_t m = 0; m < motorCount; ++m) fprintf(f, " %u", motors[i * motorCount + m]);
+    fprintf(f, "\n");
+  }
+  return fclose(f) == 0;
+}
+
+// ===== Replay =====
+
+// Same state the RX has after setup(): altitude hold off, no descent
+static void resetPipeline(MixerGeometry g)
+{
+  hostSetMicros(0);
+  mixerInit(g);
+  stabilizerInit();
+  failsafeInit();
+  stabilizerSetAltHold(false);
+}
+
+// One pass over the trace; outputs go to motors[] (steps * motorCount)
+static void runOnce(const Trace& tr, uint8_t motorCount, std::vector<uint8_t>* motors)
+{
+  resetPipeline(tr.geometry);
+  uint8_t out[MIXER_MAX_MOTORS];
+  for (size_t i = 0; i < tr.steps.size(); ++i) {
+    const Step& s = tr.steps[i];
+    hostSetMicros(s.us);
+    s_counting = true;
+    stabilizeMix(s.js, s.sens, s.dt, out);
+    s_counting = false;
+    if (motors) memcpy(&(*motors)[i * motorCount], out, motorCount);
+  }
+}
+
+struct Options {
+  bool bless = false;
+  int tol = 1;            // PWM counts per motor
+  long maxOver = 0;       // steps allowed outside tol
+  int reps = 20;
+  double maxNs = 0.0;     // 0 = no limit
+};
+
+static bool replayTrace(const Trace& tr, const Options& opt)
+{
+  mixerInit(tr.geometry);
+  const uint8_t motorCount = mixerMotorCount();
+  const size_t n = tr.steps.size();
+  std::vector<uint8_t> motors(n * motorCount);
+
+  s_allocs = s_allocBytes = 0;
+  runOnce(tr, motorCount, &motors);
+
+  // Compare against the golden outputs
+  int maxDiff = 0;
+  long over = 0, missing = 0;
+  long firstOver = -1;
+  for (size_t i = 0; i < n; ++i) {
+    const Step& s = tr.steps[i];
+    if (!s.hasExpected) { missing++; continue; }
+    int stepDiff = 0;
+    for (uint8_t m = 0; m < motorCount; ++m) {
+      stepDiff = std::max(stepDiff, abs((int)motors[i * motorCount + m] - (int)s.expected[m]));
+    }
+    maxDiff = std::max(maxDiff, stepDiff);
+    if (stepDiff > opt.tol) {
+      if (firstOver < 0) firstOver = (long)i;
+      over++;
+    }
+  }
+
+  // Timing: whole passes, reset outside the clock
+  double ns = 0.0;
+  for (int r = 0; r < opt.reps; ++r) {
+    resetPipeline(tr.geometry);
+    auto t0 = std::chrono::steady_clock::now();
+    uint8_t out[MIXER_MAX_MOTORS];
+    for (const Step& s : tr.steps) {
+      hostSetMicros(s.us);
+      s_counting = true;
+      stabilizeMix(s.js, s.sens, s.dt, out);
+      s_counting = false;
+    }
+    ns += (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+  }
+  const double steps = (double)n * (opt.reps + 1);
+  const double nsPerStep = opt.reps > 0 && n ? ns / ((double)n * opt.reps) : 0.0;
+
+  bool ok = true;
+  const char* verdict = "ok";
+  if (opt.bless) {
+    ok = saveTrace(tr, motors, motorCount);
+    verdict = ok ? "blessed" : "WRITE FAILED";
+  } else if (missing) {
+    ok = false;
+    verdict = "NO GOLDEN (run --bless)";
+  } else if (over > opt.maxOver) {
+    ok = false;
+    verdict = "DIFF";
+  } else if (opt.maxNs > 0.0 && nsPerStep > opt.maxNs) {
+    ok = false;
+    verdict = "SLOW";
+  }
+
+  printf("%-28s steps=%zu motors=%u max_diff=%d over_tol=%ld ns/step=%.0f allocs/step=%.3f bytes/step=%.1f  %s\n",
+         tr.path.c_str(), n, motorCount, maxDiff, over, nsPerStep,
+         steps ? s_allocs / steps : 0.0, steps ? s_allocBytes / steps : 0.0, verdict);
+  if (!opt.bless && firstOver >= 0) {
+    const Step& s = tr.steps[firstOver];
+    printf("  first step over tol: #%ld us=%u got", firstOver, s.us);
+    for (uint8_t m = 0; m < motorCount; ++m) printf(" %u", motors[firstOver * motorCount + m]);
+    printf(" expected");
+    for (uint8_t m = 0; m < motorCount; ++m) printf(" %u", s.expected[m]);
+    printf("\n");
+  }
+  return ok;
+}
+
+static void usage(const char* argv0)
+{
+  printf("usage: %s [options] trace...\n"
+         "  --bless        write the current outputs as the golden ones\n"
+         "  --tol N        allowed difference per motor, PWM counts (default 1)\n"
+         "  --max-over N   steps allowed outside --tol (default 0)\n"
+         "  --reps N       timing passes (default 20)\n"
+         "  --max-ns N     fail if slower than N ns per step (default: no limit)\n", argv0);
+}
+
+int main(int argc, char** argv)
+{
+  Options opt;
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (a == "--bless") opt.bless = true;
+    else if (a == "--tol" && hasValue) opt.tol = atoi(argv[++i]);
+    else if (a == "--max-over" && hasValue) opt.maxOver = atol(argv[++i]);
+    else if (a == "--reps" && hasValue) opt.reps = atoi(argv[++i]);
+    else if (a == "--max-ns" && hasValue) opt.maxNs = atof(argv[++i]);
+    else if (a.compare(0, 2, "--") == 0) { usage(argv[0]); return 2; }
+    else paths.push_back(a);
+  }
+  if (paths.empty()) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  bool allOk = true;
+  for (const std::string& p : paths) {
+    Trace tr;
+    std::string err;
+    if (!loadTrace(p, &tr, &err)) {
+      fprintf(stderr, "%s: %s\n", p.c_str(), err.c_str());
+      return 2;
+    }
+    allOk &= replayTrace(tr, opt);
+  }
+  return allOk ? 0 : 1;
+}
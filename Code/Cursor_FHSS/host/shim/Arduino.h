@@ -0,0 +1,75 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Minimal Arduino API for building fhss_RX modules on Linux (host/).
+// Time is driven by the host program through hostSetMicros(), so a
+// simulation runs as fast as the CPU allows.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <stdarg.h>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+#define OUTPUT 1
+#define INPUT  0
+#define LOW    0
+#define HIGH   1
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+// Print writes to stdout; enough for the modules' diagnostic dumps
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+  size_t print(const char* s) { return (size_t)fputs(s, stdout); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v) { return (size_t)printf("%d", v); }
+  size_t print(unsigned v) { return (size_t)printf("%u", v); }
+  size_t print(long v) { return (size_t)printf("%ld", v); }
+  size_t print(unsigned long v) { return (size_t)printf("%lu", v); }
+  size_t print(double v, int digits = 2) { return (size_t)printf("%.*f", digits, v); }
+  template <typename T> size_t println(T v) { size_t n = print(v); return n + println(); }
+  size_t println(double v, int digits) { size_t n = print(v, digits); return n + println(); }
+  size_t println() { return print("\r\n"); }
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern Print Serial;
+
+void pinMode(uint8_t pin, uint8_t mode);
+void analogWrite(uint8_t pin, int value);
+
+// ====== ESP32 core, enough to compile NRFFHSS RadioSlave (bench) ======
+#define FALLING 2
+#define ARDUINO_ISR_ATTR
+#define digitalPinToInterrupt(p) (p)
+inline void attachInterrupt(uint8_t, void (*)(), int) {}
+
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(m)     ((void)(m))
+#define portEXIT_CRITICAL(m)      ((void)(m))
+#define portENTER_CRITICAL_ISR(m) ((void)(m))
+#define portEXIT_CRITICAL_ISR(m)  ((void)(m))
+typedef void* TaskHandle_t;
+struct hw_timer_t;
+
+// ====== Host-only hooks ======
+void hostSetMicros(uint64_t us);
+uint64_t hostMicros();
+int hostAnalogValue(uint8_t pin);   // last analogWrite() value, -1 if never written
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,39 @@
+#ifndef HOST_RF24_H
+#define HOST_RF24_H
+
+// RF24 with no radio behind it: every call is a no-op, nothing is ever
+// received. Lets host/bench compile NRFFHSS RadioSlave for its packet code.
+
+#include "Arduino.h"
+
+class SPIClass {
+public:
+  void begin() {}
+};
+#define _SPI SPIClass
+
+typedef enum { RF24_1MBPS = 0, RF24_2MBPS, RF24_250KBPS } rf24_datarate_e;
+
+class RF24 {
+public:
+  bool begin(_SPI*, uint8_t, uint8_t) { return true; }
+  bool available() { return false; }
+  void read(void*, uint8_t) {}
+  bool write(const void*, uint8_t) { return true; }
+  void startListening() {}
+  void stopListening() {}
+  void powerDown() {}
+  void powerUp() {}
+  void setPALevel(uint8_t) {}
+  void setAddressWidth(uint8_t) {}
+  void openReadingPipe(uint8_t, const uint8_t*) {}
+  void openWritingPipe(const uint8_t*) {}
+  bool setDataRate(rf24_datarate_e) { return true; }
+  void setAutoAck(bool) {}
+  void setRetries(uint8_t, uint8_t) {}
+  void setPayloadSize(uint8_t) {}
+  void setChannel(uint8_t) {}
+  void maskIRQ(bool, bool, bool) {}
+};
+
+#endif // HOST_RF24_H
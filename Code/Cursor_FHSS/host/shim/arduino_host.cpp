@@ -0,0 +1,41 @@
+#include "Arduino.h"
+
+Print Serial;
+
+size_t Print::printf(const char* fmt, ...)
+{
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vprintf(fmt, ap);
+  va_end(ap);
+  return n < 0 ? 0 : (size_t)n;
+}
+
+static uint64_t s_micros = 0;
+static int s_analog[64];
+static bool s_analogInit = false;
+
+void hostSetMicros(uint64_t us) { s_micros = us; }
+uint64_t hostMicros() { return s_micros; }
+
+uint32_t millis() { return (uint32_t)(s_micros / 1000); }
+uint32_t micros() { return (uint32_t)s_micros; }
+void delay(uint32_t ms) { s_micros += (uint64_t)ms * 1000; }
+void delayMicroseconds(uint32_t us) { s_micros += us; }
+
+void pinMode(uint8_t, uint8_t) {}
+
+void analogWrite(uint8_t pin, int value)
+{
+  if (!s_analogInit) {
+    for (int i = 0; i < 64; ++i) s_analog[i] = -1;
+    s_analogInit = true;
+  }
+  if (pin < 64) s_analog[pin] = value;
+}
+
+int hostAnalogValue(uint8_t pin)
+{
+  if (!s_analogInit || pin >= 64) return -1;
+  return s_analog[pin];
+}
@@ -0,0 +1,15 @@
+// NRFFHSS FrameTimer on the host clock: WaitUntil() just moves micros() on
+#include "FrameTimer.h"
+
+void FrameTimer::Begin() {}
+
+uint64_t FrameTimer::Now()
+{
+  return hostMicros() * FRAME_TICKS_PER_US;
+}
+
+void FrameTimer::WaitUntil(uint64_t tick)
+{
+  const uint64_t us = tick / FRAME_TICKS_PER_US;
+  if (us > hostMicros()) hostSetMicros(us);
+}
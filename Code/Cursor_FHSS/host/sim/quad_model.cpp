@@ -0,0 +1,197 @@
+#include "quad_model.h"
+
+static const double G = 9.80665;
+static const double RAD2DEG = 57.29577951308232;
+
+// Rotate v by unit quaternion q (w, x, y, z): body -> world
+static void rotate(const double q[4], const double v[3], double out[3])
+{
+  double w = q[0], x = q[1], y = q[2], z = q[3];
+  double tx = 2.0 * (y * v[2] - z * v[1]);
+  double ty = 2.0 * (z * v[0] - x * v[2]);
+  double tz = 2.0 * (x * v[1] - y * v[0]);
+  out[0] = v[0] + w * tx + (y * tz - z * ty);
+  out[1] = v[1] + w * ty + (z * tx - x * tz);
+  out[2] = v[2] + w * tz + (x * ty - y * tx);
+}
+
+// World -> body
+static void rotateInv(const double q[4], const double v[3], double out[3])
+{
+  double qc[4] = { q[0], -q[1], -q[2], -q[3] };
+  rotate(qc, v, out);
+}
+
+QuadModel::QuadModel(const QuadParams& p, const ImuParams& imu, const MixerTable& table, uint32_t seed)
+  : p_(p), imu_(imu), table_(table), rng_(seed)
+{
+  reset();
+}
+
+void QuadModel::reset()
+{
+  for (int i = 0; i < 3; ++i) {
+    pos_[i] = vel_[i] = w_[i] = accWorld_[i] = 0.0;
+    extTorque_[i] = extForce_[i] = 0.0;
+  }
+  q_[0] = 1.0; q_[1] = q_[2] = q_[3] = 0.0;
+  for (int i = 0; i < MIXER_MAX_MOTORS; ++i) speed_[i] = 0.0;
+  vibPhase_ = 0.0;
+  time_ = baroNext_ = tofNext_ = 0.0;
+  baroHeld_ = 0.0f;
+  tofHeld_ = -1;
+}
+
+double QuadModel::thrustAt(double s) const
+{
+  return p_.thrustMax * ((1.0 - p_.thrustExpo) * s + p_.thrustExpo * s * s);
+}
+
+double QuadModel::hoverPwm() const
+{
+  // Solve thrustAt(s) = m*g/n for s, then invert the deadband
+  double t = p_.mass * G / table_.count / p_.thrustMax;
+  double a = p_.thrustExpo, b = 1.0 - p_.thrustExpo;
+  double s = (a > 1e-9) ? (-b + sqrt(b * b + 4.0 * a * t)) / (2.0 * a) : t;
+  double u = p_.motorDeadband + s * (1.0 - p_.motorDeadband);
+  return u * 255.0;
+}
+
+void QuadModel::setDisturbance(const double torqueBody[3], const double forceWorld[3])
+{
+  for (int i = 0; i < 3; ++i) {
+    extTorque_[i] = torqueBody[i];
+    extForce_[i] = forceWorld[i];
+  }
+}
+
+void QuadModel::step(double dt, const uint8_t* pwm)
+{
+  // Motors: deadband, first-order lag, thrust curve
+  double k = 1.0 - exp(-dt / p_.motorTau);
+  double thrust = 0.0, meanSpeed = 0.0;
+  double tau[3] = { 0.0, 0.0, 0.0 };
+  for (uint8_t i = 0; i < table_.count; ++i) {
+    double u = pwm[i] / 255.0;
+    double target = (u - p_.motorDeadband) / (1.0 - p_.motorDeadband);
+    if (target < 0.0) target = 0.0;
+    speed_[i] += (target - speed_[i]) * k;
+    double t = thrustAt(speed_[i]);
+    const MixerRule& r = table_.rules[i];
+    thrust += t;
+    tau[0] += r.roll * p_.armOffset * t;
+    tau[1] -= r.pitch * p_.armOffset * t;
+    tau[2] += r.yaw * p_.yawTorquePerThrust * t;
+    meanSpeed += speed_[i];
+  }
+  meanSpeed /= table_.count;
+  time_ += dt;
+  vibPhase_ += 2.0 * M_PI * imu_.vibrationHz * meanSpeed * dt;
+
+  // Translation
+  double fb[3] = { 0.0, 0.0, thrust };
+  double fw[3];
+  rotate(q_, fb, fw);
+  for (int a = 0; a < 3; ++a) {
+    accWorld_[a] = (fw[a] - p_.linearDrag * vel_[a] + extForce_[a]) / p_.mass;
+  }
+  accWorld_[2] -= G;
+
+  // Ground contact: sits still until thrust exceeds weight
+  if (pos_[2] <= 0.0 && accWorld_[2] <= 0.0) {
+    for (int a = 0; a < 3; ++a) { vel_[a] = 0.0; accWorld_[a] = 0.0; w_[a] = 0.0; }
+    pos_[2] = 0.0;
+    return;
+  }
+
+  // Rotation: Euler's equations in body frame
+  const double* I = p_.inertia;
+  double Iw[3] = { I[0] * w_[0], I[1] * w_[1], I[2] * w_[2] };
+  double gyroTerm[3] = {
+    w_[1] * Iw[2] - w_[2] * Iw[1],
+    w_[2] * Iw[0] - w_[0] * Iw[2],
+    w_[0] * Iw[1] - w_[1] * Iw[0],
+  };
+  for (int a = 0; a < 3; ++a) {
+    double t = tau[a] - p_.angularDrag * w_[a] + extTorque_[a] - gyroTerm[a];
+    w_[a] += t / I[a] * dt;
+  }
+
+  double qw = q_[0], qx = q_[1], qy = q_[2], qz = q_[3];
+  q_[0] += 0.5 * dt * (-qx * w_[0] - qy * w_[1] - qz * w_[2]);
+  q_[1] += 0.5 * dt * ( qw * w_[0] + qy * w_[2] - qz * w_[1]);
+  q_[2] += 0.5 * dt * ( qw * w_[1] - qx * w_[2] + qz * w_[0]);
+  q_[3] += 0.5 * dt * ( qw * w_[2] + qx * w_[1] - qy * w_[0]);
+  double n = sqrt(q_[0] * q_[0] + q_[1] * q_[1] + q_[2] * q_[2] + q_[3] * q_[3]);
+  for (int i = 0; i < 4; ++i) q_[i] /= n;
+
+  for (int a = 0; a < 3; ++a) {
+    vel_[a] += accWorld_[a] * dt;
+    pos_[a] += vel_[a] * dt;
+  }
+}
+
+void QuadModel::readImu(TelemetryData* out)
+{
+  double meanSpeed = 0.0;
+  for (uint8_t i = 0; i < table_.count; ++i) meanSpeed += speed_[i];
+  meanSpeed /= table_.count;
+
+  // Specific force seen by the accelerometer: R^T (a - g)
+  double sw[3] = { accWorld_[0], accWorld_[1], accWorld_[2] + G };
+  double sb[3];
+  rotateInv(q_, sw, sb);
+
+  double acc[3], gyr[3];
+  for (int a = 0; a < 3; ++a) {
+    double ph = vibPhase_ + a * 2.1;
+    acc[a] = sb[a] + imu_.accelBias[a] + imu_.accelNoise * norm_(rng_)
+           + imu_.vibrationAccel * meanSpeed * sin(ph);
+    gyr[a] = w_[a] + imu_.gyroBias[a] + imu_.gyroNoise * norm_(rng_)
+           + imu_.vibrationGyro * meanSpeed * sin(ph + 0.7);
+  }
+
+  out->accel_x = (float)acc[0];
+  out->accel_y = (float)acc[1];
+  out->accel_z = (float)acc[2];
+  out->gyro_x = (float)gyr[0];
+  out->gyro_y = (float)gyr[1];
+  out->gyro_z = (float)gyr[2];
+
+  // Slow sensors: new sample at their own rate, held in between
+  if (time_ >= baroNext_) {
+    baroNext_ = time_ + 1.0 / imu_.baroRateHz;
+    baroHeld_ = (float)(1013.25 * pow(1.0 - 2.25577e-5 * pos_[2], 5.25588)
+                        + imu_.pressureNoise * norm_(rng_));
+  }
+  out->pressure = baroHeld_;
+
+  if (imu_.hasTof && time_ >= tofNext_) {
+    tofNext_ = time_ + 1.0 / imu_.tofRateHz;
+    double down[3] = { 0.0, 0.0, -1.0 }, dw[3];
+    rotate(q_, down, dw);                       // body -z in world
+    double mm = dw[2] < -0.1 ? (pos_[2] + 0.01) / -dw[2] * 1000.0 : 1e9;
+    mm += imu_.tofNoiseMm * norm_(rng_);
+    tofHeld_ = (mm > 0.0 && mm <= imu_.tofMaxMm) ? (int16_t)lround(mm) : -1;
+  }
+  out->range_mm = imu_.hasTof ? tofHeld_ : -1;
+}
+
+double QuadModel::rollDeg() const
+{
+  return atan2(2.0 * (q_[0] * q_[1] + q_[2] * q_[3]),
+               1.0 - 2.0 * (q_[1] * q_[1] + q_[2] * q_[2])) * RAD2DEG;
+}
+
+double QuadModel::pitchUpDeg() const
+{
+  double s = 2.0 * (q_[0] * q_[2] - q_[3] * q_[1]);
+  if (s > 1.0) s = 1.0;
+  if (s < -1.0) s = -1.0;
+  return -asin(s) * RAD2DEG;
+}
+
+double QuadModel::yawRateDps() const
+{
+  return w_[2] * RAD2DEG;
+}
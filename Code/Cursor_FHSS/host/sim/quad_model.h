@@ -0,0 +1,82 @@
+#ifndef QUAD_MODEL_H
+#define QUAD_MODEL_H
+
+// Rigid-body quadrotor (or hexa) model for the SIL simulator.
+// Body frame: x forward, y left, z up. Motor positions and spin directions
+// are taken from the firmware mixer table, so the model always matches the
+// geometry the stabilizer was built for.
+
+#include <stdint.h>
+#include <random>
+#include "mixer.h"
+#include "telemetry.h"
+
+struct QuadParams {
+  double mass = 0.080;               // kg (brushed micro quad)
+  double inertia[3] = { 6.0e-5, 6.0e-5, 1.1e-4 };  // kg*m^2
+  double armOffset = 0.032;          // m per unit of mixer roll/pitch factor
+  double thrustMax = 0.35;           // N per motor at full speed
+  double thrustExpo = 0.7;           // T = Tmax*((1-e)*s + e*s^2)
+  double motorDeadband = 0.05;       // PWM fraction before the motor spins
+  double motorTau = 0.030;           // s, first-order spin-up lag
+  double yawTorquePerThrust = 0.006; // m
+  double linearDrag = 0.05;          // N/(m/s)
+  double angularDrag = 2.0e-5;       // N*m/(rad/s)
+};
+
+struct ImuParams {
+  double gyroNoise = 0.01;           // rad/s rms
+  double accelNoise = 0.15;          // m/s^2 rms
+  double gyroBias[3] = { 0.01, -0.008, 0.005 };  // rad/s
+  double accelBias[3] = { 0.05, -0.04, 0.08 };   // m/s^2
+  double vibrationGyro = 0.05;       // rad/s amplitude at full speed
+  double vibrationAccel = 1.5;       // m/s^2 amplitude at full speed
+  double vibrationHz = 180.0;        // at full speed, scales with motor speed
+  double pressureNoise = 0.03;       // hPa rms
+  double baroRateHz = 25.0;          // BMP280 output rate, held between samples
+  bool   hasTof = true;              // VL53L0X pointing down
+  double tofRateHz = 30.0;
+  double tofNoiseMm = 5.0;
+  double tofMaxMm = 1200.0;
+};
+
+class QuadModel {
+public:
+  QuadModel(const QuadParams& p, const ImuParams& imu, const MixerTable& table, uint32_t seed);
+
+  void reset();
+  void step(double dt, const uint8_t* pwm);
+  void setDisturbance(const double torqueBody[3], const double forceWorld[3]);
+  void readImu(TelemetryData* out);
+
+  // Truth, in the firmware's conventions
+  double rollDeg() const;        // + = left side up
+  double pitchUpDeg() const;     // + = nose up
+  double yawRateDps() const;     // + = counter-clockwise from above
+  double altitude() const { return pos_[2]; }
+  double climbRate() const { return vel_[2]; }
+  double motorSpeed(uint8_t i) const { return speed_[i]; }
+
+  double hoverPwm() const;       // steady PWM that balances weight
+
+private:
+  double thrustAt(double speed) const;
+
+  QuadParams p_;
+  ImuParams imu_;
+  const MixerTable& table_;
+  std::mt19937 rng_;
+  std::normal_distribution<double> norm_{0.0, 1.0};
+
+  double pos_[3], vel_[3], q_[4], w_[3];
+  double accWorld_[3];
+  double speed_[MIXER_MAX_MOTORS];
+  double extTorque_[3], extForce_[3];
+  double vibPhase_;
+  double time_;
+  double baroNext_, tofNext_;
+  float  baroHeld_;
+  int16_t tofHeld_;
+};
+
+#endif // QUAD_MODEL_H
@@ -0,0 +1,224 @@
+#include "scenario.h"
+
+#include <fstream>
+#include <sstream>
+
+// Arm (throttle stick low + yaw left, held), idle, take off, settle at hover.
+// Note the firmware maps ly reversed: +1000 = zero throttle, lower = more.
+static const char* ARM_PREFIX =
+  "stick 0.0 -1000 -1000 0 0\n"
+  "stick 1.0 0 1000 0 0\n"
+  "ramp  2.0 0 hover-60 0 0\n"
+  "stick 2.4 0 hover 0 0\n";
+
+struct BuiltinScenario {
+  const char* name;
+  const char* script;
+};
+
+static const BuiltinScenario BUILTINS[] = {
+  { "hover",
+    "duration 10\n" },
+  { "roll_step",
+    "duration 11\n"
+    "stick 3 0 hover 400 0\n"
+    "stick 5 0 hover 0 0\n"
+    "stick 7 0 hover -400 0\n"
+    "stick 9 0 hover 0 0\n" },
+  { "pitch_step",
+    "duration 11\n"
+    "stick 3 0 hover 0 400\n"
+    "stick 5 0 hover 0 0\n"
+    "stick 7 0 hover 0 -400\n"
+    "stick 9 0 hover 0 0\n" },
+  { "yaw_step",
+    "duration 11\n"
+    "stick 3 300 hover 0 0\n"
+    "stick 5 0 hover 0 0\n"
+    "stick 7 -300 hover 0 0\n"
+    "stick 9 0 hover 0 0\n" },
+  { "gust",
+    "duration 11\n"
+    "torque 3 0.1 0.0005 0 0\n"
+    "torque 5 0.1 0 -0.0005 0\n"
+    "torque 7 0.2 0 0 0.0002\n"
+    "force  8 1.5 0.15 0.05 0\n" },
+  { "althold",
+    "duration 18\n"
+    "althold 3\n"
+    "stick 4 0 hover-300 0 0\n"
+    "stick 8 0 hover 0 0\n"
+    "stick 10 0 hover+400 0 0\n"
+    "stick 13 0 hover 0 0\n"
+    "force 15 1.0 0 0 -0.3\n" },
+  { "linkloss",   // короткий обрыв (level), затем до конца: снижение, посадка, дизарм
+    "duration 20\n"
+    "althold 3\n"
+    "stick 3 0 hover-300 0 0\n"
+    "stick 5 150 hover 0 0\n"
+    "linkloss 7 0.3\n"
+    "linkloss 9 -1\n" },
+  { "autotune",
+    "duration 16\n"
+    "autotune 3\n" },
+};
+
+std::vector<std::string> scenarioBuiltinNames()
+{
+  std::vector<std::string> names;
+  for (const BuiltinScenario& b : BUILTINS) names.push_back(b.name);
+  return names;
+}
+
+bool scenarioBuiltin(const std::string& name, Scenario* out)
+{
+  for (const BuiltinScenario& b : BUILTINS) {
+    if (name == b.name) {
+      std::string err;
+      bool ok = scenarioParse(std::string(ARM_PREFIX) + b.script, out, &err);
+      out->name = name;
+      return ok;
+    }
+  }
+  return false;
+}
+
+static bool parseStickValue(const std::string& tok, int16_t* v, bool* hover)
+{
+  *hover = false;
+  if (tok.compare(0, 5, "hover") == 0) {
+    *hover = true;
+    *v = tok.size() > 5 ? (int16_t)atoi(tok.c_str() + 5) : 0;
+    return true;
+  }
+  char* end = nullptr;
+  long x = strtol(tok.c_str(), &end, 10);
+  if (*end != '\0' || x < -1000 || x > 1000) return false;
+  *v = (int16_t)x;
+  return true;
+}
+
+bool scenarioParse(const std::string& text, Scenario* out, std::string* err)
+{
+  *out = Scenario();
+  std::istringstream in(text);
+  std::string line;
+  int lineNo = 0;
+  while (std::getline(in, line)) {
+    lineNo++;
+    size_t hash = line.find('#');
+    if (hash != std::string::npos) line.resize(hash);
+    std::istringstream ls(line);
+    std::string cmd;
+    if (!(ls >> cmd)) continue;
+
+    bool ok = false;
+    if (cmd == "duration") {
+      ok = (bool)(ls >> out->duration) && out->duration > 0.0;
+    } else if (cmd == "stick" || cmd == "ramp") {
+      StickKey k = {};
+      std::string lx, ly, rx, ry;
+      bool h0, h2, h3;
+      ok = (bool)(ls >> k.t >> lx >> ly >> rx >> ry)
+        && parseStickValue(lx, &k.lx, &h0) && !h0
+        && parseStickValue(ly, &k.ly, &k.lyHover)
+        && parseStickValue(rx, &k.rx, &h2) && !h2
+        && parseStickValue(ry, &k.ry, &h3) && !h3
+        && (out->sticks.empty() || k.t >= out->sticks.back().t);
+      k.ramp = (cmd == "ramp");
+      if (ok) out->sticks.push_back(k);
+    } else if (cmd == "torque" || cmd == "force") {
+      Disturbance d = {};
+      double v[3];
+      ok = (bool)(ls >> d.t >> d.dur >> v[0] >> v[1] >> v[2]);
+      for (int a = 0; a < 3; ++a) (cmd == "torque" ? d.torque : d.force)[a] = v[a];
+      if (ok) out->disturbances.push_back(d);
+    } else if (cmd == "autotune") {
+      ok = (bool)(ls >> out->autotuneAt) && out->autotuneAt >= 0.0;
+    } else if (cmd == "althold") {
+      ok = (bool)(ls >> out->altHoldAt) && out->altHoldAt >= 0.0;
+    } else if (cmd == "linkloss") {
+      LinkLoss l = {};
+      ok = (bool)(ls >> l.t >> l.dur) && l.t >= 0.0;
+      if (ok) out->linkLoss.push_back(l);
+    }
+
+    if (!ok) {
+      if (err) *err = "line " + std::to_string(lineNo) + ": bad '" + cmd + "' command";
+      return false;
+    }
+  }
+  return true;
+}
+
+bool scenarioLoad(const std::string& path, Scenario* out, std::string* err)
+{
+  std::ifstream f(path);
+  if (!f) {
+    if (err) *err = "cannot open " + path;
+    return false;
+  }
+  std::stringstream ss;
+  ss << f.rdbuf();
+  if (!scenarioParse(ss.str(), out, err)) return false;
+  out->name = path;
+  return true;
+}
+
+int16_t stickForThrottlePwm(double pwm)
+{
+  double ly = 1000.0 - pwm * 2000.0 / 255.0;
+  if (ly < -1000.0) ly = -1000.0;
+  if (ly > 1000.0) ly = 1000.0;
+  return (int16_t)lround(ly);
+}
+
+static double keyLy(const StickKey& k, int16_t hoverStick)
+{
+  return k.lyHover ? (double)hoverStick + k.ly : (double)k.ly;
+}
+
+JoystickData scenarioSticks(const Scenario& s, double t, int16_t hoverStick)
+{
+  JoystickData js = { 0, 1000, 0, 0 };
+  if (s.sticks.empty() || t < s.sticks[0].t) return js;
+
+  size_t i = 0;
+  while (i + 1 < s.sticks.size() && s.sticks[i + 1].t <= t) i++;
+  const StickKey& a = s.sticks[i];
+  double v[4] = { (double)a.lx, keyLy(a, hoverStick), (double)a.rx, (double)a.ry };
+
+  if (i + 1 < s.sticks.size() && s.sticks[i + 1].ramp) {
+    const StickKey& b = s.sticks[i + 1];
+    double f = (b.t > a.t) ? (t - a.t) / (b.t - a.t) : 1.0;
+    double w[4] = { (double)b.lx, keyLy(b, hoverStick), (double)b.rx, (double)b.ry };
+    for (int k = 0; k < 4; ++k) v[k] += (w[k] - v[k]) * f;
+  }
+
+  js.x_left  = (int16_t)constrain(lround(v[0]), -1000L, 1000L);
+  js.y_left  = (int16_t)constrain(lround(v[1]), -1000L, 1000L);
+  js.x_right = (int16_t)constrain(lround(v[2]), -1000L, 1000L);
+  js.y_right = (int16_t)constrain(lround(v[3]), -1000L, 1000L);
+  return js;
+}
+
+void scenarioDisturbance(const Scenario& s, double t, double torque[3], double force[3])
+{
+  for (int a = 0; a < 3; ++a) torque[a] = force[a] = 0.0;
+  for (const Disturbance& d : s.disturbances) {
+    if (t >= d.t && t < d.t + d.dur) {
+      for (int a = 0; a < 3; ++a) {
+        torque[a] += d.torque[a];
+        force[a] += d.force[a];
+      }
+    }
+  }
+}
+
+bool scenarioLinkLost(const Scenario& s, double t)
+{
+  for (const LinkLoss& l : s.linkLoss) {
+    if (t >= l.t && (l.dur < 0.0 || t < l.t + l.dur)) return true;
+  }
+  return false;
+}
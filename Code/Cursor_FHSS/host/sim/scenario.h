@@ -0,0 +1,63 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+// Stick scripts and disturbances for the SIL simulator.
+//
+// Script format (one command per line, '#' starts a comment, times in s):
+//   duration <s>
+//   stick  <t> <lx> <ly> <rx> <ry>     step to these stick values at t
+//   ramp   <t> <lx> <ly> <rx> <ry>     linear from the previous key to t
+//   torque <t> <dur> <x> <y> <z>       body-frame torque, N*m
+//   force  <t> <dur> <x> <y> <z>       world-frame force, N
+//   autotune <t>                       request autotune (same as 't' on the RX)
+//   althold <t>                        altitude hold on (same as 'h' on the RX)
+//   linkloss <t> <dur>                 no control packets (failsafe); dur < 0 = to the end
+// Stick values are raw -1000..1000 as sent by the TX. For ly the word
+// "hover" (optionally "hover+N" / "hover-N") is replaced by the stick value
+// that gives hover thrust on the simulated airframe.
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "joystick.h"
+
+struct StickKey {
+  double t;
+  int16_t lx, ly, rx, ry;
+  bool lyHover;        // ly is an offset from the hover stick
+  bool ramp;
+};
+
+struct Disturbance {
+  double t, dur;
+  double torque[3];
+  double force[3];
+};
+
+struct LinkLoss {
+  double t, dur;
+};
+
+struct Scenario {
+  std::string name;
+  double duration = 10.0;
+  std::vector<StickKey> sticks;
+  std::vector<Disturbance> disturbances;
+  double autotuneAt = -1.0;   // < 0: never
+  double altHoldAt = -1.0;
+  std::vector<LinkLoss> linkLoss;
+};
+
+bool scenarioBuiltin(const std::string& name, Scenario* out);
+std::vector<std::string> scenarioBuiltinNames();
+bool scenarioLoad(const std::string& path, Scenario* out, std::string* err);
+bool scenarioParse(const std::string& text, Scenario* out, std::string* err);
+
+JoystickData scenarioSticks(const Scenario& s, double t, int16_t hoverStick);
+void scenarioDisturbance(const Scenario& s, double t, double torque[3], double force[3]);
+bool scenarioLinkLost(const Scenario& s, double t);
+
+// Raw ly stick value for a throttle PWM (firmware maps ly reversed)
+int16_t stickForThrottlePwm(double pwm);
+
+#endif // SCENARIO_H
@@ -0,0 +1,317 @@
+#include "sil.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "stabilizer.h"
+
+// Settle band: fraction of the step, but never tighter than the floor
+static const double SETTLE_BAND_FRACTION = 0.1;
+static const double STEP_THRESHOLD[3] = { 2.0, 2.0, 10.0 };  // deg, deg, deg/s
+static const double BAND_FLOOR[3] = { 1.0, 1.0, 5.0 };
+static const double MIN_SETTLED_HOLD_S = 0.2;
+static const double CRASH_ANGLE_DEG = 90.0;
+
+namespace {
+
+// Tracks error and step response of one axis
+struct AxisTracker {
+  int axis;
+  double sumSq = 0.0;
+  uint64_t n = 0;
+  double prevSp = 0.0;
+  bool inStep = false;
+  double stepStart = 0.0, band = 0.0, lastOutside = 0.0;
+  AxisMetrics m;
+
+  explicit AxisTracker(int a) : axis(a) {}
+
+  void closeStep(double t) {
+    if (!inStep) return;
+    if (t - lastOutside < MIN_SETTLED_HOLD_S) m.unsettled++;
+    else m.maxSettle = std::max(m.maxSettle, lastOutside - stepStart);
+    inStep = false;
+  }
+
+  void sample(double t, double sp, double actual, bool airborne) {
+    if (fabs(sp - prevSp) > STEP_THRESHOLD[axis]) {
+      closeStep(t);
+      if (airborne) {
+        inStep = true;
+        stepStart = lastOutside = t;
+        band = std::max(fabs(sp - prevSp) * SETTLE_BAND_FRACTION, BAND_FLOOR[axis]);
+        m.steps++;
+      }
+    }
+    prevSp = sp;
+    if (!airborne) {
+      // Touched down mid-step: the response never completed
+      if (inStep) { m.unsettled++; inStep = false; }
+      return;
+    }
+    double e = sp - actual;
+    sumSq += e * e;
+    n++;
+    if (inStep && fabs(e) > band) lastOutside = t;
+  }
+
+  AxisMetrics finish(double t) {
+    closeStep(t);
+    m.rmsError = n ? sqrt(sumSq / n) : 0.0;
+    return m;
+  }
+};
+
+} // namespace
+
+SilResult silRun(const SilConfig& cfg, const Scenario& sc)
+{
+  SilResult r;
+  QuadModel model(cfg.quad, cfg.imu, mixerTableFor(cfg.geometry), cfg.seed);
+  std::mt19937 jitterRng(cfg.seed ^ 0x5EEDu);
+  std::uniform_real_distribution<double> jitter(-cfg.jitterUs, cfg.jitterUs);
+
+  hostSetMicros(0);
+  mixerInit(cfg.geometry);
+  stabilizerInit();
+  failsafeInit();
+  rcSmoothReset();
+
+  // Radio at linkRateHz: the RX sees a packet at the first loop after it is sent
+  std::mt19937 linkRng(cfg.seed ^ 0x11C4u);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  const uint64_t packetUs = cfg.linkRateHz > 0.0 ? (uint64_t)(1e6 / cfg.linkRateHz) : 0;
+  uint64_t nextPacketUs = 0;
+  if (packetUs) failsafeSetSlotUs((uint32_t)packetUs);
+  if (cfg.overrideGains) {
+    for (uint8_t k = 0; k < AT_AXIS_COUNT; ++k) {
+      stabilizerSetGains(k, cfg.gains[k].kp, cfg.gains[k].ki, cfg.gains[k].kd);
+    }
+  }
+  bool autotuneRequested = false;
+  bool altHoldRequested = false;
+  stabilizerSetAltHold(false);
+
+  const uint8_t motorCount = mixerMotorCount();
+  const int16_t hoverStick = stickForThrottlePwm(model.hoverPwm());
+
+  FILE* csv = cfg.csvPath ? fopen(cfg.csvPath, "w") : nullptr;
+  if (csv) {
+    fprintf(csv, "t,sp_roll,roll,att_roll,sp_pitch,pitch_up,att_pitch,sp_yaw,yaw_rate,alt,est_alt,climb,est_climb,sp_alt");
+    for (uint8_t i = 0; i < motorCount; ++i) fprintf(csv, ",m%u", i + 1);
+    fprintf(csv, ",mix_flags,autotune,failsafe\n");
+  }
+
+  // Replay trace (host/replay.cpp): what stabilizeMix() sees each step;
+  // the expected motor outputs are added by `replay --bless`
+  FILE* rec = cfg.recordPath ? fopen(cfg.recordPath, "w") : nullptr;
+  if (rec) {
+    static const char* const GEOMETRY_NAMES[] = { "quadx", "quadplus", "hexa" };
+    fprintf(rec, "# %s: us dt lx ly rx ry ax ay az gx gy gz hpa range_mm | motors\n", sc.name.c_str());
+    fprintf(rec, "geometry %s\n", GEOMETRY_NAMES[cfg.geometry]);
+  }
+
+  AxisTracker trRoll(0), trPitch(1), trYaw(2);
+  std::vector<double> cpuNs;
+  cpuNs.reserve((size_t)(sc.duration * 1e6 / cfg.controlPeriodUs) + 16);
+  double altSq = 0.0, climbSq = 0.0, baroSq = 0.0, holdSq = 0.0;
+  uint64_t altN = 0, holdN = 0;
+  uint64_t satAny = 0, satHigh = 0, satLow = 0, pinned = 0, airborneOutputs = 0;
+  double motorStepSq = 0.0, spStepSq = 0.0;
+  uint8_t prevMotors[MIXER_MAX_MOTORS] = {0};
+  float prevSpRoll = 0.0f, prevSpPitch = 0.0f;
+
+  uint8_t motors[MIXER_MAX_MOTORS] = {0};
+  double t = 0.0;
+  uint64_t simUs = 0;
+  uint32_t prevMicros = 0;
+  auto wallStart = std::chrono::steady_clock::now();
+
+  while (t < sc.duration) {
+    // --- Firmware side: same sequence as fhss_RX loop() ---
+    hostSetMicros(simUs);
+    uint32_t now = micros();
+    float dt = (now - prevMicros) * 1e-6f;
+    if (dt < 1e-6f) dt = 1e-6f;
+    prevMicros = now;
+
+    TelemetryData sens;
+    model.readImu(&sens);
+    JoystickData js = scenarioSticks(sc, t, hoverStick);
+    if (!autotuneRequested && sc.autotuneAt >= 0.0 && t >= sc.autotuneAt) {
+      autotuneRequest();
+      autotuneRequested = true;
+    }
+    if (!altHoldRequested && sc.altHoldAt >= 0.0 && t >= sc.altHoldAt) {
+      stabilizerSetAltHold(true);
+      altHoldRequested = true;
+    }
+
+    // Radio: one packet per loop while the link is up (loop < TX slot),
+    // or packets at linkRateHz through the RX stick smoothing
+    if (packetUs) {
+      if (simUs >= nextPacketUs) {
+        nextPacketUs += packetUs * ((simUs - nextPacketUs) / packetUs + 1);
+        if (!scenarioLinkLost(sc, t) && uniform(linkRng) >= cfg.linkLoss) {
+          rcSmoothOnPacket(js, now);
+          failsafeOnPacket(now);
+        }
+      }
+      rcSmoothUpdate(now, &js);
+    } else if (!scenarioLinkLost(sc, t)) {
+      failsafeOnPacket(now);
+    }
+    FailsafeStage fs = failsafeUpdate(now, &js);
+    if (r.controlSteps > 0 && fs > r.failsafeMax) r.failsafeMax = fs;
+
+    if (rec) {
+      fprintf(rec, "%u %.6f %d %d %d %d %.4f %.4f %.4f %.5f %.5f %.5f %.3f %d\n", now, dt,
+              js.x_left, js.y_left, js.x_right, js.y_right,
+              sens.accel_x, sens.accel_y, sens.accel_z, sens.gyro_x, sens.gyro_y, sens.gyro_z,
+              sens.pressure, sens.range_mm);
+    }
+
+    auto c0 = std::chrono::steady_clock::now();
+    stabilizeMix(js, sens, dt, motors);
+    auto c1 = std::chrono::steady_clock::now();
+    cpuNs.push_back((double)std::chrono::duration_cast<std::chrono::nanoseconds>(c1 - c0).count());
+    mixerWrite(motors);
+
+    // --- Metrics ---
+    const StabilizerDebug& st = stabilizerDebug();
+    bool airborne = model.altitude() > 0.02;
+    trRoll.sample(t, st.sp_roll, model.rollDeg(), airborne);
+    trPitch.sample(t, st.sp_pitch, model.pitchUpDeg(), airborne);
+    trYaw.sample(t, st.sp_yaw_rate, model.yawRateDps(), airborne);
+    if (airborne) {
+      double e = st.vert.height - model.altitude();
+      altSq += e * e;
+      e = st.vert.climb - model.climbRate();
+      climbSq += e * e;
+      e = st.vert.baroHeight - model.altitude();
+      baroSq += e * e;
+      altN++;
+      if (st.altHold) {
+        e = model.altitude() - st.sp_height;
+        holdSq += e * e;
+        holdN++;
+        r.alt.holdMax = std::max(r.alt.holdMax, fabs(e));
+      }
+      if (st.mixFlags) satAny++;
+      if (st.mixFlags & MIXER_SAT_HIGH) satHigh++;
+      if (st.mixFlags & MIXER_SAT_LOW) satLow++;
+      for (uint8_t i = 0; i < motorCount; ++i) {
+        if (motors[i] == 0 || motors[i] == 255) pinned++;
+        const double d = (double)motors[i] - prevMotors[i];
+        motorStepSq += d * d;
+      }
+      const double dr = st.sp_roll - prevSpRoll, dp = st.sp_pitch - prevSpPitch;
+      spStepSq += dr * dr + dp * dp;
+      airborneOutputs += motorCount;
+    }
+    memcpy(prevMotors, motors, motorCount);
+    prevSpRoll = st.sp_roll;
+    prevSpPitch = st.sp_pitch;
+    r.maxAltitude = std::max(r.maxAltitude, model.altitude());
+    r.controlSteps++;
+
+    if (csv) {
+      fprintf(csv, "%.4f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.1f,%.1f,%.3f,%.3f,%.3f,%.3f,%.3f", t,
+              st.sp_roll, model.rollDeg(), st.att.roll,
+              st.sp_pitch, model.pitchUpDeg(), st.att.pitch,
+              st.sp_yaw_rate, model.yawRateDps(), model.altitude(),
+              st.vert.height, model.climbRate(), st.vert.climb, st.sp_height);
+      for (uint8_t i = 0; i < motorCount; ++i) fprintf(csv, ",%u", motors[i]);
+      fprintf(csv, ",%u,%u,%u\n", st.mixFlags, (unsigned)autotuneState(), (unsigned)fs);
+    }
+
+    if (!(fabs(model.rollDeg()) < CRASH_ANGLE_DEG && fabs(model.pitchUpDeg()) < CRASH_ANGLE_DEG)) {
+      r.crashed = true;
+      break;
+    }
+
+    // --- Plant side: integrate until the next loop iteration ---
+    double periodUs = std::max(50.0, cfg.controlPeriodUs + jitter(jitterRng));
+    double h = periodUs * 1e-6 / cfg.physicsSubsteps;
+    for (int k = 0; k < cfg.physicsSubsteps; ++k) {
+      double torque[3], force[3];
+      scenarioDisturbance(sc, t, torque, force);
+      model.setDisturbance(torque, force);
+      model.step(h, motors);
+      t += h;
+    }
+    simUs += (uint64_t)periodUs;
+  }
+
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+  r.realtimeFactor = wall > 0.0 ? t / wall : 0.0;
+  if (csv) fclose(csv);
+  if (rec) fclose(rec);
+
+  r.roll = trRoll.finish(t);
+  r.pitch = trPitch.finish(t);
+  r.yaw = trYaw.finish(t);
+  if (r.controlSteps) {
+    r.satFraction = (double)satAny / r.controlSteps;
+    r.satHighFraction = (double)satHigh / r.controlSteps;
+    r.satLowFraction = (double)satLow / r.controlSteps;
+  }
+  r.autotune = autotuneState();
+  r.failsafeEnd = failsafeStage();
+  r.armedAtEnd = stabilizerDebug().armed;
+  if (altN) {
+    r.alt.estRms = sqrt(altSq / altN);
+    r.alt.climbRms = sqrt(climbSq / altN);
+    r.alt.baroRms = sqrt(baroSq / altN);
+  }
+  if (holdN) r.alt.holdRms = sqrt(holdSq / holdN);
+  r.motorPinnedFraction = airborneOutputs ? (double)pinned / airborneOutputs : 0.0;
+  r.linked = packetUs > 0;
+  r.motorStepRms = airborneOutputs ? sqrt(motorStepSq / airborneOutputs) : 0.0;
+  r.spStepRms = altN ? sqrt(spStepSq / (2.0 * altN)) : 0.0;
+
+  if (!cpuNs.empty()) {
+    double sum = 0.0;
+    for (double v : cpuNs) sum += v;
+    r.cpuNsMean = sum / cpuNs.size();
+    std::sort(cpuNs.begin(), cpuNs.end());
+    r.cpuNsP99 = cpuNs[(size_t)(cpuNs.size() * 0.99)];
+    r.cpuNsMax = cpuNs.back();
+  }
+  return r;
+}
+
+static void printAxis(const char* name, const char* unit, const AxisMetrics& m)
+{
+  printf("  %-6s rms_err=%7.2f %-5s", name, m.rmsError, unit);
+  if (m.steps) {
+    printf(" steps=%d max_settle=%.3fs", m.steps, m.maxSettle);
+    if (m.unsettled) printf(" unsettled=%d", m.unsettled);
+  }
+  printf("\n");
+}
+
+void silPrintResult(const char* name, const SilResult& r)
+{
+  printf("%s%s\n", name, r.crashed ? "  ** CRASHED **" : "");
+  printAxis("roll", "deg", r.roll);
+  printAxis("pitch", "deg", r.pitch);
+  printAxis("yaw", "deg/s", r.yaw);
+  printf("  alt    est_rms=%.3fm climb_rms=%.3fm/s baro_rms=%.3fm",
+         r.alt.estRms, r.alt.climbRms, r.alt.baroRms);
+  if (r.alt.holdRms > 0.0) printf(" hold_rms=%.3fm hold_max=%.3fm", r.alt.holdRms, r.alt.holdMax);
+  printf("\n");
+  printf("  sat    any=%.1f%% high=%.1f%% low=%.1f%% motor_pinned=%.1f%%\n",
+         100.0 * r.satFraction, 100.0 * r.satHighFraction, 100.0 * r.satLowFraction,
+         100.0 * r.motorPinnedFraction);
+  if (r.linked) {
+    printf("  rc     sp_step_rms=%.3fdeg motor_step_rms=%.2f\n", r.spStepRms, r.motorStepRms);
+  }
+  if (r.failsafeMax != FS_OK) {
+    printf("  link   failsafe max=%s end=%s armed=%d\n", failsafeStageName(r.failsafeMax),
+           failsafeStageName(r.failsafeEnd), r.armedAtEnd ? 1 : 0);
+  }
+  printf("  cpu    stabilizeMix mean=%.0fns p99=%.0fns max=%.0fns\n", r.cpuNsMean, r.cpuNsP99, r.cpuNsMax);
+  printf("  run    steps=%llu max_alt=%.2fm realtime_x=%.0f\n",
+         (unsigned long long)r.controlSteps, r.maxAltitude, r.realtimeFactor);
+}
@@ -0,0 +1,69 @@
+#ifndef SIL_H
+#define SIL_H
+
+// Closed-loop software-in-the-loop run: the unmodified fhss_RX stabilizer,
+// attitude estimator, PID and mixer against QuadModel.
+
+#include "quad_model.h"
+#include "scenario.h"
+#include "autotune.h"
+#include "failsafe.h"
+#include "rc_smooth.h"
+
+struct SilConfig {
+  QuadParams quad;
+  ImuParams imu;
+  MixerGeometry geometry = MIXER_QUAD_X;
+  double controlPeriodUs = 1000.0;   // RX loop period
+  double jitterUs = 50.0;            // uniform +/- jitter on the loop period
+  int physicsSubsteps = 4;
+  uint32_t seed = 1;
+  const char* csvPath = nullptr;     // per-step trace, optional
+  const char* recordPath = nullptr;  // stabilizeMix() inputs for host/replay, optional
+  double linkRateHz = 0.0;           // control packets per second, 0 = fresh sticks every loop
+  double linkLoss = 0.0;             // fraction of packets lost at random
+  bool overrideGains = false;        // replace stabilizerInit() gains with gains[]
+  AutotuneGains gains[AT_AXIS_COUNT];
+};
+
+struct AxisMetrics {
+  double rmsError = 0.0;     // deg (roll/pitch) or deg/s (yaw), while airborne
+  double maxSettle = 0.0;    // s, worst setpoint step
+  int steps = 0;             // setpoint steps seen
+  int unsettled = 0;         // steps that never entered the band
+};
+
+struct AltMetrics {
+  double estRms = 0.0;       // m, estimated vs true height (airborne)
+  double climbRms = 0.0;     // m/s, estimated vs true climb rate
+  double baroRms = 0.0;      // m, raw baro reference vs true height
+  double holdRms = 0.0;      // m, true height vs hold target (hold active)
+  double holdMax = 0.0;
+};
+
+struct SilResult {
+  AxisMetrics roll, pitch, yaw;
+  AltMetrics alt;
+  double satFraction = 0.0;      // control steps with any mixer limit flag
+  double satHighFraction = 0.0;
+  double satLowFraction = 0.0;
+  double motorPinnedFraction = 0.0;  // motor outputs at 0 or 255 while airborne
+  bool linked = false;           // sticks came in packets (--link-rate)
+  double spStepRms = 0.0;        // roll/pitch setpoint change per loop, deg, while airborne
+  double motorStepRms = 0.0;     // PWM change per loop and motor while airborne
+  double cpuNsMean = 0.0, cpuNsP99 = 0.0, cpuNsMax = 0.0;  // stabilizeMix() per step
+  double realtimeFactor = 0.0;   // simulated seconds per wall-clock second
+  double maxAltitude = 0.0;
+  uint64_t controlSteps = 0;
+  bool crashed = false;
+  AutotuneState autotune = AT_IDLE;  // state at the end of the run
+  FailsafeStage failsafeMax = FS_OK; // worst failsafe stage while linked once
+  FailsafeStage failsafeEnd = FS_OK;
+  bool armedAtEnd = false;
+};
+
+SilResult silRun(const SilConfig& cfg, const Scenario& sc);
+
+void silPrintResult(const char* name, const SilResult& r);
+
+#endif // SIL_H
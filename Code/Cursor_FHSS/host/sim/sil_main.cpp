@@ -0,0 +1,119 @@
+// SIL simulator: fhss_RX flight stack against a rigid-body quad model.
+// See host/README.md for the build command.
+
+#include <string>
+#include <vector>
+#include "sil.h"
+
+static void usage(const char* argv0)
+{
+  printf("usage: %s [options]\n"
+         "  --scenario NAME|FILE   builtin name or script file (repeatable, default: all builtins)\n"
+         "  --geometry quadx|quadplus|hexa\n"
+         "  --period US            control loop period (default 1000)\n"
+         "  --jitter US            +/- loop period jitter (default 50)\n"
+         "  --seed N               noise seed (default 1)\n"
+         "  --no-noise             ideal IMU: no noise, bias or vibration\n"
+         "  --no-tof               no VL53L0X: height from baro + accel only\n"
+         "  --noise K              scale IMU noise and vibration (default 1)\n"
+         "  --csv FILE             per-step trace (single scenario only)\n"
+         "  --record FILE          stabilizeMix() inputs for replay (single scenario only)\n"
+         "  --link-rate HZ         sticks in packets at HZ through rc_smooth (default: every loop)\n"
+         "  --link-loss P          fraction of those packets lost (default 0)\n"
+         "  --autotune             run the autotune scenario first, then the rest with its gains\n"
+         "  --list                 list builtin scenarios\n", argv0);
+}
+
+// Fly the builtin autotune scenario and take its proposal for later runs
+static bool runAutotune(SilConfig* cfg)
+{
+  Scenario sc;
+  scenarioBuiltin("autotune", &sc);
+  SilConfig tuneCfg = *cfg;
+  tuneCfg.csvPath = nullptr;
+  SilResult r = silRun(tuneCfg, sc);
+  silPrintResult(sc.name.c_str(), r);
+  autotuneReport(Serial);
+  if (r.autotune != AT_DONE) {
+    fprintf(stderr, "autotune did not complete\n");
+    return false;
+  }
+  for (uint8_t k = 0; k < AT_AXIS_COUNT; ++k) cfg->gains[k] = autotuneResult(k).proposed;
+  cfg->overrideGains = true;
+  printf("--- with proposed gains ---\n");
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  SilConfig cfg;
+  std::vector<std::string> names;
+  bool tune = false;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (a == "--scenario" && hasValue) names.push_back(argv[++i]);
+    else if (a == "--period" && hasValue) cfg.controlPeriodUs = atof(argv[++i]);
+    else if (a == "--jitter" && hasValue) cfg.jitterUs = atof(argv[++i]);
+    else if (a == "--seed" && hasValue) cfg.seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (a == "--csv" && hasValue) cfg.csvPath = argv[++i];
+    else if (a == "--record" && hasValue) cfg.recordPath = argv[++i];
+    else if (a == "--link-rate" && hasValue) cfg.linkRateHz = atof(argv[++i]);
+    else if (a == "--link-loss" && hasValue) cfg.linkLoss = atof(argv[++i]);
+    else if (a == "--autotune") tune = true;
+    else if (a == "--no-tof") cfg.imu.hasTof = false;
+    else if (a == "--noise" && hasValue) {
+      double k = atof(argv[++i]);
+      cfg.imu.gyroNoise *= k;
+      cfg.imu.accelNoise *= k;
+      cfg.imu.pressureNoise *= k;
+      cfg.imu.vibrationGyro *= k;
+      cfg.imu.vibrationAccel *= k;
+    }
+    else if (a == "--no-noise") {
+      cfg.imu.gyroNoise = cfg.imu.accelNoise = cfg.imu.pressureNoise = 0.0;
+      cfg.imu.vibrationGyro = cfg.imu.vibrationAccel = 0.0;
+      for (int k = 0; k < 3; ++k) cfg.imu.gyroBias[k] = cfg.imu.accelBias[k] = 0.0;
+    }
+    else if (a == "--geometry" && hasValue) {
+      std::string g = argv[++i];
+      if (g == "quadx") cfg.geometry = MIXER_QUAD_X;
+      else if (g == "quadplus") cfg.geometry = MIXER_QUAD_PLUS;
+      else if (g == "hexa") cfg.geometry = MIXER_HEXA_X;
+      else { usage(argv[0]); return 2; }
+    }
+    else if (a == "--list") {
+      for (const std::string& n : scenarioBuiltinNames()) printf("%s\n", n.c_str());
+      return 0;
+    }
+    else { usage(argv[0]); return 2; }
+  }
+
+  if (names.empty()) names = scenarioBuiltinNames();
+  if ((cfg.csvPath || cfg.recordPath) && names.size() != 1) {
+    fprintf(stderr, "--csv / --record need exactly one --scenario\n");
+    return 2;
+  }
+
+  if (tune && !runAutotune(&cfg)) return 1;
+
+  bool anyCrash = false;
+  for (const std::string& n : names) {
+    Scenario sc;
+    std::string err;
+    if (!scenarioBuiltin(n, &sc) && !scenarioLoad(n, &sc, &err)) {
+      fprintf(stderr, "%s: %s\n", n.c_str(), err.empty() ? "unknown scenario" : err.c_str());
+      return 2;
+    }
+    // Replay has no link, autotune or hold commands: only sticks + sensors
+    if (cfg.recordPath && (sc.autotuneAt >= 0.0 || sc.altHoldAt >= 0.0 || !sc.linkLoss.empty())) {
+      fprintf(stderr, "%s: --record: autotune/althold/linkloss are not replayable\n", n.c_str());
+      return 2;
+    }
+    SilResult r = silRun(cfg, sc);
+    silPrintResult(sc.name.c_str(), r);
+    anyCrash |= r.crashed;
+  }
+  return anyCrash ? 1 : 0;
+}
@@ -0,0 +1,50 @@
+#include "FrameTimer.h"
+
+FrameTimer* FrameTimer::handlerInstance = nullptr;
+
+void FrameTimer::Begin()
+{
+  handlerInstance = this;
+  timer = timerBegin(FRAME_TIMER_HZ);
+  timerAttachInterrupt(timer, StaticAlarmHandler);
+}
+
+void ARDUINO_ISR_ATTR FrameTimer::StaticAlarmHandler()
+{
+  FrameTimer* instance = handlerInstance;
+  if (instance == nullptr || instance->waitingTask == nullptr)
+  {
+    return;
+  }
+
+  BaseType_t higherPriorityWoken = pdFALSE;
+  vTaskNotifyGiveFromISR(instance->waitingTask, &higherPriorityWoken);
+  if (higherPriorityWoken)
+  {
+    portYIELD_FROM_ISR();
+  }
+}
+
+uint64_t FrameTimer::Now()
+{
+  return timerRead(timer);
+}
+
+void FrameTimer::WaitUntil(uint64_t tick)
+{
+  if (Now() >= tick)
+  {
+    return;
+  }
+
+  waitingTask = xTaskGetCurrentTaskHandle();
+  timerAlarm(timer, tick, false, 0);
+
+  //A stale notification only costs one more pass; the timeout guards against a lost alarm
+  while (Now() < tick)
+  {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10) + 1);
+  }
+
+  waitingTask = nullptr;
+}
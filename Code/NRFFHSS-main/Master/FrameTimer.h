@@ -0,0 +1,30 @@
+#ifndef FrameTimer_h
+#define FrameTimer_h
+
+#include <Arduino.h>
+
+// Frame clock for RadioMaster / RadioSlave (same file in Master/ and Slave/).
+// A 64-bit ESP32 hardware timer counts at FRAME_TIMER_HZ, so frame times
+// never wrap and drift can be corrected in 0.1 us steps. WaitUntil() puts
+// the calling task to sleep until the timer alarm interrupt instead of
+// spinning on micros(), leaving the core free between frames.
+
+#define FRAME_TIMER_HZ 10000000UL
+#define FRAME_TICKS_PER_US (FRAME_TIMER_HZ / 1000000UL)
+
+class FrameTimer
+{
+private:
+  static FrameTimer* handlerInstance;
+  hw_timer_t* timer = nullptr;
+  volatile TaskHandle_t waitingTask = nullptr;
+
+  static void ARDUINO_ISR_ATTR StaticAlarmHandler();
+
+public:
+  void Begin();
+  uint64_t Now();                  // Ticks since Begin(); safe in interrupts
+  void WaitUntil(uint64_t tick);   // Returns at once if tick has passed
+};
+
+#endif
@@ -1,6 +1,6 @@
 #include "RadioMaster.h"
 
-void RadioMaster::Init(_SPI* spiPort, uint8_t pinCE, uint8_t PinCS, int8_t powerLevel, uint8_t packetSize, uint8_t numberOfSendPackets, uint8_t numberOfReceivePackets, uint8_t frameRate)
+void RadioMaster::Init(_SPI* spiPort, uint8_t pinCE, uint8_t PinCS, int8_t powerLevel, uint8_t packetSize, uint8_t numberOfSendPackets, uint8_t numberOfReceivePackets, uint16_t frameRate)
 {
   //Packets
   this->numberOfSendPackets = (numberOfSendPackets < 0) ? 0 : ((numberOfSendPackets > 3) ? 3 : numberOfSendPackets);
@@ -40,8 +40,10 @@ void RadioMaster::Init(_SPI* spiPort, uint8_t pinCE, uint8_t PinCS, int8_t power
   radio.startListening();
 
   //Frame Timing
-  this->frameRate = (frameRate < 10) ? 10 : ((frameRate > 120) ? 120 : frameRate);  //Clamp between 10 and 120
-  microsPerFrame = 1000000 / frameRate;
+  this->frameRate = (frameRate < 10) ? 10 : ((frameRate > 1000) ? 1000 : frameRate);  //Clamp between 10 and 1000
+  ticksPerFrame = FRAME_TIMER_HZ / this->frameRate;
+  frameTimer.Begin();
+  frameTimeEnd = frameTimer.Now() + ticksPerFrame;
 }
 
 void RadioMaster::ClearSendPackets()
@@ -53,6 +55,29 @@ void RadioMaster::ClearSendPackets()
   }
 }
 
+void RadioMaster::AddNextPacketBytes(uint8_t packetId, const uint8_t* data, uint8_t length)
+{
+  if (packetId >= numberOfSendPackets || byteAddCounter[packetId] + length > packetSize)
+  {
+    return;
+  }
+
+  memcpy(&sendPackets[packetId][byteAddCounter[packetId]], data, length);
+  byteAddCounter[packetId] += length;
+}
+
+void RadioMaster::GetNextPacketBytes(uint8_t packetId, uint8_t* data, uint8_t length)
+{
+  if (packetId >= numberOfReceivePackets || byteReceiveCounter[packetId] + length > packetSize)
+  {
+    memset(data, 0, length);
+    return;
+  }
+
+  memcpy(data, &recievePackets[packetId][byteReceiveCounter[packetId]], length);
+  byteReceiveCounter[packetId] += length;
+}
+
 void RadioMaster::ClearReceivePackets()
 {
   for(int i = 0; i < numberOfReceivePackets; i++)
@@ -65,28 +90,7 @@ void RadioMaster::ClearReceivePackets()
 
 void RadioMaster::AdvanceFrame()
 {
-  uint32_t newTime = frameTimeEnd + microsPerFrame;
-  isOverFlowFrame = (newTime < frameTimeEnd);
-  frameTimeEnd = newTime;
-}
-
-bool RadioMaster::IsFrameReady()
-{ 
-  uint32_t currentTimeStamp = micros();
-  uint32_t localFrameTimeEnd = frameTimeEnd;
-   
-  if(isOverFlowFrame)
-  {
-    currentTimeStamp -= 0x80000000;
-    localFrameTimeEnd -= 0x80000000;
-  }
-
-  if (currentTimeStamp >= localFrameTimeEnd)
-	{
-    AdvanceFrame();
-    return true;
-  }
-    return false;
+  frameTimeEnd += ticksPerFrame;
 }
 
 void RadioMaster::UpdateRecording()
@@ -104,7 +108,8 @@ void RadioMaster::UpdateRecording()
 
 void RadioMaster::WaitAndSend()
 {
-  while(!IsFrameReady()) {}
+  frameTimer.WaitUntil(frameTimeEnd);  //Sleeps until the timer interrupt
+  AdvanceFrame();
 
   radio.stopListening();
   
@@ -2,6 +2,7 @@
 #define RadioMaster_h
 
 #include <RF24.h>
+#include "FrameTimer.h"
 #define MAXPACKETS 3
 #define PACKET1 0
 #define PACKET2 1
@@ -22,12 +23,12 @@ private:
   uint8_t channelHopCounter = 0;
 
 //Frame Timing Stuff
-  uint8_t frameRate = 0;
-  uint32_t microsPerFrame = 0;
-  uint32_t frameTimeEnd = 0;
-  bool isOverFlowFrame = false;
-  uint8_t secondCounter = 0;
-  uint8_t recievedPacketCount = 0;
+  FrameTimer frameTimer;
+  uint16_t frameRate = 0;
+  uint32_t ticksPerFrame = 0;
+  uint64_t frameTimeEnd = 0;
+  uint16_t secondCounter = 0;
+  uint16_t recievedPacketCount = 0;
   uint16_t receivedPerSecond = 0;
   bool isSecondTick = false;
 
@@ -45,16 +46,20 @@ private:
   void ClearReceivePackets();
   void UpdateRecording();
   void AdvanceFrame();
-  bool IsFrameReady();
 
 public:
-  void Init(_SPI* spiPort, uint8_t pinCE, uint8_t PinCS, int8_t powerLevel, uint8_t packetSize, uint8_t numberOfSendPackets, uint8_t numberOfReceivePackets, uint8_t frameRate);
+  void Init(_SPI* spiPort, uint8_t pinCE, uint8_t PinCS, int8_t powerLevel, uint8_t packetSize, uint8_t numberOfSendPackets, uint8_t numberOfReceivePackets, uint16_t frameRate);
   void WaitAndSend();
   void Receive();
   bool IsNewPacket(uint8_t packetId) {return receivePacketsAvailable[packetId]; }
   int16_t GetRecievedPacketsPerSecond() {return receivedPerSecond; }
   int8_t GetCurrentChannel() { return channelList[currentChannelIndex]; }
   bool IsSecondTick() {return isSecondTick; }
+  uint8_t GetPacketPayloadSize() { return packetSize - 1; }  //First byte is the packet id
+  uint8_t GetNumberOfSendPackets() { return numberOfSendPackets; }
+  uint8_t GetNumberOfReceivePackets() { return numberOfReceivePackets; }
+  void AddNextPacketBytes(uint8_t packetId, const uint8_t* data, uint8_t length);
+  void GetNextPacketBytes(uint8_t packetId, uint8_t* data, uint8_t length);
   template <typename T> void AddNextPacketValue(uint8_t packetId, T data);
   template <typename T> T GetNextPacketValue(uint8_t packetId);
 };
@@ -0,0 +1,250 @@
+#include "StreamMux.h"
+
+#define SEGMENT_FIRST 0x10
+#define SEGMENT_LAST 0x20
+#define SEGMENT_MAX_LENGTH 31
+#define COUNTER_MASK 0x07
+#define MESSAGE_MASK 0x03
+#define MESSAGE_SHIFT 6
+
+bool StreamMux::OpenStream(uint8_t streamId, uint8_t priority, uint16_t maxMessage, uint16_t queueSize, bool latestOnly)
+{
+  if (streamId >= MUX_STREAMS || streams[streamId].isOpen || maxMessage == 0)
+  {
+    return false;
+  }
+
+  Stream& s = streams[streamId];
+  s.priority = (priority > MUX_PRIORITY_LOWEST) ? MUX_PRIORITY_LOWEST : priority;
+  s.maxMessage = maxMessage;
+  s.queueSize = (queueSize < maxMessage + 2) ? maxMessage + 2 : queueSize;  //At least one whole message
+  s.queue = new uint8_t[s.queueSize]();
+  s.message = new uint8_t[maxMessage]();
+  s.latestOnly = latestOnly;
+  s.isOpen = true;
+  return true;
+}
+
+uint8_t StreamMux::QueueByte(Stream& s, uint16_t offset)
+{
+  return s.queue[(s.queueTail + offset) % s.queueSize];
+}
+
+uint16_t StreamMux::HeadMessageLength(Stream& s)
+{
+  return QueueByte(s, 0) | (QueueByte(s, 1) << 8);
+}
+
+void StreamMux::QueuePush(Stream& s, const uint8_t* data, uint16_t length)
+{
+  s.queue[s.queueHead] = length & 0xFF;
+  s.queue[(s.queueHead + 1) % s.queueSize] = length >> 8;
+  s.queueHead = (s.queueHead + 2) % s.queueSize;
+  for (uint16_t i = 0; i < length; i++)
+  {
+    s.queue[s.queueHead] = data[i];
+    s.queueHead = (s.queueHead + 1) % s.queueSize;
+  }
+  s.queueUsed += length + 2;
+}
+
+bool StreamMux::Write(uint8_t streamId, const void* data, uint16_t length)
+{
+  if (streamId >= MUX_STREAMS || !streams[streamId].isOpen || length == 0)
+  {
+    return false;
+  }
+
+  Stream& s = streams[streamId];
+  if (length > s.maxMessage)
+  {
+    s.stats.droppedMessages++;
+    return false;
+  }
+
+  if (s.latestOnly && s.queueUsed > 0)
+  {
+    //Keep only a message that is already half way out
+    uint16_t keep = (s.sendOffset > 0) ? HeadMessageLength(s) + 2 : 0;
+    s.queueUsed = keep;
+    s.queueHead = (s.queueTail + keep) % s.queueSize;
+  }
+
+  if (s.queueUsed + length + 2 > s.queueSize)
+  {
+    s.stats.droppedMessages++;
+    return false;
+  }
+
+  QueuePush(s, (const uint8_t*)data, length);
+  return true;
+}
+
+bool StreamMux::IsIdle(uint8_t streamId)
+{
+  return streamId >= MUX_STREAMS || streams[streamId].queueUsed == 0;
+}
+
+int8_t StreamMux::PickStream()
+{
+  //Highest priority with data; equal priorities take turns
+  int8_t best = -1;
+  for (uint8_t k = 0; k < MUX_STREAMS; k++)
+  {
+    uint8_t id = (roundRobinStart + k) % MUX_STREAMS;
+    Stream& s = streams[id];
+    if (!s.isOpen || s.queueUsed == 0)
+    {
+      continue;
+    }
+    if (best < 0 || s.priority < streams[best].priority)
+    {
+      best = id;
+    }
+  }
+  return best;
+}
+
+uint8_t StreamMux::BuildPacket(uint8_t* out, uint8_t size)
+{
+  uint8_t used = 0;
+
+  while (size - used > MUX_SEGMENT_HEADER)
+  {
+    int8_t id = PickStream();
+    if (id < 0)
+    {
+      break;
+    }
+
+    Stream& s = streams[id];
+    uint16_t length = HeadMessageLength(s);
+    uint16_t remaining = length - s.sendOffset;
+    uint8_t room = size - used - MUX_SEGMENT_HEADER;
+    if (room > SEGMENT_MAX_LENGTH) { room = SEGMENT_MAX_LENGTH; }
+    bool isFirst = (s.sendOffset == 0);
+    uint8_t prefix = isFirst ? MUX_FIRST_HEADER : 0;
+    if (room <= prefix)
+    {
+      break;  //No room for the length and a data byte; next packet
+    }
+    room -= prefix;
+    uint8_t chunk = (remaining < room) ? remaining : room;
+    bool isLast = (chunk == remaining);
+
+    out[used++] = id | (isFirst ? SEGMENT_FIRST : 0) | (isLast ? SEGMENT_LAST : 0) |
+                  ((s.sendMessage & MESSAGE_MASK) << MESSAGE_SHIFT);
+    out[used++] = (prefix + chunk) | ((s.sendCounter & COUNTER_MASK) << 5);
+    s.sendCounter++;
+    if (isFirst)
+    {
+      out[used++] = length & 0xFF;
+    }
+    for (uint8_t i = 0; i < chunk; i++)
+    {
+      out[used++] = QueueByte(s, 2 + s.sendOffset + i);
+    }
+    s.sendOffset += chunk;
+
+    if (isLast)
+    {
+      s.queueTail = (s.queueTail + length + 2) % s.queueSize;
+      s.queueUsed -= length + 2;
+      s.sendOffset = 0;
+      s.sendMessage++;
+      s.stats.sentMessages++;
+      roundRobinStart = (id + 1) % MUX_STREAMS;
+    }
+  }
+
+  memset(out + used, 0, size - used);  //Length 0 header ends the packet
+  return used;
+}
+
+void StreamMux::ReceiveSegment(uint8_t streamId, bool isFirst, bool isLast, uint8_t counter, uint8_t message,
+                               const uint8_t* data, uint8_t length)
+{
+  Stream& s = streams[streamId];
+  if (!s.isOpen)
+  {
+    return;
+  }
+
+  bool inSequence = !s.hasReceived || counter == s.receiveCounter;
+  s.receiveCounter = (counter + 1) & COUNTER_MASK;
+  s.hasReceived = true;
+
+  if (isFirst)
+  {
+    if (s.isAssembling || !inSequence)
+    {
+      s.stats.lostMessages++;
+    }
+    s.isAssembling = false;
+    if (length < MUX_FIRST_HEADER)
+    {
+      return;
+    }
+    s.expectedLength = data[0];
+    data += MUX_FIRST_HEADER;
+    length -= MUX_FIRST_HEADER;
+    s.receiveMessage = message;
+    s.isAssembling = true;
+    s.messageLength = 0;
+  }
+  else if (!s.isAssembling)
+  {
+    return;  //Joined in the middle of a message
+  }
+  else if (!inSequence || message != s.receiveMessage)
+  {
+    //A lost multiple of 8 segments still gets here through the message counter
+    s.stats.lostMessages++;
+    s.isAssembling = false;
+    return;
+  }
+
+  if (s.messageLength + length > s.maxMessage)
+  {
+    s.stats.lostMessages++;
+    s.isAssembling = false;
+    return;
+  }
+
+  memcpy(s.message + s.messageLength, data, length);
+  s.messageLength += length;
+
+  if (isLast)
+  {
+    s.isAssembling = false;
+    if ((s.messageLength & 0xFF) != s.expectedLength)
+    {
+      s.stats.lostMessages++;  //Segments lost inside the message, counter in step
+      return;
+    }
+    s.stats.receivedMessages++;
+    if (handler != nullptr)
+    {
+      handler(streamId, s.message, s.messageLength);
+    }
+  }
+}
+
+void StreamMux::ParsePacket(const uint8_t* in, uint8_t size)
+{
+  uint8_t pos = 0;
+  while (pos + MUX_SEGMENT_HEADER <= size)
+  {
+    uint8_t header0 = in[pos];
+    uint8_t header1 = in[pos + 1];
+    uint8_t length = header1 & SEGMENT_MAX_LENGTH;
+    if (length == 0 || pos + MUX_SEGMENT_HEADER + length > size)
+    {
+      return;
+    }
+
+    ReceiveSegment(header0 & 0x0F, header0 & SEGMENT_FIRST, header0 & SEGMENT_LAST, header1 >> 5,
+                   (header0 >> MESSAGE_SHIFT) & MESSAGE_MASK, in + pos + MUX_SEGMENT_HEADER, length);
+    pos += MUX_SEGMENT_HEADER + length;
+  }
+}
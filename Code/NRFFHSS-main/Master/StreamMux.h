@@ -0,0 +1,131 @@
+#ifndef StreamMux_h
+#define StreamMux_h
+
+#include <Arduino.h>
+
+// Logical streams over the RadioMaster / RadioSlave packet slots (same file
+// in Master/ and Slave/). Up to 16 streams, each with a priority and its own
+// send queue. Messages larger than a packet are cut into fragments and put
+// back together on the other side; every frame the free packet bytes are
+// filled highest priority first, so a control message queued before
+// WaitAndSend() leaves in that frame no matter how much bulk data waits.
+//
+// Packet payload (after the library's slot/hop byte) = segments:
+//   header0: stream(4) | FIRST(1) | LAST(1) | message counter(2)
+//   header1: length(5) | fragment counter(3)
+//   data[length]; a FIRST segment starts with the message length, low byte
+// A header with length 0 ends the packet. Streams are send and forget
+// like the rest of the protocol: a lost fragment drops its message (seen
+// through the fragment counter) and the next FIRST starts over. A loss of
+// a multiple of 8 segments keeps the fragment counter in step; the
+// message counter and the length from FIRST, checked on LAST, catch it.
+
+#define MUX_STREAMS 16
+#define MUX_SEGMENT_HEADER 2
+#define MUX_FIRST_HEADER 1     //Message length (low byte) at the start of a FIRST segment
+#define MUX_PRIORITY_HIGHEST 0
+#define MUX_PRIORITY_LOWEST 3
+
+struct StreamStats
+{
+  uint32_t sentMessages;
+  uint32_t receivedMessages;
+  uint32_t droppedMessages;   //Send queue full or message too big
+  uint32_t lostMessages;      //Broken on the air
+};
+
+class StreamMux
+{
+public:
+  typedef void (*MessageHandler)(uint8_t streamId, const uint8_t* data, uint16_t length);
+
+private:
+  struct Stream
+  {
+    bool isOpen = false;
+    bool latestOnly = false;
+    uint8_t priority = MUX_PRIORITY_LOWEST;
+    uint16_t maxMessage = 0;
+    //Send queue: ring of [length lo][length hi][data]
+    uint8_t* queue = nullptr;
+    uint16_t queueSize = 0;
+    uint16_t queueHead = 0;
+    uint16_t queueTail = 0;
+    uint16_t queueUsed = 0;
+    uint16_t sendOffset = 0;    //Bytes of the message at queueTail already sent
+    uint8_t sendCounter = 0;
+    uint8_t sendMessage = 0;    //Message counter of the message at queueTail
+    //Reassembly
+    uint8_t* message = nullptr;
+    uint16_t messageLength = 0;
+    uint8_t expectedLength = 0;   //Low byte, from the FIRST segment
+    uint8_t receiveMessage = 0;   //Message counter of the FIRST segment
+    bool isAssembling = false;
+    bool hasReceived = false;
+    uint8_t receiveCounter = 0;   //Next expected fragment counter
+    StreamStats stats = {};
+  };
+
+  Stream streams[MUX_STREAMS];
+  uint8_t roundRobinStart = 0;
+  MessageHandler handler = nullptr;
+
+  uint8_t QueueByte(Stream& s, uint16_t offset);
+  uint16_t HeadMessageLength(Stream& s);
+  void QueuePush(Stream& s, const uint8_t* data, uint16_t length);
+  int8_t PickStream();
+  void ReceiveSegment(uint8_t streamId, bool isFirst, bool isLast, uint8_t counter, uint8_t message,
+                      const uint8_t* data, uint8_t length);
+
+public:
+  // priority MUX_PRIORITY_HIGHEST (control) .. MUX_PRIORITY_LOWEST (bulk).
+  // latestOnly: a new message replaces the queued ones (setpoints).
+  bool OpenStream(uint8_t streamId, uint8_t priority, uint16_t maxMessage, uint16_t queueSize, bool latestOnly = false);
+  void SetHandler(MessageHandler handler) { this->handler = handler; }
+
+  bool Write(uint8_t streamId, const void* data, uint16_t length);
+  bool IsIdle(uint8_t streamId);   //Nothing left to send
+  StreamStats GetStats(uint8_t streamId) { return streamId < MUX_STREAMS ? streams[streamId].stats : StreamStats(); }
+
+  // One packet payload from the queues; returns bytes used, 0 = nothing to send
+  uint8_t BuildPacket(uint8_t* out, uint8_t size);
+  void ParsePacket(const uint8_t* in, uint8_t size);
+
+  // Before WaitAndSend() / after Receive(): all send slots, all receive slots
+  template <typename R> void FillFrame(R& radio);
+  template <typename R> void ReadFrame(R& radio);
+};
+
+
+template <typename R>
+void StreamMux::FillFrame(R& radio)
+{
+  for (uint8_t i = 0; i < radio.GetNumberOfSendPackets(); i++)
+  {
+    uint8_t payload[32];
+    uint8_t used = BuildPacket(payload, radio.GetPacketPayloadSize());
+    if (used == 0)
+    {
+      return;
+    }
+    radio.AddNextPacketBytes(i, payload, used);
+  }
+}
+
+template <typename R>
+void StreamMux::ReadFrame(R& radio)
+{
+  for (uint8_t i = 0; i < radio.GetNumberOfReceivePackets(); i++)
+  {
+    if (!radio.IsNewPacket(i))
+    {
+      continue;
+    }
+    uint8_t payload[32];
+    uint8_t size = radio.GetPacketPayloadSize();
+    radio.GetNextPacketBytes(i, payload, size);
+    ParsePacket(payload, size);
+  }
+}
+
+#endif
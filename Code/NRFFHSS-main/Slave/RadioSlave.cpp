@@ -2,26 +2,12 @@
 
 RadioSlave* RadioSlave::handlerInstance = nullptr;
 
-void RadioSlave::Init(_SPI* spiPort, uint8_t pinCE, uint8_t pinCS, uint8_t pinIRQ, int8_t powerLevel, uint8_t packetSize, uint8_t numberOfSendPackets, uint8_t numberOfReceivePackets, uint8_t frameRate)
+void RadioSlave::Init(_SPI* spiPort, uint8_t pinCE, uint8_t pinCS, uint8_t pinIRQ, int8_t powerLevel, uint8_t packetSize, uint8_t numberOfSendPackets, uint8_t numberOfReceivePackets, uint16_t frameRate)
 {
   handlerInstance = this;
-  this->numberOfSendPackets = (numberOfSendPackets < 0) ? 0 : ((numberOfSendPackets > 3) ? 3 : numberOfSendPackets);
-  this->numberOfReceivePackets = (numberOfReceivePackets < 0) ? 0 : ((numberOfReceivePackets > 3) ? 3 : numberOfReceivePackets);
-  this->packetSize = (packetSize < 1) ? 1 : ((packetSize > 32) ? 32 : packetSize);
   powerLevel = (powerLevel < 0) ? 0 : ((powerLevel > 3) ? 3: powerLevel);
 
-  for (int i = 0; i < numberOfSendPackets; ++i) 
-  {
-    sendPackets[i] = new uint8_t[packetSize]();
-  }
-
-  for (int i = 0; i < numberOfReceivePackets; ++i) 
-  {
-    recievePackets[i] = new uint8_t[packetSize]();
-  }
-
-  ClearSendPackets();
-  ClearReceivePackets();
+  InitPackets(packetSize, numberOfSendPackets, numberOfReceivePackets);
 
   //Radio
   spiPort->begin();
@@ -41,16 +27,36 @@ void RadioSlave::Init(_SPI* spiPort, uint8_t pinCE, uint8_t pinCS, uint8_t pinIR
   radio.powerUp();
   radio.startListening();
 
-  //Interrupt for Radio
+  //Frame Timing
+  this->frameRate = (frameRate < 10) ? 10 : ((frameRate > 1000) ? 1000 : frameRate);  //Clamp between 10 and 1000
+  ticksPerFrame = FRAME_TIMER_HZ / this->frameRate;
+  halfTicksPerFrame = ticksPerFrame / 2;
+  syncDelay = ticksPerFrame / 8;
+  frameTimer.Begin();
+  frameTimeEnd = frameTimer.Now() + ticksPerFrame;
+
+  //Interrupt for Radio (needs the frame timer running)
   attachInterrupt(digitalPinToInterrupt(pinIRQ), StaticIRQHandler, FALLING);
+}
 
-  //Frame Timing
-  this->frameRate = (frameRate < 10) ? 10 : ((frameRate > 120) ? 120 : frameRate);  //Clamp between 10 and 120
-  microsPerFrame = 1000000 / frameRate;
-  halfMicrosPerFrame = microsPerFrame / 2;
-  minOverflowProtection = microsPerFrame * 3;
-  maxOverflowProtection = 0xffffffff - (microsPerFrame * 3);
-  syncDelay = microsPerFrame / 8;
+void RadioSlave::InitPackets(uint8_t packetSize, uint8_t numberOfSendPackets, uint8_t numberOfReceivePackets)
+{
+  this->numberOfSendPackets = (numberOfSendPackets > 3) ? 3 : numberOfSendPackets;
+  this->numberOfReceivePackets = (numberOfReceivePackets > 3) ? 3 : numberOfReceivePackets;
+  this->packetSize = (packetSize < 1) ? 1 : ((packetSize > 32) ? 32 : packetSize);
+
+  for (int i = 0; i < this->numberOfSendPackets; ++i) 
+  {
+    sendPackets[i] = new uint8_t[this->packetSize]();
+  }
+
+  for (int i = 0; i < this->numberOfReceivePackets; ++i) 
+  {
+    recievePackets[i] = new uint8_t[this->packetSize]();
+  }
+
+  ClearSendPackets();
+  ClearReceivePackets();
 }
 
 void RadioSlave::StaticIRQHandler()
@@ -61,19 +67,20 @@ void RadioSlave::StaticIRQHandler()
   }
 }
   
-volatile uint32_t lastInterruptTimeStamp = 0;
-
 void RadioSlave::IRQHandler()
 { 
-    interruptTimeStamp = micros() + syncDelay;
+    uint64_t timeStamp = frameTimer.Now() + syncDelay;
 
-    if(interruptTimeStamp - lastInterruptTimeStamp < halfMicrosPerFrame) //In case our interrupt acted wierd on multiple packets
+    if(timeStamp - lastInterruptTimeStamp < halfTicksPerFrame) //In case our interrupt acted wierd on multiple packets
     {
       return;
     }
     
+    portENTER_CRITICAL_ISR(&interruptLock);
+    interruptTimeStamp = timeStamp;
     isSyncFrame = true;
-    lastInterruptTimeStamp = interruptTimeStamp;
+    portEXIT_CRITICAL_ISR(&interruptLock);
+    lastInterruptTimeStamp = timeStamp;
 }
 
 
@@ -86,6 +93,29 @@ void RadioSlave::ClearSendPackets()
   }
 }
 
+void RadioSlave::AddNextPacketBytes(uint8_t packetId, const uint8_t* data, uint8_t length)
+{
+  if (packetId >= numberOfSendPackets || byteAddCounter[packetId] + length > packetSize)
+  {
+    return;
+  }
+
+  memcpy(&sendPackets[packetId][byteAddCounter[packetId]], data, length);
+  byteAddCounter[packetId] += length;
+}
+
+void RadioSlave::GetNextPacketBytes(uint8_t packetId, uint8_t* data, uint8_t length)
+{
+  if (packetId >= numberOfReceivePackets || byteReceiveCounter[packetId] + length > packetSize)
+  {
+    memset(data, 0, length);
+    return;
+  }
+
+  memcpy(data, &recievePackets[packetId][byteReceiveCounter[packetId]], length);
+  byteReceiveCounter[packetId] += length;
+}
+
 void RadioSlave::ClearReceivePackets()
 {
   for(int i = 0; i < numberOfReceivePackets; i++)
@@ -96,76 +126,43 @@ void RadioSlave::ClearReceivePackets()
   }
 }
 
-void RadioSlave::SetNextFrameEnd(uint32_t newTime) 
-{
-  isOverFlowFrame = (newTime < frameTimeEnd);
-  frameTimeEnd = newTime;
-}
-
 void RadioSlave::AdvanceFrame()
 {
-    uint32_t localInterruptTimeStamp = interruptTimeStamp;
+    portENTER_CRITICAL(&interruptLock);
+    uint64_t localInterruptTimeStamp = interruptTimeStamp;
     bool localIsSyncFrame = isSyncFrame;
     isSyncFrame = false;
+    portEXIT_CRITICAL(&interruptLock);
 
     if(localIsSyncFrame)
     {
-      if(localInterruptTimeStamp > maxOverflowProtection) 
-      {
-        SetNextFrameEnd(frameTimeEnd + microsPerFrame);
-        return; 
-      }
-      if(localInterruptTimeStamp < minOverflowProtection) 
-      {
-        SetNextFrameEnd(frameTimeEnd + microsPerFrame);
-        return; 
-      }
+      //64 bit ticks never wrap, so no overflow frames to skip
+      uint64_t futureLocalInterruptTimeStamp = localInterruptTimeStamp + ticksPerFrame;
+      int64_t diffA = (int64_t)(localInterruptTimeStamp - frameTimeEnd);
+      int64_t diffB = (int64_t)(futureLocalInterruptTimeStamp - frameTimeEnd);
+      int64_t drift;
 
-      uint32_t futureLocalInterruptTimeStamp = localInterruptTimeStamp + microsPerFrame;
-      int32_t diffA = localInterruptTimeStamp - frameTimeEnd;
-      int32_t diffB = futureLocalInterruptTimeStamp - frameTimeEnd;
-      int32_t drift;
+      drift = (llabs(diffA) < llabs(diffB)) ? diffA : diffB;
 
-      drift = (abs(diffA) < abs(diffB)) ? diffA : diffB;
-
-      SetNextFrameEnd(frameTimeEnd + microsPerFrame + drift);
+      frameTimeEnd += ticksPerFrame + drift;
+      //Frame length follows the master's clock one tick (0.1 us) at a time
       if(drift < 0)
       {
         totalAdjustedDrift--;
-        microsPerFrame--;
+        ticksPerFrame--;
       }
       else
       {
         totalAdjustedDrift++;
-        microsPerFrame++;
+        ticksPerFrame++;
       }
     }
     else
     {
-      SetNextFrameEnd(frameTimeEnd + microsPerFrame);
+      frameTimeEnd += ticksPerFrame;
     }
 }
 
-bool RadioSlave::IsFrameReady()
-{
-  uint32_t currentTimeStamp = micros();
-  uint32_t localFrameTimeEnd = frameTimeEnd;
-   
-  if(isOverFlowFrame)
-  {
-    currentTimeStamp -= 0x80000000;
-    localFrameTimeEnd -= 0x80000000;
-  }
-
-  if (currentTimeStamp >= localFrameTimeEnd)
-	{
-    AdvanceFrame();
-    return true;
-  }
-  
-  return false;
-}
-
 void RadioSlave::UpdateScanning(bool isSuccess)
   {
     if(isSuccess) 
@@ -270,7 +267,8 @@ void RadioSlave::UpdateSecondCounter()
 
 void RadioSlave::WaitAndSend()
 {
-  while(!IsFrameReady()) {}
+  frameTimer.WaitUntil(frameTimeEnd);  //Sleeps until the timer interrupt
+  AdvanceFrame();
 
 
   bool hasStoppedListening = UpdateHop();
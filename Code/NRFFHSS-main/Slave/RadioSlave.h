@@ -2,6 +2,7 @@
 #define RadioSlave_h
 
 #include <RF24.h>
+#include "FrameTimer.h"
 #define MAXPACKETS 3
 #define PACKET1 0
 #define PACKET2 1
@@ -30,15 +31,15 @@ private:
   uint8_t failedCounter = 0;
   const uint8_t failedBeforeScanning = 50;
 
-//Frame Timing Stuff
-  uint8_t frameRate = 0;
-  uint32_t microsPerFrame = 0;
-  volatile uint32_t halfMicrosPerFrame = 0;
-  uint32_t frameTimeEnd = 0;
-  bool isOverFlowFrame = false;
-  uint8_t secondCounter = 0;
-  uint8_t recievedPacketCount = 0;
-  uint8_t sentPacketCount = 0;
+//Frame Timing Stuff (FrameTimer ticks, 0.1 us)
+  FrameTimer frameTimer;
+  uint16_t frameRate = 0;
+  uint32_t ticksPerFrame = 0;
+  volatile uint32_t halfTicksPerFrame = 0;
+  uint64_t frameTimeEnd = 0;
+  uint16_t secondCounter = 0;
+  uint16_t recievedPacketCount = 0;
+  uint16_t sentPacketCount = 0;
   uint16_t receivedPerSecond = 0;
   uint16_t sentPerSecond = 0;
   bool isSecondTick = false;
@@ -54,36 +55,41 @@ private:
   uint8_t packetSize = 0;
 
 //Radio Interrupt Stuff
-  int16_t totalAdjustedDrift = 0;  //Take this out
-  uint32_t syncDelay = 0;  //2.5 millisecond delay we should make this half frame time?
-  uint32_t minOverflowProtection;
-  uint32_t maxOverflowProtection;
+  int32_t totalAdjustedDrift = 0;  //Ticks
+  uint32_t syncDelay = 0;  //1/8 frame after the master's packet
   uint8_t partialLockCounter = 0;
   volatile uint8_t radioState = STATE_SCANNING;
   volatile bool isSyncFrame; 
-  volatile uint32_t interruptTimeStamp = 0;
+  uint64_t interruptTimeStamp = 0;      //Guarded by interruptLock (64 bit is not atomic)
+  uint64_t lastInterruptTimeStamp = 0;
+  portMUX_TYPE interruptLock = portMUX_INITIALIZER_UNLOCKED;
 
-  void ClearSendPackets();
-  void ClearReceivePackets();
   void UpdateScanning(bool isSuccess);
   void UpdateSecondCounter();
-  void SetNextFrameEnd(uint32_t newTime);
   void AdvanceFrame();
-  bool IsFrameReady();
   void AdjustChannelIndex(int8_t amount);
   bool UpdateHop();
   static void StaticIRQHandler();
   void IRQHandler();
 
 public:
-  void Init(_SPI* spiPort, uint8_t pinCE, uint8_t pinCS, uint8_t pinIRQ, int8_t powerLevel, uint8_t packetSize, uint8_t numberOfSendPackets, uint8_t numberOfReceivePackets, uint8_t frameRate);
+  void Init(_SPI* spiPort, uint8_t pinCE, uint8_t pinCS, uint8_t pinIRQ, int8_t powerLevel, uint8_t packetSize, uint8_t numberOfSendPackets, uint8_t numberOfReceivePackets, uint16_t frameRate);
+  void InitPackets(uint8_t packetSize, uint8_t numberOfSendPackets, uint8_t numberOfReceivePackets);  //Buffers only, no radio (called by Init; host benchmark)
+  void ClearSendPackets();
+  void ClearReceivePackets();
   void WaitAndSend();
   void Receive();
   bool IsNewPacket(uint8_t packetId) {return receivePacketsAvailable[packetId]; }
   uint16_t GetRecievedPacketsPerSecond() {return receivedPerSecond; }
-  int16_t GetDriftAdjustmentMicros() { return totalAdjustedDrift; }
+  int16_t GetDriftAdjustmentMicros() { return totalAdjustedDrift / (int32_t)FRAME_TICKS_PER_US; }
+  int32_t GetDriftAdjustmentTicks() { return totalAdjustedDrift; }
   int8_t GetCurrentChannel() { return channelList[currentChannelIndex]; }
   bool IsSecondTick() {return isSecondTick; }
+  uint8_t GetPacketPayloadSize() { return packetSize - 1; }  //First byte is the packet id
+  uint8_t GetNumberOfSendPackets() { return numberOfSendPackets; }
+  uint8_t GetNumberOfReceivePackets() { return numberOfReceivePackets; }
+  void AddNextPacketBytes(uint8_t packetId, const uint8_t* data, uint8_t length);
+  void GetNextPacketBytes(uint8_t packetId, uint8_t* data, uint8_t length);
   template <typename T> void AddNextPacketValue(uint8_t packetId, T data);
   template <typename T> T GetNextPacketValue(uint8_t packetId);
 };
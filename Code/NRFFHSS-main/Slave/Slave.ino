@@ -11,10 +11,17 @@
 #define NUMBER_OF_RECEIVE_PACKETS 1
 #define FRAME_RATE 50
 
+#ifndef BENCH_PACKETS
+#define BENCH_PACKETS 0  //1 = такты AddNextPacketValue/GetNextPacketValue при старте (те же, что slave_pack/slave_unpack в host/bench)
+#endif
+
 RadioSlave radio;
 
 void setup() {
   Serial.begin(115200);
+#if BENCH_PACKETS
+  BenchPackets();
+#endif
   radio.Init(&SPI_PORT, CE_PIN, CS_PIN, IRQ_PIN, POWER_LEVEL, PACKET_SIZE, NUMBER_OF_SENDPACKETS, NUMBER_OF_RECEIVE_PACKETS, FRAME_RATE);
 }
 
@@ -43,4 +50,63 @@ void ProcessReceived() {
     Serial.print("Received: ");
     Serial.println(receivedValue);
   }
-}
\ No newline at end of file
+}
+
+#if BENCH_PACKETS
+//Cycles per packed / unpacked 15 byte payload: 4 x int16, float, 3 x uint8.
+//101 samples of 64 packets each, min and median per packet.
+#define BENCH_BATCH 64
+#define BENCH_SAMPLES 101
+
+static RadioSlave benchRadio;  //Buffers only, no radio
+static uint32_t benchSamples[BENCH_SAMPLES];
+volatile uint32_t benchSink = 0;
+
+void BenchPack(uint32_t i) {
+  benchRadio.ClearSendPackets();
+  benchRadio.AddNextPacketValue<int16_t>(PACKET1, (int16_t)i);
+  benchRadio.AddNextPacketValue<int16_t>(PACKET1, (int16_t)(i >> 1));
+  benchRadio.AddNextPacketValue<int16_t>(PACKET1, (int16_t)(i >> 2));
+  benchRadio.AddNextPacketValue<int16_t>(PACKET1, (int16_t)(i >> 3));
+  benchRadio.AddNextPacketValue<float>(PACKET1, (float)i);
+  benchRadio.AddNextPacketValue<uint8_t>(PACKET1, (uint8_t)i);
+  benchRadio.AddNextPacketValue<uint8_t>(PACKET1, (uint8_t)(i >> 8));
+  benchRadio.AddNextPacketValue<uint8_t>(PACKET1, (uint8_t)(i >> 16));
+}
+
+void BenchUnpack(uint32_t) {
+  benchRadio.ClearReceivePackets();
+  uint32_t sum = 0;
+  sum += (uint16_t)benchRadio.GetNextPacketValue<int16_t>(PACKET1);
+  sum += (uint16_t)benchRadio.GetNextPacketValue<int16_t>(PACKET1);
+  sum += (uint16_t)benchRadio.GetNextPacketValue<int16_t>(PACKET1);
+  sum += (uint16_t)benchRadio.GetNextPacketValue<int16_t>(PACKET1);
+  sum += benchRadio.GetNextPacketValue<float>(PACKET1) > 0.0f;
+  sum += benchRadio.GetNextPacketValue<uint8_t>(PACKET1);
+  sum += benchRadio.GetNextPacketValue<uint8_t>(PACKET1);
+  sum += benchRadio.GetNextPacketValue<uint8_t>(PACKET1);
+  benchSink += sum;
+}
+
+void BenchRun(const char* name, void (*op)(uint32_t)) {
+  uint32_t call = 0;
+  for (uint32_t n = 0; n < BENCH_BATCH; n++) op(call++);  //Warm up
+
+  for (uint32_t s = 0; s < BENCH_SAMPLES; s++) {
+    uint32_t t0 = ESP.getCycleCount();
+    for (uint32_t n = 0; n < BENCH_BATCH; n++) op(call++);
+    benchSamples[s] = ESP.getCycleCount() - t0;
+  }
+  std::sort(benchSamples, benchSamples + BENCH_SAMPLES);
+
+  Serial.printf("BENCH: %-16s median %8.1f  min %8.1f  cycles/call\r\n", name,
+                benchSamples[BENCH_SAMPLES / 2] / (float)BENCH_BATCH, benchSamples[0] / (float)BENCH_BATCH);
+}
+
+void BenchPackets() {
+  benchRadio.InitPackets(PACKET_SIZE, 1, 1);
+  Serial.printf("BENCH: CPU %lu MHz\r\n", (unsigned long)getCpuFrequencyMhz());
+  BenchRun("slave_pack", BenchPack);
+  BenchRun("slave_unpack", BenchUnpack);
+}
+#endif
@@ -20,12 +20,31 @@ https://habr.com/ru/post/476716/
 
    Inspired by cpixip.
    See http://arduino.cc/forum/index.php/topic,54795.0.html
+
+   Fast survey (rf_survey.h): RPD per channel with exponential averaging,
+   configurable dwell and channel subset. A full 0..125 pass at 200 us
+   dwell takes ~28 ms instead of 6.5 s for the old 100 x 512 us.
+
+   Output:
+   - text: one hex digit per channel every SCAN_PRINT_MS, then the
+     quietest FHSS band (SCAN_BAND_CHANNELS spaced SCAN_BAND_SPACING);
+   - binary: every pass as GsSpectrum frames (gs_format.h, same as the
+     TX ground-station stream) for `host/gs_tool waterfall`.
+
+   Serial commands (one per line):
+     d<us>              dwell per channel, >= 170
+     r<lo> <hi> [step]  channel subset
+     e<shift>           averaging, new sample weight 1/2^shift
+     b / t              binary / text output
+     ?                  settings
 */
 
 #include <SPI.h>
 #include "nRF24L01.h"
 #include "RF24.h"
 #include "printf.h"
+#include "gs_format.h"
+#include "rf_survey.h"
 
 //
 // Hardware configuration
@@ -36,15 +55,159 @@ https://habr.com/ru/post/476716/
 #define CSN_PIN   5
 #define MOSI_PIN   15
 #define MISO_PIN   12
-#define SCK_PIN   18 
+#define SCK_PIN   18
 RF24 radio(CE_PIN, CSN_PIN); //Arduino UNO
 
 //
-// Channel info
+// Survey configuration
 //
 
-const uint8_t num_channels = 128;
-uint8_t values[num_channels];
+#ifndef SCAN_PRINT_MS
+#define SCAN_PRINT_MS 1000        // текстовая строка и выбор полосы
+#endif
+#ifndef SCAN_BAND_CHANNELS
+#define SCAN_BAND_CHANNELS 7      // = FHSS_CHANNELS в fhss_TX / fhss_RX
+#endif
+#ifndef SCAN_BAND_SPACING
+#define SCAN_BAND_SPACING 2
+#endif
+#ifndef SCAN_BINARY
+#define SCAN_BINARY 0
+#endif
+
+static bool binaryOut = SCAN_BINARY;
+static uint8_t frameSeq = 0;
+static uint32_t lastPrint = 0;
+static uint32_t lastSweeps = 0;
+static char cmd[24];
+static uint8_t cmdLen = 0;
+
+//
+// Output
+//
+
+static void sendFrame(uint8_t type, const void* payload, uint8_t len)
+{
+  uint8_t frame[GS_MAX_ENCODED + 1];
+  size_t n = gsBuildFrame(type, 2, frameSeq++, millis(), payload, len, frame);
+  Serial.write(frame, n);
+}
+
+static void sendSpectrum()
+{
+  for (uint8_t first = 0; first < SURVEY_CHANNELS; first += GS_SPECTRUM_CHUNK) {
+    GsSpectrum s;
+    s.first = first;
+    s.count = min(SURVEY_CHANNELS - first, GS_SPECTRUM_CHUNK);
+    s.flags = first + s.count >= SURVEY_CHANNELS ? GS_SPECTRUM_LAST : 0;
+    for (uint8_t i = 0; i < s.count; i++) {
+      uint8_t ch = first + i;
+      s.level[i] = surveyIncluded(ch) ? min<uint8_t>(surveyLevel(ch), GS_SPECTRUM_NONE - 1) : GS_SPECTRUM_NONE;
+    }
+    sendFrame(GS_REC_SPECTRUM, &s, 3 + s.count);
+  }
+}
+
+// Text line, or a GS_REC_TEXT frame in binary mode
+static void report(const char* text)
+{
+  if (binaryOut) sendFrame(GS_REC_TEXT, text, strlen(text));
+  else printf("%s\n\r", text);
+}
+
+static void printHeader()
+{
+  for (uint8_t ch = 0; ch < SURVEY_CHANNELS; ch++) printf("%x", ch >> 4);
+  printf("\n\r");
+  for (uint8_t ch = 0; ch < SURVEY_CHANNELS; ch++) printf("%x", ch & 0xf);
+  printf("\n\r");
+}
+
+static void printLevels()
+{
+  for (uint8_t ch = 0; ch < SURVEY_CHANNELS; ch++) {
+    if (surveyIncluded(ch)) printf("%x", surveyLevel(ch) >> 4);
+    else printf(" ");
+  }
+  printf("\n\r");
+}
+
+static void reportBand()
+{
+  const uint8_t span = SCAN_BAND_SPACING * (SCAN_BAND_CHANNELS - 1);
+  uint8_t level;
+  uint8_t best = surveyBestBand(SCAN_BAND_CHANNELS, SCAN_BAND_SPACING, 0, SURVEY_CHANNELS - 1, 0xFF, &level);
+  SurveyStats st = surveyStats();
+  char line[80];
+  snprintf(line, sizeof(line), "SCAN: best %u..%u busy %u%%, %lu sweeps, %lu us/sweep",
+           best, best + span, level * 100 / 255, (unsigned long)(st.sweeps - lastSweeps),
+           (unsigned long)st.sweepUs);
+  report(line);
+  lastSweeps = st.sweeps;
+}
+
+static void printSettings()
+{
+  char line[80];
+  uint8_t lo = 0, hi = 0, n = 0;
+  for (uint8_t ch = 0; ch < SURVEY_CHANNELS; ch++) {
+    if (!surveyIncluded(ch)) continue;
+    if (n++ == 0) lo = ch;
+    hi = ch;
+  }
+  snprintf(line, sizeof(line), "SCAN: dwell %u us, channels %u..%u (%u), %s",
+           surveyDwell(), lo, hi, n, binaryOut ? "binary" : "text");
+  report(line);
+}
+
+//
+// Serial commands
+//
+
+static void runCommand(char* c)
+{
+  switch (c[0]) {
+    case 'd':
+      surveySetDwell(atoi(c + 1));
+      break;
+    case 'r': {
+      int lo = 0, hi = SURVEY_CHANNELS - 1, step = 1;
+      sscanf(c + 1, "%d %d %d", &lo, &hi, &step);
+      surveySetRange(constrain(lo, 0, SURVEY_CHANNELS - 1), constrain(hi, 0, SURVEY_CHANNELS - 1), max(step, 1));
+      break;
+    }
+    case 'e':
+      surveySetEmaShift(atoi(c + 1));
+      break;
+    case 'b':
+      binaryOut = true;
+      Serial.write((uint8_t)0);   // отделить кадры от текста
+      break;
+    case 't':
+      binaryOut = false;
+      printHeader();
+      break;
+    case '?':
+      break;
+    default:
+      return;
+  }
+  printSettings();
+}
+
+static void readCommands()
+{
+  while (Serial.available()) {
+    char c = Serial.read();
+    if (c == '\n' || c == '\r') {
+      cmd[cmdLen] = 0;
+      if (cmdLen) runCommand(cmd);
+      cmdLen = 0;
+    } else if (cmdLen < sizeof(cmd) - 1) {
+      cmd[cmdLen++] = c;
+    }
+  }
+}
 
 //
 // Setup
@@ -56,7 +219,7 @@ void setup(void)
   // Print preamble
   //
   SPI.begin(SCK_PIN, MISO_PIN, MOSI_PIN, CSN_PIN);
-  Serial.begin(9600);
+  Serial.begin(115200);
   Serial.println("Scanner Air On");
   printf_begin();
 
@@ -69,64 +232,31 @@ void setup(void)
 
   // Get into standby mode
   radio.startListening();
-  radio.printDetails();  
-  delay(5000);              
-
-  // Print out header, high then low digit
-  int i = 0;
-  while ( i < num_channels )
-  {
-    printf("%x", i >> 4);
-    ++i;
-  }
-  printf("\n\r");
-  i = 0;
-  while ( i < num_channels )
-  {
-    printf("%x", i & 0xf);
-    ++i;
-  }
-  printf("\n\r");
+  radio.printDetails();
+  delay(5000);
+
+  surveyInit(radio, CE_PIN);
+  if (binaryOut) Serial.write((uint8_t)0);   // отделить кадры от текста
+  printSettings();
+  if (!binaryOut) printHeader();
 }
 
 //
 // Loop
 //
 
-const int num_reps = 100;
-
 void loop(void)
 {
-  // Clear measurement values
-  memset(values, 0, sizeof(values));
-
-  // Scan all channels num_reps times
-  int rep_counter = num_reps;
-  while (rep_counter--)
-  {
-    int i = num_channels;
-    while (i--)
-    {
-      // Select this channel
-      radio.setChannel(i);
-
-      // Listen for a little
-      radio.startListening();
-      delayMicroseconds(512);
-      radio.stopListening();
-
-      // Did we get a carrier?
-      if ( radio.testCarrier() )
-        ++values[i];
-    }
-  }
+  readCommands();
 
-  // Print out channel measurements, clamped to a single hex digit
-  int i = 0;
-  while ( i < num_channels )
-  {
-    printf("%x", min(0xf, values[i] & 0xf));
-    ++i;
+  // One pass over the subset
+  surveySweep();
+  if (binaryOut) sendSpectrum();
+
+  // Text row and band pick from the averaged levels
+  if (millis() - lastPrint >= SCAN_PRINT_MS) {
+    lastPrint = millis();
+    if (!binaryOut) printLevels();
+    reportBand();
   }
-  printf("\n\r");
-}
\ No newline at end of file
+}